@@ -1,14 +1,23 @@
 #include "cpuid/get_cpuid.h"
 #include "cpuid/cpuid_factory.h"
 #include "cpuid/cpuid_native_config.h"
-#include "cpuid/tree/cpuid_write_xml.h"
+#include "cpuid/tree/cpuid_xml_sink.h"
+#include "os/qnx/native/file/file.h"
 
-#include <iostream>
+#include <unistd.h>
 
 auto main() -> int
 {
     auto factory = rjcp::cpuid::CreateCpuIdFactory(rjcp::cpuid::CpuIdNativeConfig{});
-    auto cpu = rjcp::cpuid::GetCpuId(*factory);
-    rjcp::cpuid::tree::WriteCpuIdXml(*cpu, std::cout);
-    return 0;
+
+    // Standard output is owned by the process, it mustn't be closed.
+    rjcp::os::qnx::native::file::FileHandle out{STDOUT_FILENO};
+    int error = 0;
+    {
+        rjcp::cpuid::tree::CpuIdXmlSink sink{out};
+        rjcp::cpuid::GetCpuId(*factory, sink);
+        error = sink.Error();
+    }
+    out.Detach();
+    return error == 0 ? 0 : 1;
 }
@@ -0,0 +1,190 @@
+#include "cpuid/cpuid_boot_cache.h"
+#include "cpuid/get_cpuid.h"
+#include "cpuid/tree/cpuid_write_snapshot.h"
+#include "os/qnx/native/file/file.h"
+
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace rjcp::cpuid {
+
+namespace {
+
+constexpr std::array<char, 8> BootCacheMagic = { 'C', 'P', 'U', 'I', 'D', 'B', 'C', 'H' };
+// Version 2 added the hash of the CPU list (cpuset) to the header. Increment
+// the version on any change to the layout, so that older files are rejected.
+constexpr std::uint32_t BootCacheVersion = 2;
+constexpr std::size_t BootIdLength = 48;
+
+/**
+ * @brief The header of the cache file, followed by the snapshot.
+ *
+ * The header is a multiple of 8 bytes, so the snapshot is aligned when the
+ * file is read into memory.
+ */
+struct BootCacheHeader {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t cpus;
+    std::uint32_t microcode;
+    std::uint32_t bootIdLength;
+    std::array<char, BootIdLength> bootId;
+    std::uint64_t cpuset;
+    std::uint64_t size;
+};
+
+static_assert(sizeof(BootCacheHeader) == 88);
+static_assert(sizeof(BootCacheHeader) % tree::snapshot::Alignment == 0);
+
+/**
+ * @brief Read the start of a small text file, as files in /proc don't have a
+ * size.
+ */
+auto ReadText(const std::string& fileName, std::size_t length) -> std::string
+{
+    auto fd = os::qnx::native::file::open(fileName);
+    if (!fd) return {};
+
+    std::vector<std::uint8_t> buffer(length);
+    auto total = os::qnx::native::file::read_all(*fd, buffer.data(), length);
+    if (!total) return {};
+    return std::string{buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(*total)};
+}
+
+auto ReadFile(const std::string& fileName) -> std::vector<std::uint8_t>
+{
+    auto fd = os::qnx::native::file::open(fileName);
+    if (!fd) return {};
+
+    std::vector<std::uint8_t> buffer{};
+    std::size_t total = 0;
+    while (true) {
+        buffer.resize(buffer.size() + 65536);
+        auto bytes = os::qnx::native::file::read_all(*fd, &buffer[total], buffer.size() - total);
+        if (!bytes) return {};
+        total += *bytes;
+
+        // A short read is only at the end of the file.
+        if (total < buffer.size()) break;
+    }
+    buffer.resize(total);
+    return buffer;
+}
+
+auto GetMicrocode() -> std::uint32_t
+{
+    std::string version = ReadText("/sys/devices/system/cpu/cpu0/microcode/version", 32);
+    if (version.empty()) {
+        // The first CPU is at the start of the file.
+        std::string cpuinfo = ReadText("/proc/cpuinfo", 8192);
+        std::size_t pos = cpuinfo.find("\nmicrocode");
+        if (pos == std::string::npos) return 0;
+        pos = cpuinfo.find(':', pos);
+        if (pos == std::string::npos) return 0;
+        version = cpuinfo.substr(pos + 1, 32);
+    }
+    return static_cast<std::uint32_t>(std::strtoul(version.c_str(), nullptr, 16));
+}
+
+auto GetCpuSetHash(const std::vector<unsigned int>& cpus) noexcept -> std::uint64_t
+{
+    // FNV-1a of the CPU numbers.
+    std::uint64_t hash = 0xCBF29CE484222325;
+    for (unsigned int cpu : cpus) {
+        hash = (hash ^ cpu) * 0x00000100000001B3;
+    }
+    return hash;
+}
+
+auto GetCacheFileName(const std::string& directory) -> std::string
+{
+    return directory + "/cpuid.cache";
+}
+
+}
+
+auto GetCpuIdBootKey(const ICpuIdFactory& factory) -> CpuIdBootKey
+{
+    CpuIdBootKey key{};
+    key.bootId = ReadText("/proc/sys/kernel/random/boot_id", BootIdLength);
+    while (!key.bootId.empty() && (key.bootId.back() == '\n' || key.bootId.back() == ' ')) {
+        key.bootId.pop_back();
+    }
+    key.cpus = factory.threads();
+    key.cpuset = GetCpuSetHash(factory.cpus());
+    key.microcode = GetMicrocode();
+    return key;
+}
+
+auto LoadCpuIdBootCache(const std::string& fileName, const CpuIdBootKey& key) -> std::shared_ptr<const tree::CpuIdSnapshot>
+{
+    if (key.bootId.empty() || key.bootId.size() > BootIdLength) return nullptr;
+
+    std::vector<std::uint8_t> data = ReadFile(fileName);
+    if (data.size() < sizeof(BootCacheHeader)) return nullptr;
+
+    BootCacheHeader header{};
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != BootCacheMagic || header.version != BootCacheVersion) return nullptr;
+    if (header.size != data.size() - sizeof(BootCacheHeader)) return nullptr;
+    if (header.cpus != key.cpus || header.cpuset != key.cpuset || header.microcode != key.microcode) return nullptr;
+    if (header.bootIdLength != key.bootId.size()) return nullptr;
+    if (key.bootId.compare(0, key.bootId.size(), header.bootId.data(), header.bootIdLength) != 0) return nullptr;
+
+    data.erase(data.begin(), data.begin() + sizeof(BootCacheHeader));
+    return tree::CpuIdSnapshot::Open(std::move(data));
+}
+
+auto SaveCpuIdBootCache(const std::string& fileName, const CpuIdBootKey& key, const std::vector<std::uint8_t>& snapshot) -> bool
+{
+    if (key.bootId.empty() || key.bootId.size() > BootIdLength) return false;
+
+    BootCacheHeader header{};
+    header.magic = BootCacheMagic;
+    header.version = BootCacheVersion;
+    header.cpus = key.cpus;
+    header.microcode = key.microcode;
+    header.bootIdLength = static_cast<std::uint32_t>(key.bootId.size());
+    std::memcpy(header.bootId.data(), key.bootId.data(), key.bootId.size());
+    header.cpuset = key.cpuset;
+    header.size = snapshot.size();
+
+    std::string tempName = fileName + ".XXXXXX";
+    int tempfd = mkstemp(&tempName[0]);
+    if (tempfd == -1) return false;
+
+    bool written;
+    {
+        os::qnx::native::file::FileHandle fd{tempfd};
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast) - Binary data
+        written = os::qnx::native::file::write_all(fd, reinterpret_cast<const std::uint8_t*>(&header), sizeof(header)) &&
+            os::qnx::native::file::write_all(fd, snapshot.data(), snapshot.size());
+    }
+    if (!written || std::rename(tempName.c_str(), fileName.c_str()) != 0) {
+        std::remove(tempName.c_str());
+        return false;
+    }
+    return true;
+}
+
+auto GetCpuIdBootCache(ICpuIdFactory& factory, const std::string& directory) -> std::shared_ptr<const tree::CpuIdSnapshot>
+{
+    CpuIdBootKey key{};
+    std::string fileName{};
+    if (!directory.empty()) {
+        key = GetCpuIdBootKey(factory);
+        fileName = GetCacheFileName(directory);
+        auto snapshot = LoadCpuIdBootCache(fileName, key);
+        if (snapshot) return snapshot;
+    }
+
+    auto tree = GetCpuId(factory);
+    std::vector<std::uint8_t> snapshot = tree::GetCpuIdSnapshot(*tree);
+    if (!fileName.empty()) SaveCpuIdBootCache(fileName, key, snapshot);
+    return tree::CpuIdSnapshot::Open(std::move(snapshot));
+}
+
+}
@@ -0,0 +1,97 @@
+#ifndef RJCP_LIB_CPUID_CPUID_BOOT_CACHE_H
+#define RJCP_LIB_CPUID_CPUID_BOOT_CACHE_H
+
+#include "cpuid/icpuid_factory.h"
+#include "cpuid/tree/cpuid_snapshot.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace rjcp::cpuid {
+
+/**
+ * @brief Identifies the boot of the system that a cache file is valid for.
+ *
+ * The CPUID results don't change while the system is running, unless the
+ * microcode is updated.
+ */
+class CpuIdBootKey
+{
+public:
+    /**
+     * @brief The identifier of the boot, empty if it isn't known.
+     */
+    std::string bootId{};
+
+    /**
+     * @brief The number of CPUs enumerated, from ICpuIdFactory::threads().
+     */
+    unsigned int cpus{};
+
+    /**
+     * @brief A hash of the CPUs that can be queried, from
+     * ICpuIdFactory::cpus(), which depends on the cpuset of the process.
+     */
+    std::uint64_t cpuset{};
+
+    /**
+     * @brief The microcode revision of the first CPU, zero if it isn't known.
+     */
+    std::uint32_t microcode{};
+};
+
+/**
+ * @brief Get the key for the current boot of the system.
+ *
+ * On Linux, the boot identifier is from /proc/sys/kernel/random/boot_id and
+ * the microcode revision from sysfs or /proc/cpuinfo.
+ *
+ * @param factory The factory that enumerates the CPUs.
+ * @return CpuIdBootKey The key, with an empty boot identifier if the OS
+ * doesn't provide one.
+ */
+auto GetCpuIdBootKey(const ICpuIdFactory& factory) -> CpuIdBootKey;
+
+/**
+ * @brief Load the snapshot from a cache file, if it was written with the same
+ * key.
+ *
+ * @param fileName The name of the cache file.
+ * @param key The key of the current boot.
+ * @return std::shared_ptr<const tree::CpuIdSnapshot> The snapshot, or nullptr
+ * if the file doesn't exist, is malformed, or has a different key.
+ */
+auto LoadCpuIdBootCache(const std::string& fileName, const CpuIdBootKey& key) -> std::shared_ptr<const tree::CpuIdSnapshot>;
+
+/**
+ * @brief Save the snapshot to a cache file with the key.
+ *
+ * The file is written to a temporary file in the same directory, and then
+ * renamed, so that concurrent readers never see a partial file.
+ *
+ * @param fileName The name of the cache file.
+ * @param key The key of the current boot.
+ * @param snapshot The snapshot, from tree::GetCpuIdSnapshot().
+ * @return true if the file was written.
+ * @return false if the file couldn't be written.
+ */
+auto SaveCpuIdBootCache(const std::string& fileName, const CpuIdBootKey& key, const std::vector<std::uint8_t>& snapshot) -> bool;
+
+/**
+ * @brief Get the snapshot of all CPUs from the cache in the directory, or
+ * enumerate them with the factory and update the cache.
+ *
+ * If the OS doesn't provide a boot identifier, or the directory is empty, the
+ * CPUs are always enumerated and no cache is used.
+ *
+ * @param factory The factory to create the CPUID object for each CPU.
+ * @param directory The directory of the cache file.
+ * @return std::shared_ptr<const tree::CpuIdSnapshot> The snapshot of all CPUs.
+ */
+auto GetCpuIdBootCache(ICpuIdFactory& factory, const std::string& directory) -> std::shared_ptr<const tree::CpuIdSnapshot>;
+
+}
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef RJCP_CPUID_BOOT_CACHE_CONFIG_H
+#define RJCP_CPUID_BOOT_CACHE_CONFIG_H
+
+#include "cpuid/icpuid_config.h"
+#include "cpuid/icpuid_factory.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace rjcp::cpuid {
+
+/**
+ * @brief Configuration of a factory that caches the results of another
+ * factory in a file, which is valid until the next boot.
+ *
+ * When the factory is created, the cache file is loaded if it was written
+ * during the current boot, with the same number of CPUs and microcode
+ * revision. Otherwise all CPUs are enumerated with the other factory and the
+ * cache file is written. The objects of the factory then return the results
+ * from memory, as for CpuIdFileConfig.
+ */
+class CpuIdBootCacheConfig : public ICpuIdConfig
+{
+public:
+    CpuIdBootCacheConfig(std::shared_ptr<ICpuIdFactory> factory, std::string directory)
+        : factory{std::move(factory)}, directory{std::move(directory)}
+    { }
+
+    /**
+     * @brief The factory used to enumerate the CPUs if the cache isn't valid.
+     */
+    std::shared_ptr<ICpuIdFactory> factory;
+
+    /**
+     * @brief The directory of the cache file, which must exist.
+     */
+    std::string directory;
+};
+
+}
+
+#endif
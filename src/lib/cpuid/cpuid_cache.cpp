@@ -0,0 +1,142 @@
+#include "cpuid/cpuid_cache.h"
+
+#include <new>
+
+namespace rjcp::cpuid {
+
+namespace {
+
+// The states of an entry. An entry is only read when it is ready, and then
+// never changes.
+constexpr std::uint32_t EntryEmpty = 0;
+constexpr std::uint32_t EntryWriting = 1;
+constexpr std::uint32_t EntryReady = 2;
+
+auto RoundUpPowerOfTwo(std::size_t value) noexcept -> std::size_t
+{
+    std::size_t result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+}
+
+CpuIdCache::CpuIdCache(unsigned int cpus, std::size_t capacity)
+    : m_cpus{cpus},
+      m_mask{RoundUpPowerOfTwo(capacity) - 1},
+      m_tables{std::make_unique<std::atomic<Entry*>[]>(cpus)}
+{ }
+
+CpuIdCache::~CpuIdCache()
+{
+    for (unsigned int cpu = 0; cpu < m_cpus; cpu++) {
+        delete[] m_tables[cpu].load(std::memory_order_acquire);
+    }
+}
+
+auto CpuIdCache::GetSlot(std::uint32_t eax, std::uint32_t ecx) const noexcept -> std::size_t
+{
+    // Fibonacci hashing, so that the small leaf numbers and the leaf regions
+    // spread over the table.
+    std::uint64_t key = (static_cast<std::uint64_t>(eax) << 32) | ecx;
+    return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15) >> 32) & m_mask;
+}
+
+auto CpuIdCache::GetTable(unsigned int cpu) noexcept -> Entry*
+{
+    Entry* table = m_tables[cpu].load(std::memory_order_acquire);
+    if (table) return table;
+
+    auto* created = new (std::nothrow) Entry[m_mask + 1];
+    if (!created) return nullptr;
+    if (!m_tables[cpu].compare_exchange_strong(table, created, std::memory_order_acq_rel)) {
+        // Another thread installed the table first.
+        delete[] created;
+        return table;
+    }
+    return created;
+}
+
+auto CpuIdCache::Find(unsigned int cpu, std::uint32_t eax, std::uint32_t ecx) const noexcept -> const Entry*
+{
+    if (cpu >= m_cpus) return nullptr;
+    const Entry* table = m_tables[cpu].load(std::memory_order_acquire);
+    if (!table) return nullptr;
+
+    std::size_t slot = GetSlot(eax, ecx);
+    for (std::size_t probe = 0; probe <= m_mask; probe++) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const Entry& entry = table[(slot + probe) & m_mask];
+        std::uint32_t state = entry.state.load(std::memory_order_acquire);
+
+        // An entry being written might be the one we're looking for, so it's
+        // a miss and not a reason to keep searching.
+        if (state != EntryReady) return nullptr;
+        if (entry.eax == eax && entry.ecx == ecx) return &entry;
+    }
+    return nullptr;
+}
+
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+auto CpuIdCache::Get(unsigned int cpu, std::uint32_t eax, std::uint32_t ecx) const noexcept -> CpuIdRegister
+{
+    const Entry* entry = Find(cpu, eax, ecx);
+    if (!entry) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return CpuIdRegister{};
+    }
+
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return CpuIdRegister{eax, ecx, entry->value};
+}
+
+auto CpuIdCache::Set(unsigned int cpu, const CpuIdRegister& reg) noexcept -> bool
+{
+    if (cpu >= m_cpus || !reg.IsValid()) return false;
+    Entry* table = GetTable(cpu);
+    if (!table) return false;
+
+    std::size_t slot = GetSlot(reg.InEax(), reg.InEcx());
+    for (std::size_t probe = 0; probe <= m_mask; probe++) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        Entry& entry = table[(slot + probe) & m_mask];
+        std::uint32_t state = entry.state.load(std::memory_order_acquire);
+        if (state == EntryReady) {
+            if (entry.eax == reg.InEax() && entry.ecx == reg.InEcx()) return true;
+            continue;
+        }
+
+        // If another thread is writing this slot, it might be for the same
+        // leaf. A second copy further on is harmless, as it's the same result.
+        if (state == EntryWriting) continue;
+        if (!entry.state.compare_exchange_strong(state, EntryWriting, std::memory_order_acq_rel)) continue;
+
+        entry.eax = reg.InEax();
+        entry.ecx = reg.InEcx();
+        entry.value = reg.Value();
+        entry.state.store(EntryReady, std::memory_order_release);
+        return true;
+    }
+    return false;
+}
+
+void CpuIdCache::Prefill(const tree::CpuIdTree& tree)
+{
+    for (auto cpu = tree.cbegin(); cpu != tree.cend(); ++cpu) {
+        for (const auto& leaf : cpu->second.Leaves()) {
+            Set(cpu->first, leaf.second);
+        }
+    }
+}
+
+auto CpuIdCache::Hits() const noexcept -> std::uint64_t
+{
+    return m_hits.load(std::memory_order_relaxed);
+}
+
+auto CpuIdCache::Misses() const noexcept -> std::uint64_t
+{
+    return m_misses.load(std::memory_order_relaxed);
+}
+
+}
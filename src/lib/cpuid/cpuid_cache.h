@@ -0,0 +1,128 @@
+#ifndef RJCP_LIB_CPUID_CPUID_CACHE_H
+#define RJCP_LIB_CPUID_CPUID_CACHE_H
+
+#include "cpuid/cpuid_register.h"
+#include "cpuid/cpuid_value.h"
+#include "cpuid/tree/cpuid_tree.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace rjcp::cpuid {
+
+/**
+ * @brief A concurrent cache of CPUID results per CPU, EAX and ECX.
+ *
+ * Each CPU has a fixed size open addressing hash table, allocated on first
+ * use. An entry is written once and never changes, so a lookup is a bounded
+ * number of atomic loads and never blocks (wait-free). Adding an entry claims
+ * a slot with a single compare and swap. When a CPU's table is full, new
+ * results are no longer cached.
+ */
+class CpuIdCache final
+{
+public:
+    /**
+     * @brief The default number of entries per CPU, which is more than the
+     * number of leaves of current processors.
+     */
+    static constexpr std::size_t DefaultCapacity = 512;
+
+    /**
+     * @brief Construct a new empty cache.
+     *
+     * @param cpus The number of CPUs that can be cached. Results for other
+     * CPUs are never cached.
+     * @param capacity The number of entries per CPU, rounded up to a power of
+     * two.
+     */
+    explicit CpuIdCache(unsigned int cpus, std::size_t capacity = DefaultCapacity);
+
+    CpuIdCache(const CpuIdCache&) = delete;
+    auto operator=(const CpuIdCache&) -> CpuIdCache& = delete;
+    CpuIdCache(CpuIdCache&&) = delete;
+    auto operator=(CpuIdCache&&) -> CpuIdCache& = delete;
+
+    /**
+     * @brief Destroy the CpuIdCache object.
+     *
+     * There must be no other threads using the cache.
+     */
+    ~CpuIdCache();
+
+    /**
+     * @brief Get a cached result, counting a hit or a miss.
+     *
+     * @param cpu The CPU number.
+     * @param eax The CPUID leaf.
+     * @param ecx The CPUID subleaf.
+     * @return CpuIdRegister The cached result, or an invalid register if it
+     * isn't in the cache.
+     */
+    auto Get(unsigned int cpu, std::uint32_t eax, std::uint32_t ecx) const noexcept -> CpuIdRegister;
+
+    /**
+     * @brief Add a result to the cache.
+     *
+     * @param cpu The CPU number.
+     * @param reg The result. Invalid results are not cached.
+     * @return true The result is in the cache.
+     * @return false The result couldn't be cached.
+     */
+    auto Set(unsigned int cpu, const CpuIdRegister& reg) noexcept -> bool;
+
+    /**
+     * @brief Add all results of an enumeration to the cache.
+     *
+     * This doesn't count any hits or misses.
+     *
+     * @param tree The results, e.g. from GetCpuId().
+     */
+    void Prefill(const tree::CpuIdTree& tree);
+
+    /**
+     * @brief Get the number of CPUs that can be cached.
+     *
+     * @return unsigned int The number of CPUs.
+     */
+    auto Cpus() const noexcept -> unsigned int { return m_cpus; }
+
+    /**
+     * @brief Get the number of lookups found in the cache.
+     *
+     * @return std::uint64_t The number of hits.
+     */
+    auto Hits() const noexcept -> std::uint64_t;
+
+    /**
+     * @brief Get the number of lookups not found in the cache, which needed
+     * to query the CPU.
+     *
+     * @return std::uint64_t The number of misses.
+     */
+    auto Misses() const noexcept -> std::uint64_t;
+
+private:
+    struct Entry {
+        std::atomic<std::uint32_t> state{};
+        std::uint32_t eax{};
+        std::uint32_t ecx{};
+        CpuIdValue value{};
+    };
+
+    unsigned int m_cpus;
+    std::size_t m_mask;
+    std::unique_ptr<std::atomic<Entry*>[]> m_tables;
+    mutable std::atomic<std::uint64_t> m_hits{};
+    mutable std::atomic<std::uint64_t> m_misses{};
+
+    auto Find(unsigned int cpu, std::uint32_t eax, std::uint32_t ecx) const noexcept -> const Entry*;
+    auto GetTable(unsigned int cpu) noexcept -> Entry*;
+    auto GetSlot(std::uint32_t eax, std::uint32_t ecx) const noexcept -> std::size_t;
+};
+
+}
+
+#endif
@@ -0,0 +1,62 @@
+#include "cpuid/cpuid_cached.h"
+
+#include <utility>
+#include <vector>
+
+namespace rjcp::cpuid {
+
+CpuIdCached::CpuIdCached(unsigned int cpunum, std::unique_ptr<ICpuId> cpuid, std::shared_ptr<CpuIdCache> cache) noexcept
+    : m_cpunum{cpunum}, m_cpuid{std::move(cpuid)}, m_cache{std::move(cache)}
+{ }
+
+auto CpuIdCached::GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister
+{
+    CpuIdRegister reg = m_cache->Get(m_cpunum, eax, ecx);
+    if (reg.IsValid()) return reg;
+
+    reg = m_cpuid->GetCpuId(eax, ecx);
+    m_cache->Set(m_cpunum, reg);
+    return reg;
+}
+
+void CpuIdCached::GetCpuId(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept
+{
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    std::size_t misses = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        registers[i] = m_cache->Get(m_cpunum, queries[i].eax, queries[i].ecx);
+        if (!registers[i].IsValid()) misses++;
+    }
+    if (misses == 0) return;
+
+    try {
+        std::vector<CpuIdQuery> missed{};
+        std::vector<std::size_t> positions{};
+        missed.reserve(misses);
+        positions.reserve(misses);
+        for (std::size_t i = 0; i < count; i++) {
+            if (!registers[i].IsValid()) {
+                missed.push_back(queries[i]);
+                positions.push_back(i);
+            }
+        }
+
+        std::vector<CpuIdRegister> results(misses);
+        m_cpuid->GetCpuId(missed.data(), results.data(), misses);
+        for (std::size_t i = 0; i < misses; i++) {
+            m_cache->Set(m_cpunum, results[i]);
+            registers[positions[i]] = results[i];
+        }
+    } catch (...) {
+        // Without memory for the batch, query the misses one at a time.
+        for (std::size_t i = 0; i < count; i++) {
+            if (!registers[i].IsValid()) {
+                registers[i] = m_cpuid->GetCpuId(queries[i].eax, queries[i].ecx);
+                m_cache->Set(m_cpunum, registers[i]);
+            }
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+}
@@ -0,0 +1,53 @@
+#ifndef RJCP_LIB_CPUID_CPUID_CACHED_H
+#define RJCP_LIB_CPUID_CPUID_CACHED_H
+
+#include "cpuid/cpuid_cache.h"
+#include "cpuid/icpuid.h"
+
+#include <memory>
+
+namespace rjcp::cpuid {
+
+/**
+ * @brief A reader that remembers the results of another reader in a shared
+ * CpuIdCache.
+ *
+ * The first query for an EAX, ECX pair on a CPU is given to the other reader,
+ * e.g. the native reader which must move the thread to the CPU. Later queries
+ * are answered from the cache without accessing the CPU.
+ */
+class CpuIdCached final : public ICpuId
+{
+public:
+    /**
+     * @brief Construct a new reader that caches the results of another.
+     *
+     * @param cpunum The CPU number of the other reader.
+     * @param cpuid The reader to query on a miss.
+     * @param cache The cache, which may be shared with readers of other CPUs.
+     */
+    CpuIdCached(unsigned int cpunum, std::unique_ptr<ICpuId> cpuid, std::shared_ptr<CpuIdCache> cache) noexcept;
+
+    auto GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister override;
+
+    /**
+     * @brief Get the CPU ID registers for a list of EAX, ECX values.
+     *
+     * All queries that miss the cache are given to the other reader as one
+     * batch.
+     *
+     * @param queries The list of count EAX, ECX values to query for.
+     * @param registers The list of count registers to write the results to.
+     * @param count The number of queries.
+     */
+    void GetCpuId(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept override;
+
+private:
+    unsigned int m_cpunum;
+    std::unique_ptr<ICpuId> m_cpuid;
+    std::shared_ptr<CpuIdCache> m_cache;
+};
+
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef RJCP_CPUID_CACHED_CONFIG_H
+#define RJCP_CPUID_CACHED_CONFIG_H
+
+#include "cpuid/icpuid_config.h"
+#include "cpuid/icpuid_factory.h"
+#include "cpuid/cpuid_cache.h"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace rjcp::cpuid {
+
+/**
+ * @brief Configuration for the CpuIdCached class for use with factories.
+ *
+ * The factory creates CpuIdCached objects that wrap the objects of another
+ * factory, all sharing the same cache. The cache can be accessed with
+ * GetCache(), e.g. to check the number of hits and misses.
+ */
+class CpuIdCachedConfig : public ICpuIdConfig
+{
+public:
+    /**
+     * @brief Construct a new CpuId Cached Config object.
+     *
+     * @param factory The factory to create the objects that are cached.
+     * @param prefill If the cache should be filled by enumerating all CPUs
+     * with GetCpuId() when the factory is created.
+     * @param capacity The number of results that can be cached per CPU.
+     */
+    CpuIdCachedConfig(std::shared_ptr<ICpuIdFactory> factory, bool prefill = false, std::size_t capacity = CpuIdCache::DefaultCapacity)
+        : m_factory{std::move(factory)},
+          m_cache{std::make_shared<CpuIdCache>(m_factory ? m_factory->threads() : 0, capacity)},
+          m_prefill{prefill}
+    { }
+
+    /**
+     * @brief Get the factory whose objects are cached.
+     *
+     * @return std::shared_ptr<ICpuIdFactory> The factory.
+     */
+    auto GetFactory() const -> std::shared_ptr<ICpuIdFactory> {
+        return m_factory;
+    }
+
+    /**
+     * @brief Get the cache shared by all objects of the factory.
+     *
+     * @return std::shared_ptr<CpuIdCache> The cache.
+     */
+    auto GetCache() const -> std::shared_ptr<CpuIdCache> {
+        return m_cache;
+    }
+
+    /**
+     * @brief If the cache should be filled when the factory is created.
+     *
+     * @return bool True if the cache is filled.
+     */
+    auto Prefill() const -> bool {
+        return m_prefill;
+    }
+
+private:
+    std::shared_ptr<ICpuIdFactory> m_factory;
+    std::shared_ptr<CpuIdCache> m_cache;
+    bool m_prefill;
+};
+
+}
+
+#endif
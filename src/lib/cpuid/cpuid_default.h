@@ -29,6 +29,8 @@ public:
      * @return CpuIdRegister The result of the query.
      */
     auto GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister override;
+
+    using ICpuId::GetCpuId;
 };
 
 }
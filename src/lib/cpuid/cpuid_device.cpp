@@ -1,24 +1,67 @@
 #include "cpuid/cpuid_device.h"
 #include "os/qnx/native/file/file.h"
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
-#include <sstream>
 #include <utility>
-#include <vector>
 
 namespace rjcp::cpuid {
 
+namespace {
+
+// The number of queries submitted to the ring at once. The buffers are on the
+// stack, so it is kept small.
+constexpr unsigned int RingEntries = 64;
+
+constexpr std::size_t RegisterSize = 16;
+
+// The most consecutive leaves read with a single preadv.
+constexpr std::size_t VectorEntries = 64;
+
+auto GetOffset(std::uint32_t eax, std::uint32_t ecx) noexcept -> std::size_t
+{
+    return eax | static_cast<std::size_t>(ecx) << 32;
+}
+
+auto GetRegister(std::uint32_t eax, std::uint32_t ecx, const std::array<std::uint8_t, RegisterSize>& buffer) noexcept -> CpuIdRegister
+{
+    std::uint32_t oeax = buffer[0] | (buffer[1] << 8) | (buffer[2] << 16) | (buffer[3] << 24);
+    std::uint32_t oebx = buffer[4] | (buffer[5] << 8) | (buffer[6] << 16) | (buffer[7] << 24);
+    std::uint32_t oecx = buffer[8] | (buffer[9] << 8) | (buffer[10] << 16) | (buffer[11] << 24);
+    std::uint32_t oedx = buffer[12] | (buffer[13] << 8) | (buffer[14] << 16) | (buffer[15] << 24);
+    return CpuIdRegister{eax, ecx, oeax, oebx, oecx, oedx};
+}
+
+}
+
 CpuIdDevice::CpuIdDevice(unsigned int cpunum, DeviceAccessMethod method) noexcept
     : m_method{method}
 {
-    std::ostringstream device;
-    device << "/dev/cpu/" << cpunum << "/cpuid";
+    auto handle = os::qnx::native::file::open(GetCpuIdDevicePath(cpunum));
+    if (handle)
+        m_device = std::move(*handle);
+}
+
+CpuIdDevice::CpuIdDevice(unsigned int cpunum, std::shared_ptr<CpuIdDevicePool> pool, DeviceAccessMethod method) noexcept
+    : m_method{method}, m_cpunum{cpunum}, m_pool{std::move(pool)}
+{
+    if (m_pool) {
+        m_device = m_pool->Borrow(cpunum);
+        return;
+    }
 
-    auto handle = os::qnx::native::file::open(device.str());
+    auto handle = os::qnx::native::file::open(GetCpuIdDevicePath(cpunum));
     if (handle)
         m_device = std::move(*handle);
 }
 
+CpuIdDevice::~CpuIdDevice() noexcept
+{
+    if (m_pool && m_device)
+        m_pool->Return(m_cpunum, std::move(m_device));
+}
+
 // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
 auto CpuIdDevice::GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister
 {
@@ -28,11 +71,12 @@ auto CpuIdDevice::GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept
         return CpuIdRegister{};
     }
 
-    std::vector<uint8_t> buffer(16);
+    // The registers are read to the stack, so no allocation is needed.
+    std::array<std::uint8_t, RegisterSize> buffer{};
 
     // We provide two different methods for testing. Under QNX, the pread must
     // be handled explicitly and is different to read.
-    std::size_t pos = eax | static_cast<std::size_t>(ecx) << 32;
+    std::size_t pos = GetOffset(eax, ecx);
     if (m_method == DeviceAccessMethod::seek) {
         auto seek = os::qnx::native::file::lseek64(m_device, pos);
         if (!seek) {
@@ -55,11 +99,117 @@ auto CpuIdDevice::GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept
         }
     }
 
-    std::uint32_t oeax = buffer[0] | (buffer[1] << 8) | (buffer[2] << 16) | (buffer[3] << 24);
-    std::uint32_t oebx = buffer[4] | (buffer[5] << 8) | (buffer[6] << 16) | (buffer[7] << 24);
-    std::uint32_t oecx = buffer[8] | (buffer[9] << 8) | (buffer[10] << 16) | (buffer[11] << 24);
-    std::uint32_t oedx = buffer[12] | (buffer[13] << 8) | (buffer[14] << 16) | (buffer[15] << 24);
-    return CpuIdRegister{eax, ecx, oeax, oebx, oecx, oedx};
+    return GetRegister(eax, ecx, buffer);
+}
+
+void CpuIdDevice::GetCpuId(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept
+{
+    if (m_method == DeviceAccessMethod::uring && GetCpuIdUring(queries, registers, count))
+        return;
+
+    if (m_method == DeviceAccessMethod::preadv) {
+        GetCpuIdVector(queries, registers, count);
+        return;
+    }
+
+    ICpuId::GetCpuId(queries, registers, count);
+}
+
+auto CpuIdDevice::GetCpuIdUring(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept -> bool
+{
+    if (!m_device) return false;
+
+    std::lock_guard<std::mutex> lock{m_ringLock};
+    if (!m_ringSetup) {
+        // The ring is only set up when there is a batch to read, as single
+        // queries are read with pread64.
+        m_ringSetup = true;
+        auto ring = os::qnx::native::file::uring(RingEntries);
+        if (ring)
+            m_ring = std::move(*ring);
+    }
+    if (!m_ring) return false;
+
+    std::array<std::array<std::uint8_t, RegisterSize>, RingEntries> buffers{};
+    std::array<os::qnx::native::file::ReadRequest, RingEntries> requests{};
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic) - Caller provides count elements
+    for (std::size_t offset = 0; offset < count; offset += RingEntries) {
+        std::size_t batch = std::min<std::size_t>(count - offset, RingEntries);
+        for (std::size_t i = 0; i < batch; i++) {
+            const CpuIdQuery& query = queries[offset + i];
+            requests[i] = os::qnx::native::file::ReadRequest{
+                &m_device, buffers[i].data(), RegisterSize, GetOffset(query.eax, query.ecx), 0};
+        }
+
+        if (!m_ring.pread(requests.data(), batch)) {
+            // The ring can't be used. Results up to now are kept, and the
+            // caller reads the rest.
+            if (offset == 0) return false;
+            for (std::size_t i = offset; i < count; i++) {
+                registers[i] = GetCpuId(queries[i].eax, queries[i].ecx);
+            }
+            return true;
+        }
+
+        for (std::size_t i = 0; i < batch; i++) {
+            const CpuIdQuery& query = queries[offset + i];
+            const auto& result = requests[i].result;
+            if (!result || *result != RegisterSize) {
+                // The ring may not support the read, so don't rely on it.
+                registers[offset + i] = GetCpuId(query.eax, query.ecx);
+            } else {
+                registers[offset + i] = GetRegister(query.eax, query.ecx, buffers[i]);
+            }
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return true;
+}
+
+void CpuIdDevice::GetCpuIdVector(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept
+{
+    std::array<std::array<std::uint8_t, RegisterSize>, VectorEntries> buffers{};
+    std::array<struct iovec, VectorEntries> iov{};
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic) - Caller provides count elements
+    std::size_t offset = 0;
+    while (offset < count) {
+        // The driver reads the next EAX for each register, so find the queries
+        // that follow on. The EAX must not wrap, as that would increment ECX.
+        const CpuIdQuery& first = queries[offset];
+        std::size_t run = 1;
+        while (offset + run < count && run < VectorEntries &&
+               queries[offset + run].ecx == first.ecx &&
+               static_cast<std::uint64_t>(queries[offset + run].eax) == static_cast<std::uint64_t>(first.eax) + run) {
+            run++;
+        }
+
+        bool read = false;
+        if (run > 1 && m_device) {
+            for (std::size_t i = 0; i < run; i++) {
+                iov[i].iov_base = buffers[i].data();
+                iov[i].iov_len = RegisterSize;
+            }
+            auto bytes = os::qnx::native::file::preadv(m_device, iov.data(), run, GetOffset(first.eax, first.ecx));
+            if (bytes && *bytes == run * RegisterSize) {
+                for (std::size_t i = 0; i < run; i++) {
+                    const CpuIdQuery& query = queries[offset + i];
+                    registers[offset + i] = GetRegister(query.eax, query.ecx, buffers[i]);
+                }
+                read = true;
+            }
+        }
+
+        if (!read) {
+            // A single query, or the driver didn't return all registers.
+            for (std::size_t i = 0; i < run; i++) {
+                registers[offset + i] = GetCpuId(queries[offset + i].eax, queries[offset + i].ecx);
+            }
+        }
+        offset += run;
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
 }
 
 }
@@ -2,14 +2,21 @@
 #define RJCP_LIB_CPUID_CPUID_DEVICE_H
 
 #include "cpuid/icpuid.h"
+#include "cpuid/cpuid_device_pool.h"
 #include "os/qnx/native/file/file.h"
+#include "os/qnx/native/file/uring.h"
+
+#include <memory>
+#include <mutex>
 
 namespace rjcp::cpuid {
 
 enum class DeviceAccessMethod
 {
     seek,
-    pread
+    pread,
+    uring,
+    preadv
 };
 
 /**
@@ -23,10 +30,36 @@ public:
      * @brief Construct a new CpuId Device object
      *
      * @param cpunum The CPU number to configure for.
-     * @param method How to access the device using lseek64/read or pread64.
+     * @param method How to access the device using lseek64/read, pread64,
+     * batches of reads submitted with io_uring, or preadv for consecutive
+     * leaves.
      */
     CpuIdDevice(unsigned int cpunum, DeviceAccessMethod method = DeviceAccessMethod::seek) noexcept;
 
+    /**
+     * @brief Construct a new CpuId Device object, using the device from a pool.
+     *
+     * The device is borrowed from the pool, so it isn't opened again if a
+     * previous reader for the same CPU already opened it. It is returned to
+     * the pool when this object is destroyed.
+     *
+     * @param cpunum The CPU number to configure for.
+     * @param pool The pool of open devices.
+     * @param method How to access the device.
+     */
+    CpuIdDevice(unsigned int cpunum, std::shared_ptr<CpuIdDevicePool> pool, DeviceAccessMethod method) noexcept;
+
+    CpuIdDevice(const CpuIdDevice&) = delete;
+    auto operator=(const CpuIdDevice&) -> CpuIdDevice& = delete;
+    CpuIdDevice(CpuIdDevice&&) = delete;
+    auto operator=(CpuIdDevice&&) -> CpuIdDevice& = delete;
+
+    /**
+     * @brief Destroy the CpuId Device object, returning the device to the pool.
+     *
+     */
+    ~CpuIdDevice() noexcept override;
+
     /**
      * @brief Get the CPUID for the given EAX and ECX registers.
      *
@@ -39,9 +72,36 @@ public:
      */
     auto GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister override;
 
+    /**
+     * @brief Get the CPUID for a list of EAX and ECX registers.
+     *
+     * Each query is read from the device in turn. With the uring access
+     * method, the queries are submitted together as reads to an io_uring, so
+     * that many queries need only a few system calls. If the ring can't be
+     * used, e.g. the Operating System doesn't support it, the queries are read
+     * with pread64.
+     *
+     * With the preadv access method, queries for consecutive EAX values with
+     * the same ECX are read with a single preadv. The Linux driver returns the
+     * next leaf for every 16 bytes read.
+     *
+     * @param queries The list of count EAX, ECX values to query for.
+     * @param registers The list of count registers to write the results to.
+     * @param count The number of queries.
+     */
+    void GetCpuId(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept override;
+
 private:
+    auto GetCpuIdUring(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept -> bool;
+    void GetCpuIdVector(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept;
+
     os::qnx::native::file::FileHandle m_device{};
     DeviceAccessMethod m_method;
+    unsigned int m_cpunum{};
+    std::shared_ptr<CpuIdDevicePool> m_pool{};
+    mutable std::mutex m_ringLock{};
+    mutable os::qnx::native::file::Uring m_ring{};
+    mutable bool m_ringSetup{};
 };
 
 }
@@ -3,21 +3,28 @@
 
 #include "cpuid/icpuid_config.h"
 #include "cpuid/cpuid_device.h"
+#include "cpuid/cpuid_device_pool.h"
+
+#include <memory>
 
 namespace rjcp::cpuid {
 
 /**
  * @brief Configuration for the CpuIdDevice class for use with factories.
  *
+ * The devices that the readers open are kept in the pool. Factories created
+ * from the same configuration share the pool, so that taking a new snapshot
+ * doesn't open the devices again.
  */
 class CpuIdDeviceConfig : public ICpuIdConfig
 {
 public:
     CpuIdDeviceConfig(DeviceAccessMethod method = DeviceAccessMethod::seek)
-        : method{method}
+        : method{method}, pool{std::make_shared<CpuIdDevicePool>()}
     { }
 
     DeviceAccessMethod method;
+    std::shared_ptr<CpuIdDevicePool> pool;
 };
 
 }
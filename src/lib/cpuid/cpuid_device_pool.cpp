@@ -0,0 +1,57 @@
+#include "cpuid/cpuid_device_pool.h"
+
+#include <new>
+#include <utility>
+
+namespace rjcp::cpuid {
+
+auto GetCpuIdDevicePath(unsigned int cpunum) -> std::string
+{
+    std::string path{"/dev/cpu/"};
+    path += std::to_string(cpunum);
+    path += "/cpuid";
+    return path;
+}
+
+auto CpuIdDevicePool::Borrow(unsigned int cpunum) noexcept -> os::qnx::native::file::FileHandle
+{
+    {
+        std::lock_guard<std::mutex> lock{m_lock};
+        if (cpunum < m_handles.size() && !m_handles[cpunum].empty()) {
+            os::qnx::native::file::FileHandle handle{std::move(m_handles[cpunum].back())};
+            m_handles[cpunum].pop_back();
+            m_size--;
+            return handle;
+        }
+    }
+
+    try {
+        auto handle = os::qnx::native::file::open(GetCpuIdDevicePath(cpunum));
+        if (handle) return std::move(*handle);
+    } catch (const std::bad_alloc&) {
+        // Couldn't build the path.
+    }
+    return os::qnx::native::file::FileHandle{};
+}
+
+void CpuIdDevicePool::Return(unsigned int cpunum, os::qnx::native::file::FileHandle handle) noexcept
+{
+    if (!handle) return;
+
+    try {
+        std::lock_guard<std::mutex> lock{m_lock};
+        if (cpunum >= m_handles.size()) m_handles.resize(cpunum + 1);
+        m_handles[cpunum].push_back(std::move(handle));
+        m_size++;
+    } catch (const std::bad_alloc&) {
+        // The handle isn't kept, and is closed.
+    }
+}
+
+auto CpuIdDevicePool::Size() const noexcept -> std::size_t
+{
+    std::lock_guard<std::mutex> lock{m_lock};
+    return m_size;
+}
+
+}
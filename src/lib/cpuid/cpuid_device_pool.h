@@ -0,0 +1,66 @@
+#ifndef RJCP_LIB_CPUID_CPUID_DEVICE_POOL_H
+#define RJCP_LIB_CPUID_CPUID_DEVICE_POOL_H
+
+#include "os/qnx/native/file/file.h"
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rjcp::cpuid {
+
+/**
+ * @brief Get the path of the device for the CPU.
+ *
+ * @param cpunum The CPU number.
+ * @return std::string The path, e.g. `/dev/cpu/0/cpuid`.
+ */
+auto GetCpuIdDevicePath(unsigned int cpunum) -> std::string;
+
+/**
+ * @brief The open devices of each CPU, borrowed by the readers of the devices.
+ *
+ * A reader borrows the device of its CPU, and returns it when it's finished.
+ * The device is only opened if there is none to borrow, so taking a snapshot
+ * again doesn't open the devices again. As a borrowed device is used by only
+ * one reader, the reader may change the position of the device.
+ *
+ * The pool is thread safe.
+ */
+class CpuIdDevicePool
+{
+public:
+    /**
+     * @brief Borrow the device for the CPU, opening it if none is available.
+     *
+     * @param cpunum The CPU number.
+     * @return FileHandle The open device, or an invalid handle if it couldn't
+     * be opened.
+     */
+    auto Borrow(unsigned int cpunum) noexcept -> os::qnx::native::file::FileHandle;
+
+    /**
+     * @brief Return a borrowed device to the pool.
+     *
+     * @param cpunum The CPU number that the device was borrowed for.
+     * @param handle The open device.
+     */
+    void Return(unsigned int cpunum, os::qnx::native::file::FileHandle handle) noexcept;
+
+    /**
+     * @brief Get the number of open devices in the pool that can be borrowed.
+     *
+     * @return std::size_t The number of devices.
+     */
+    auto Size() const noexcept -> std::size_t;
+
+private:
+    mutable std::mutex m_lock{};
+    std::vector<std::vector<os::qnx::native::file::FileHandle>> m_handles{};
+    std::size_t m_size{};
+};
+
+}
+
+#endif
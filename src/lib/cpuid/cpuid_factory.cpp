@@ -1,12 +1,24 @@
 #include "cpuid/cpuid_factory.h"
+#include "cpuid/cpuid_boot_cache_config.h"
+#include "cpuid/cpuid_boot_cache.h"
+#include "cpuid/cpuid_cached_config.h"
+#include "cpuid/cpuid_cached.h"
 #include "cpuid/cpuid_device_config.h"
 #include "cpuid/cpuid_device.h"
 #include "cpuid/cpuid_default_config.h"
 #include "cpuid/cpuid_default.h"
+#include "cpuid/cpuid_file_config.h"
+#include "cpuid/cpuid_file.h"
 #include "cpuid/cpuid_native_config.h"
 #include "cpuid/cpuid_native.h"
+#include "cpuid/cpuid_native_engine_config.h"
+#include "cpuid/cpuid_native_engine_reader.h"
+#include "cpuid/get_cpuid.h"
+#include "os/qnx/native/sched/sched.h"
 
 #include <thread>
+#include <utility>
+#include <vector>
 
 namespace rjcp::cpuid
 {
@@ -14,12 +26,60 @@ namespace rjcp::cpuid
 namespace
 {
 
+/**
+ * @brief Get all CPUs reported by the C++ runtime.
+ */
+auto GetAllCpus() -> std::vector<unsigned int>
+{
+    std::vector<unsigned int> cpus(std::thread::hardware_concurrency());
+    for (unsigned int cpu = 0; cpu < cpus.size(); cpu++) {
+        cpus[cpu] = cpu;
+    }
+    return cpus;
+}
+
+/**
+ * @brief Get the CPUs that the current thread may be pinned to, for readers
+ * that execute the CPUID instruction.
+ */
+auto GetAffinityCpus() -> std::vector<unsigned int>
+{
+    auto cpus = os::qnx::native::sched::get_affinity();
+    if (!cpus || cpus->empty()) return GetAllCpus();
+    return std::move(*cpus);
+}
+
+/**
+ * @brief Get the CPUs that are online, for readers that don't need to run on
+ * the CPU.
+ */
+auto GetOnlineCpus() -> std::vector<unsigned int>
+{
+    auto cpus = os::qnx::native::sched::get_online();
+    if (!cpus || cpus->empty()) return GetAllCpus();
+    return std::move(*cpus);
+}
+
+/**
+ * @brief Get the number of CPUs of the system from the online CPUs, which
+ * don't depend on the affinity of the process.
+ *
+ * @param cpus The CPUs that can be queried, which are always included.
+ */
+auto GetThreads(const std::vector<unsigned int>& cpus) -> unsigned int
+{
+    std::vector<unsigned int> online = GetOnlineCpus();
+    unsigned int threads = online.empty() ? 0 : online.back() + 1;
+    if (!cpus.empty() && cpus.back() >= threads) threads = cpus.back() + 1;
+    return threads;
+}
+
 template<typename CreationCallback>
 class CpuIdFactoryWithCallback : public ICpuIdFactory
 {
 public:
-    CpuIdFactoryWithCallback(const CreationCallback& create_callback)
-    : m_create_callback{create_callback}
+    CpuIdFactoryWithCallback(const CreationCallback& create_callback, std::vector<unsigned int> cpus, unsigned int threads)
+    : m_create_callback{create_callback}, m_cpus{std::move(cpus)}, m_threads{threads}
     { };
 
     auto create(unsigned int cpunum) noexcept -> std::unique_ptr<ICpuId> override
@@ -29,40 +89,175 @@ public:
 
     auto threads() const -> unsigned int override
     {
-        return std::thread::hardware_concurrency();
+        return m_threads;
+    }
+
+    auto cpus() const -> std::vector<unsigned int> override
+    {
+        return m_cpus;
     }
 
 private:
     CreationCallback m_create_callback;
+    std::vector<unsigned int> m_cpus;
+    unsigned int m_threads;
 };
 
 template<typename CreationCallback>
-auto MakeCpuIdFactory(const CreationCallback& callback) -> std::unique_ptr<ICpuIdFactory>
+auto MakeCpuIdFactory(const CreationCallback& callback, std::vector<unsigned int> cpus) -> std::unique_ptr<ICpuIdFactory>
 {
-    return std::make_unique<CpuIdFactoryWithCallback<CreationCallback>>(callback);
+    unsigned int threads = GetThreads(cpus);
+    return std::make_unique<CpuIdFactoryWithCallback<CreationCallback>>(callback, std::move(cpus), threads);
 }
 
+/**
+ * @brief A factory for CPUs from a saved dump, which knows the number of CPUs
+ * in the dump.
+ */
+class CpuIdFileFactory : public ICpuIdFactory
+{
+public:
+    CpuIdFileFactory(std::shared_ptr<const tree::CpuIdSnapshot> snapshot)
+    : m_snapshot{std::move(snapshot)}, m_threads{GetCpuIdFileThreads(*m_snapshot)}
+    { }
+
+    CpuIdFileFactory(std::shared_ptr<const tree::CpuIdSnapshot> snapshot, unsigned int threads)
+    : m_snapshot{std::move(snapshot)}, m_threads{threads}
+    { }
+
+    auto create(unsigned int cpunum) noexcept -> std::unique_ptr<ICpuId> override
+    {
+        return std::make_unique<CpuIdFile>(cpunum, m_snapshot);
+    }
+
+    auto threads() const -> unsigned int override
+    {
+        return m_threads;
+    }
+
+    auto cpus() const -> std::vector<unsigned int> override
+    {
+        std::vector<unsigned int> result{};
+        result.reserve(m_snapshot->Size());
+        for (std::size_t pos = 0; pos < m_snapshot->Size(); pos++) {
+            tree::CpuIdSnapshotProcessor processor = m_snapshot->GetProcessorAt(pos);
+            if (processor.Cpu() < m_threads && !processor.IsDisallowed()) result.push_back(processor.Cpu());
+        }
+        return result;
+    }
+
+private:
+    std::shared_ptr<const tree::CpuIdSnapshot> m_snapshot;
+    unsigned int m_threads;
+};
+
+/**
+ * @brief A factory that wraps the objects of another factory in a cache.
+ */
+class CpuIdCachedFactory : public ICpuIdFactory
+{
+public:
+    CpuIdCachedFactory(std::shared_ptr<ICpuIdFactory> factory, std::shared_ptr<CpuIdCache> cache)
+    : m_factory{std::move(factory)}, m_cache{std::move(cache)}
+    { }
+
+    auto create(unsigned int cpunum) noexcept -> std::unique_ptr<ICpuId> override
+    {
+        auto cpuid = m_factory->create(cpunum);
+        if (!cpuid) return nullptr;
+        return std::make_unique<CpuIdCached>(cpunum, std::move(cpuid), m_cache);
+    }
+
+    auto threads() const -> unsigned int override
+    {
+        return m_factory->threads();
+    }
+
+    auto cpus() const -> std::vector<unsigned int> override
+    {
+        return m_factory->cpus();
+    }
+
+private:
+    std::shared_ptr<ICpuIdFactory> m_factory;
+    std::shared_ptr<CpuIdCache> m_cache;
+};
+
 } // namespace
 
+template<>
+auto CreateCpuIdFactory(const CpuIdBootCacheConfig &config) noexcept -> std::unique_ptr<ICpuIdFactory>
+{
+    if (!config.factory) return nullptr;
+
+    try {
+        auto snapshot = GetCpuIdBootCache(*config.factory, config.directory);
+        if (!snapshot) return nullptr;
+        return std::make_unique<CpuIdFileFactory>(std::move(snapshot), config.factory->threads());
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+template<>
+auto CreateCpuIdFactory(const CpuIdCachedConfig &config) noexcept -> std::unique_ptr<ICpuIdFactory>
+{
+    try {
+        auto factory = config.GetFactory();
+        if (!factory) return nullptr;
+
+        auto cache = config.GetCache();
+        if (config.Prefill()) cache->Prefill(*GetCpuId(*factory));
+        return std::make_unique<CpuIdCachedFactory>(std::move(factory), std::move(cache));
+    } catch (...) {
+        return nullptr;
+    }
+}
+
 template<>
 auto CreateCpuIdFactory(const CpuIdDefaultConfig &) noexcept -> std::unique_ptr<ICpuIdFactory>
 {
     return MakeCpuIdFactory([](unsigned int cpunum) -> std::unique_ptr<ICpuId>
-                            { return std::make_unique<CpuIdDefault>(cpunum); });
+                            { return std::make_unique<CpuIdDefault>(cpunum); },
+                            GetAllCpus());
 }
 
 template<>
 auto CreateCpuIdFactory(const CpuIdDeviceConfig &config) noexcept -> std::unique_ptr<ICpuIdFactory>
 {
     return MakeCpuIdFactory([config](unsigned int cpunum) -> std::unique_ptr<ICpuId>
-                            { return std::make_unique<CpuIdDevice>(cpunum, config.method); });
+                            { return std::make_unique<CpuIdDevice>(cpunum, config.pool, config.method); },
+                            GetOnlineCpus());
+}
+
+template<>
+auto CreateCpuIdFactory(const CpuIdFileConfig &config) noexcept -> std::unique_ptr<ICpuIdFactory>
+{
+    try {
+        auto snapshot = LoadCpuIdFile(config.fileName);
+        if (!snapshot) return nullptr;
+        return std::make_unique<CpuIdFileFactory>(std::move(snapshot));
+    } catch (...) {
+        return nullptr;
+    }
 }
 
 template<>
 auto CreateCpuIdFactory(const CpuIdNativeConfig &) noexcept -> std::unique_ptr<ICpuIdFactory>
 {
     return MakeCpuIdFactory([](unsigned int cpunum) -> std::unique_ptr<ICpuId>
-                            { return std::make_unique<CpuIdNative>(cpunum); });
+                            { return std::make_unique<CpuIdNative>(cpunum); },
+                            GetAffinityCpus());
+}
+
+template<>
+auto CreateCpuIdFactory(const CpuIdNativeEngineConfig &) noexcept -> std::unique_ptr<ICpuIdFactory>
+{
+    std::vector<unsigned int> cpus = GetAffinityCpus();
+    auto engine = std::make_shared<const CpuIdNativeEngine>(GetThreads(cpus));
+    return MakeCpuIdFactory([engine](unsigned int cpunum) -> std::unique_ptr<ICpuId>
+                            { return std::make_unique<CpuIdNativeEngineReader>(cpunum, engine); },
+                            std::move(cpus));
 }
 
 }
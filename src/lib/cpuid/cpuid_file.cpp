@@ -0,0 +1,36 @@
+#include "cpuid/cpuid_file.h"
+#include "cpuid/tree/cpuid_read_xml.h"
+#include "cpuid/tree/cpuid_write_snapshot.h"
+
+#include <utility>
+
+namespace rjcp::cpuid {
+
+auto LoadCpuIdFile(const std::string& fileName) -> std::shared_ptr<const tree::CpuIdSnapshot>
+{
+    auto snapshot = tree::CpuIdSnapshot::Open(fileName);
+    if (snapshot) return snapshot;
+
+    auto tree = tree::ReadCpuIdXml(fileName);
+    if (!tree) return nullptr;
+    return tree::CpuIdSnapshot::Open(tree::GetCpuIdSnapshot(*tree));
+}
+
+auto GetCpuIdFileThreads(const tree::CpuIdSnapshot& snapshot) noexcept -> unsigned int
+{
+    if (snapshot.Size() == 0) return 0;
+    return snapshot.GetProcessorAt(snapshot.Size() - 1).Cpu() + 1;
+}
+
+CpuIdFile::CpuIdFile(unsigned int cpunum, std::shared_ptr<const tree::CpuIdSnapshot> snapshot) noexcept
+    : m_snapshot{std::move(snapshot)}, m_processor{m_snapshot ? m_snapshot->GetProcessor(cpunum) : tree::CpuIdSnapshotProcessor{}}
+{ }
+
+auto CpuIdFile::GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister
+{
+    auto leaf = m_processor.GetLeaf(eax, ecx);
+    if (leaf == nullptr) return CpuIdRegister{};
+    return *leaf;
+}
+
+}
@@ -0,0 +1,61 @@
+#ifndef RJCP_LIB_CPUID_CPUID_FILE_H
+#define RJCP_LIB_CPUID_CPUID_FILE_H
+
+#include "cpuid/icpuid.h"
+#include "cpuid/tree/cpuid_snapshot.h"
+#include "cpuid/tree/cpuid_snapshot_processor.h"
+
+#include <memory>
+#include <string>
+
+namespace rjcp::cpuid {
+
+/**
+ * @brief Load a saved CPUID dump, either a binary snapshot or XML.
+ *
+ * A binary snapshot is mapped into memory and used directly. XML is read and
+ * converted to a snapshot in memory, so that both are served the same way.
+ *
+ * @param fileName The name of the file to load.
+ * @return std::shared_ptr<const tree::CpuIdSnapshot> The contents of the
+ * file, or nullptr if it can't be read or is malformed.
+ */
+auto LoadCpuIdFile(const std::string& fileName) -> std::shared_ptr<const tree::CpuIdSnapshot>;
+
+/**
+ * @brief Get the number of CPUs in the snapshot for a factory.
+ *
+ * @param snapshot The snapshot.
+ * @return unsigned int One more than the largest CPU number, so that CPUs
+ * missing in the file (e.g. they were offline) are counted.
+ */
+auto GetCpuIdFileThreads(const tree::CpuIdSnapshot& snapshot) noexcept -> unsigned int;
+
+/**
+ * @brief A reader that returns the CPUID information of a CPU from a saved
+ * dump, instead of the current machine.
+ */
+class CpuIdFile final : public ICpuId
+{
+public:
+    /**
+     * @brief Construct a new reader for the CPU in the snapshot.
+     *
+     * @param cpunum The CPU number. If it isn't in the snapshot, all results
+     * are invalid.
+     * @param snapshot The snapshot loaded with LoadCpuIdFile().
+     */
+    CpuIdFile(unsigned int cpunum, std::shared_ptr<const tree::CpuIdSnapshot> snapshot) noexcept;
+
+    auto GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister override;
+
+    using ICpuId::GetCpuId;
+
+private:
+    std::shared_ptr<const tree::CpuIdSnapshot> m_snapshot;
+    tree::CpuIdSnapshotProcessor m_processor;
+};
+
+}
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef RJCP_CPUID_FILE_CONFIG_H
+#define RJCP_CPUID_FILE_CONFIG_H
+
+#include "cpuid/icpuid_config.h"
+#include "cpuid/cpuid_file.h"
+
+#include <string>
+#include <utility>
+
+namespace rjcp::cpuid {
+
+/**
+ * @brief Configuration for the CpuIdFile class for use with factories.
+ *
+ * The file is loaded once when the factory is created, and shared by all
+ * CpuIdFile objects it creates. If the file can't be loaded, the factory is
+ * nullptr.
+ */
+class CpuIdFileConfig : public ICpuIdConfig
+{
+public:
+    explicit CpuIdFileConfig(std::string fileName)
+        : fileName{std::move(fileName)}
+    { }
+
+    std::string fileName;
+};
+
+}
+
+#endif
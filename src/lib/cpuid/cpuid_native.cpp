@@ -1,11 +1,14 @@
 #include "cpuid/cpuid_native.h"
 
-#include <pthread.h>
-
 namespace rjcp::cpuid {
 
-CpuIdNative::CpuIdNative(unsigned int cpunum) noexcept
-    : m_cpunum(cpunum) { }
+auto CpuIdNative::GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister
+{
+    CpuIdQuery query{eax, ecx};
+    CpuIdRegister cpureg{};
+    GetCpuId(&query, &cpureg, 1);
+    return cpureg;
+}
 
 // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
 auto CpuIdNative::GetCpuIdCurrentThread(std::uint32_t eax, std::uint32_t ecx) noexcept -> const CpuIdRegister
@@ -3,6 +3,9 @@
 
 #include "cpuid/icpuid.h"
 
+#include <cstddef>
+#include <memory>
+
 namespace rjcp::cpuid {
 
 /**
@@ -31,13 +34,27 @@ public:
      */
     auto GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister override;
 
-private:
+    /**
+     * @brief Get the CPUID for a list of EAX and ECX registers.
+     *
+     * The current thread is moved to the CPU once for all queries, and
+     * restored when finished. If the thread is already pinned to only this
+     * CPU, the affinity isn't changed. If the thread cannot be set properly,
+     * all results will be invalid.
+     *
+     * @param queries The list of count EAX, ECX values to query for.
+     * @param registers The list of count registers to write the results to.
+     * @param count The number of queries.
+     */
+    void GetCpuId(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept override;
+
     /**
      * @brief Get the CPUID for the given EAX and ECX registers on the current
      * thread.
      *
-     * This method is a helper to call the native CPU instruction and is
-     * specific only to this implementation.
+     * This method is a helper to call the native CPU instruction. The result
+     * is for the CPU the current thread is running on, so the caller is
+     * responsible for the thread affinity.
      *
      * @param eax The major leaf (EAX register) to query.
      * @param ecx The minor leaf (ECX register) to query.
@@ -45,7 +62,14 @@ private:
      */
     static auto GetCpuIdCurrentThread(std::uint32_t eax, std::uint32_t ecx) noexcept -> const CpuIdRegister;
 
+private:
     unsigned int m_cpunum;
+
+    // The CPU set that pins a thread to the CPU, sized for the system and
+    // built once, with its size in bytes. It is nullptr if the OS doesn't
+    // need one, or it couldn't be allocated.
+    std::unique_ptr<void, void (*)(void*)> m_cpuset{nullptr, nullptr};
+    std::size_t m_cpusetsize{};
 };
 
 }
@@ -0,0 +1,267 @@
+#include "cpuid/cpuid_native_engine.h"
+#include "cpuid/cpuid_native.h"
+#include "os/qnx/native/sched/sched.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+namespace rjcp::cpuid {
+
+namespace
+{
+
+/**
+ * @brief The number of times the caller checks for the result, yielding in
+ * between, before it blocks until it is woken by the worker.
+ */
+constexpr unsigned int SpinCount = 64;
+
+/**
+ * @brief A list of queries for a CPU, that the caller waits on to be done.
+ *
+ * The request is owned by the caller, usually on its stack, and is also the
+ * node in the queue, so that no allocations are needed.
+ */
+struct Request
+{
+    std::atomic<Request*> next{nullptr};
+    const CpuIdQuery* queries{nullptr};
+    CpuIdRegister* registers{nullptr};
+    std::size_t count{0};
+    std::atomic<bool> done{false};
+    std::mutex lock{};
+    std::condition_variable wake{};
+};
+
+/**
+ * @brief An intrusive lock-free multiple producer, single consumer queue.
+ *
+ * This is the algorithm from Dmitry Vyukov. Pushing is wait-free. A request is
+ * only returned by Pop() when no producer will access it anymore, so the
+ * consumer may complete it, after which the producer can destroy it.
+ */
+class RequestQueue
+{
+public:
+    RequestQueue() noexcept
+        : m_head{&m_stub}, m_tail{&m_stub}
+    { }
+
+    /**
+     * @brief Add a request to the queue. May be called by any thread.
+     *
+     * @param request The request to add.
+     */
+    void Push(Request* request) noexcept
+    {
+        request->next.store(nullptr, std::memory_order_relaxed);
+        Request* prev = m_head.exchange(request, std::memory_order_acq_rel);
+        prev->next.store(request, std::memory_order_release);
+    }
+
+    /**
+     * @brief Remove a request from the queue. May only be called by the
+     * consumer.
+     *
+     * @return Request* The oldest request, or nullptr if the queue is empty,
+     * or a producer hasn't completed its Push() yet.
+     */
+    auto Pop() noexcept -> Request*
+    {
+        Request* tail = m_tail;
+        Request* next = tail->next.load(std::memory_order_acquire);
+        if (tail == &m_stub) {
+            if (next == nullptr) return nullptr;
+            m_tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next != nullptr) {
+            m_tail = next;
+            return tail;
+        }
+
+        Request* head = m_head.load(std::memory_order_acquire);
+        if (tail != head) return nullptr;
+
+        // The tail is the last element. Put the stub behind it, so that the
+        // tail can be returned.
+        Push(&m_stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            m_tail = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+private:
+    Request m_stub{};
+    std::atomic<Request*> m_head;
+    Request* m_tail;
+};
+
+void SetInvalid(CpuIdRegister* registers, std::size_t count) noexcept
+{
+    for (std::size_t i = 0; i < count; i++) {
+        registers[i] = CpuIdRegister{}; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+}
+
+} // namespace
+
+/**
+ * @brief The thread pinned to a single CPU that executes the requests.
+ *
+ */
+class CpuIdNativeEngine::Worker final
+{
+public:
+    explicit Worker(unsigned int cpunum) noexcept
+        : m_cpunum{cpunum}
+    { }
+
+    Worker(const Worker&) = delete;
+    auto operator=(const Worker&) -> Worker& = delete;
+    Worker(Worker&&) = delete;
+    auto operator=(Worker&&) -> Worker& = delete;
+
+    ~Worker()
+    {
+        if (!m_thread.joinable()) return;
+
+        m_stop.store(true);
+        Wake();
+        m_thread.join();
+    }
+
+    /**
+     * @brief Execute the request on the pinned thread, returning when done.
+     *
+     * @param request The request to execute.
+     */
+    void Execute(Request& request) noexcept
+    {
+        std::call_once(m_started, [this]() noexcept {
+            try {
+                m_thread = std::thread{[this]() { Run(); }};
+                m_running = true;
+            } catch (const std::system_error&) {
+                m_running = false;
+            }
+        });
+
+        if (!m_running) {
+            SetInvalid(request.registers, request.count);
+            return;
+        }
+
+        m_queue.Push(&request);
+        Wake();
+
+        // The CPUID instruction is fast, so the result is expected after a
+        // short time. Yielding allows the worker to run if it shares the CPU
+        // with the caller. If the worker is delayed, e.g. its CPU is busy,
+        // block until it is done. The lock is always taken, so the worker has
+        // released it before the request is destroyed.
+        for (unsigned int spin = 0; spin < SpinCount; spin++) {
+            if (request.done.load(std::memory_order_acquire)) break;
+            std::this_thread::yield();
+        }
+        std::unique_lock<std::mutex> lock{request.lock};
+        request.wake.wait(lock, [&request]() { return request.done.load(std::memory_order_acquire); });
+    }
+
+private:
+    void Wake() noexcept
+    {
+        if (m_sleeping.exchange(false)) {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_wake.notify_one();
+        }
+    }
+
+    void Run() noexcept
+    {
+        bool pinned = static_cast<bool>(os::qnx::native::sched::set_affinity(m_cpunum));
+
+        while (true) {
+            Request* request = m_queue.Pop();
+            if (request == nullptr) {
+                std::unique_lock<std::mutex> lock{m_mutex};
+                m_sleeping.store(true);
+
+                // Check again, a producer might have pushed before seeing that
+                // this thread is going to sleep.
+                request = m_queue.Pop();
+                if (request == nullptr) {
+                    if (m_stop.load()) return;
+                    m_wake.wait(lock, [this]() { return !m_sleeping.load(); });
+                    continue;
+                }
+                m_sleeping.store(false);
+            }
+
+            if (pinned) {
+                for (std::size_t i = 0; i < request->count; i++) {
+                    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                    request->registers[i] = CpuIdNative::GetCpuIdCurrentThread(request->queries[i].eax, request->queries[i].ecx);
+                }
+            } else {
+                SetInvalid(request->registers, request->count);
+            }
+
+            // The caller may destroy the request after the lock is released.
+            std::lock_guard<std::mutex> lock{request->lock};
+            request->done.store(true, std::memory_order_release);
+            request->wake.notify_one();
+        }
+    }
+
+    unsigned int m_cpunum;
+    RequestQueue m_queue{};
+    std::mutex m_mutex{};
+    std::condition_variable m_wake{};
+    std::atomic<bool> m_sleeping{false};
+    std::atomic<bool> m_stop{false};
+    std::once_flag m_started{};
+    bool m_running{false};
+    std::thread m_thread{};
+};
+
+CpuIdNativeEngine::CpuIdNativeEngine(unsigned int cpus)
+{
+    m_workers.reserve(cpus);
+    for (unsigned int cpunum = 0; cpunum < cpus; cpunum++) {
+        m_workers.push_back(std::make_unique<Worker>(cpunum));
+    }
+}
+
+CpuIdNativeEngine::~CpuIdNativeEngine() = default;
+
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+void CpuIdNativeEngine::GetCpuId(unsigned int cpunum, const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept
+{
+    if (count == 0) return;
+    if (cpunum >= m_workers.size()) {
+        SetInvalid(registers, count);
+        return;
+    }
+
+    Request request{};
+    request.queries = queries;
+    request.registers = registers;
+    request.count = count;
+    m_workers[cpunum]->Execute(request);
+}
+
+auto CpuIdNativeEngine::Cpus() const noexcept -> unsigned int
+{
+    return static_cast<unsigned int>(m_workers.size());
+}
+
+}
@@ -0,0 +1,75 @@
+#ifndef RJCP_LIB_CPUID_CPUID_NATIVE_ENGINE_H
+#define RJCP_LIB_CPUID_CPUID_NATIVE_ENGINE_H
+
+#include "cpuid/cpuid_query.h"
+#include "cpuid/cpuid_register.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace rjcp::cpuid {
+
+/**
+ * @brief Executes the CPUID instruction on threads that are pinned to each CPU.
+ *
+ * The engine owns one thread per CPU, which is started on the first query for
+ * that CPU and lives until the engine is destroyed. Queries are given to the
+ * thread over a lock-free queue, so that the thread of the caller is never
+ * moved to another CPU.
+ *
+ * The engine may be used from multiple threads concurrently.
+ */
+class CpuIdNativeEngine final
+{
+public:
+    /**
+     * @brief Construct a new CpuId Native Engine object.
+     *
+     * No threads are started until the first query.
+     *
+     * @param cpus The number of CPUs that can be queried.
+     */
+    explicit CpuIdNativeEngine(unsigned int cpus);
+
+    CpuIdNativeEngine(const CpuIdNativeEngine&) = delete;
+    auto operator=(const CpuIdNativeEngine&) -> CpuIdNativeEngine& = delete;
+    CpuIdNativeEngine(CpuIdNativeEngine&&) = delete;
+    auto operator=(CpuIdNativeEngine&&) -> CpuIdNativeEngine& = delete;
+
+    /**
+     * @brief Destroy the CpuId Native Engine object, stopping all threads.
+     *
+     * There must be no queries outstanding.
+     */
+    ~CpuIdNativeEngine();
+
+    /**
+     * @brief Get the CPUID for a list of EAX and ECX registers on a CPU.
+     *
+     * The call blocks until the thread for the CPU has executed all queries.
+     * If the thread for the CPU can't be started, or can't be pinned to the
+     * CPU, all results are invalid.
+     *
+     * @param cpunum The CPU to query.
+     * @param queries The list of count EAX, ECX values to query for.
+     * @param registers The list of count registers to write the results to.
+     * @param count The number of queries.
+     */
+    void GetCpuId(unsigned int cpunum, const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept;
+
+    /**
+     * @brief Get the number of CPUs that can be queried.
+     *
+     * @return unsigned int The number of CPUs.
+     */
+    auto Cpus() const noexcept -> unsigned int;
+
+private:
+    class Worker;
+    std::vector<std::unique_ptr<Worker>> m_workers{};
+};
+
+}
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef RJCP_CPUID_NATIVE_ENGINE_CONFIG_H
+#define RJCP_CPUID_NATIVE_ENGINE_CONFIG_H
+
+#include "cpuid/icpuid_config.h"
+
+namespace rjcp::cpuid {
+
+/**
+ * @brief Configuration for the CpuIdNativeEngineReader class for use with
+ * factories.
+ *
+ * The factory owns a single CpuIdNativeEngine that is shared by all objects it
+ * creates.
+ */
+class CpuIdNativeEngineConfig : public ICpuIdConfig { };
+
+}
+
+#endif
@@ -0,0 +1,24 @@
+#include "cpuid/cpuid_native_engine_reader.h"
+
+#include <utility>
+
+namespace rjcp::cpuid {
+
+CpuIdNativeEngineReader::CpuIdNativeEngineReader(unsigned int cpunum, std::shared_ptr<const CpuIdNativeEngine> engine) noexcept
+    : m_cpunum{cpunum}, m_engine{std::move(engine)}
+{ }
+
+auto CpuIdNativeEngineReader::GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister
+{
+    CpuIdQuery query{eax, ecx};
+    CpuIdRegister cpureg{};
+    GetCpuId(&query, &cpureg, 1);
+    return cpureg;
+}
+
+void CpuIdNativeEngineReader::GetCpuId(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept
+{
+    m_engine->GetCpuId(m_cpunum, queries, registers, count);
+}
+
+}
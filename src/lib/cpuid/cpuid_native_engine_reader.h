@@ -0,0 +1,58 @@
+#ifndef RJCP_LIB_CPUID_CPUID_NATIVE_ENGINE_READER_H
+#define RJCP_LIB_CPUID_CPUID_NATIVE_ENGINE_READER_H
+
+#include "cpuid/icpuid.h"
+#include "cpuid/cpuid_native_engine.h"
+
+#include <memory>
+
+namespace rjcp::cpuid {
+
+/**
+ * @brief Query the CPU using the CPUID instruction on a thread owned by a
+ * CpuIdNativeEngine.
+ *
+ * Unlike CpuIdNative, the thread of the caller is never moved to another CPU.
+ */
+class CpuIdNativeEngineReader final : public ICpuId
+{
+public:
+    /**
+     * @brief Construct a new CpuId Native Engine Reader object.
+     *
+     * @param cpunum The CPU number to configure for.
+     * @param engine The engine that executes the CPUID instruction.
+     */
+    CpuIdNativeEngineReader(unsigned int cpunum, std::shared_ptr<const CpuIdNativeEngine> engine) noexcept;
+
+    /**
+     * @brief Get the CPUID for the given EAX and ECX registers.
+     *
+     * The query is executed by the engine on a thread pinned to the CPU. If
+     * that thread can't be pinned, the result will be invalid.
+     *
+     * @param eax The major leaf (EAX register) to query.
+     * @param ecx The minor leaf (ECX register) to query.
+     * @return CpuIdRegister The result of the query.
+     */
+    auto GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister override;
+
+    /**
+     * @brief Get the CPUID for a list of EAX and ECX registers.
+     *
+     * All queries are given to the engine as a single request.
+     *
+     * @param queries The list of count EAX, ECX values to query for.
+     * @param registers The list of count registers to write the results to.
+     * @param count The number of queries.
+     */
+    void GetCpuId(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept override;
+
+private:
+    unsigned int m_cpunum;
+    std::shared_ptr<const CpuIdNativeEngine> m_engine;
+};
+
+}
+
+#endif
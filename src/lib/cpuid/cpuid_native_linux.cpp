@@ -1,32 +1,112 @@
 #include "cpuid/cpuid_native.h"
+#include "os/qnx/native/sched/sched.h"
 
 #include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
 
 namespace rjcp::cpuid {
 
-auto CpuIdNative::GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister
+namespace {
+
+void FreeCpuSet(void* cpuset) noexcept
+{
+    CPU_FREE(static_cast<cpu_set_t*>(cpuset));
+}
+
+/**
+ * @brief A CPU set per thread to save the affinity while pinned, which only
+ * grows, so that queries don't allocate.
+ */
+class SavedCpuSet
 {
+public:
+    SavedCpuSet() noexcept = default;
+    SavedCpuSet(const SavedCpuSet&) = delete;
+    auto operator=(const SavedCpuSet&) -> SavedCpuSet& = delete;
+    SavedCpuSet(SavedCpuSet&&) = delete;
+    auto operator=(SavedCpuSet&&) -> SavedCpuSet& = delete;
+    ~SavedCpuSet() { if (m_cpuset) CPU_FREE(m_cpuset); }
+
+    auto Get(std::size_t size, unsigned int cpus) noexcept -> cpu_set_t*
+    {
+        if (m_size < size) {
+            cpu_set_t* cpuset = CPU_ALLOC(cpus);
+            if (!cpuset) return nullptr;
+            if (m_cpuset) CPU_FREE(m_cpuset);
+            m_cpuset = cpuset;
+            m_size = size;
+        }
+        return m_cpuset;
+    }
+
+private:
+    cpu_set_t* m_cpuset{};
+    std::size_t m_size{};
+};
+
+}
+
+CpuIdNative::CpuIdNative(unsigned int cpunum) noexcept
+    : m_cpunum(cpunum)
+{
+    // Systems can have more than CPU_SETSIZE CPUs, so the set is sized for the
+    // system, and not constructed again for every query.
+    unsigned int cpus = std::max(os::qnx::native::sched::get_cpuset_cpus(), cpunum + 1);
+    cpu_set_t* cpuset = CPU_ALLOC(cpus);
+    if (!cpuset) return;
+
+    m_cpusetsize = CPU_ALLOC_SIZE(cpus);
+    CPU_ZERO_S(m_cpusetsize, cpuset);
+    CPU_SET_S(cpunum, m_cpusetsize, cpuset);
+    m_cpuset = std::unique_ptr<void, void (*)(void*)>{cpuset, FreeCpuSet};
+}
+
+void CpuIdNative::GetCpuId(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept
+{
+    if (count == 0) return;
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic) - Caller provides count elements
+    thread_local SavedCpuSet saved{};
     pthread_t thread = pthread_self();
-    cpu_set_t current;
-    cpu_set_t cpuset;
+    auto* cpuset = static_cast<const cpu_set_t*>(m_cpuset.get());
+    cpu_set_t* current = cpuset ? saved.Get(m_cpusetsize, static_cast<unsigned int>(m_cpusetsize * 8)) : nullptr;
 
-    if (0 != pthread_getaffinity_np(thread, sizeof(current), &current)) {
+    if (!current || 0 != pthread_getaffinity_np(thread, m_cpusetsize, current)) {
         // Can't set the affinity, so return the default set.
-        return CpuIdRegister{};
+        for (std::size_t i = 0; i < count; i++) registers[i] = CpuIdRegister{};
+        return;
     }
 
-    CPU_ZERO(&cpuset);
-    CPU_SET(m_cpunum, &cpuset);
-    if (0 != pthread_setaffinity_np(thread, sizeof(cpuset), &cpuset)) {
-        // Can't set the affinity, so return the default set.
-        return CpuIdRegister{};
+    if (CPU_EQUAL_S(m_cpusetsize, current, cpuset)) {
+        // The thread is already pinned to only this CPU, e.g. by a worker of
+        // GetCpuId(), so it can't be moved and the affinity isn't changed.
+        for (std::size_t i = 0; i < count; i++) {
+            registers[i] = GetCpuIdCurrentThread(queries[i].eax, queries[i].ecx);
+        }
+        return;
     }
 
-    CpuIdRegister cpureg = GetCpuIdCurrentThread(eax, ecx);
+    if (0 != pthread_setaffinity_np(thread, m_cpusetsize, cpuset)) {
+        // Can't set the affinity, so return the default set.
+        for (std::size_t i = 0; i < count; i++) registers[i] = CpuIdRegister{};
+        return;
+    }
 
-    pthread_setaffinity_np(thread, sizeof(current), &current);
+    // The thread is migrated before the affinity is set. If the OS can tell
+    // the current CPU, check that it did.
+    auto cpu = os::qnx::native::sched::get_cpu();
+    if (cpu && *cpu != m_cpunum) {
+        for (std::size_t i = 0; i < count; i++) registers[i] = CpuIdRegister{};
+    } else {
+        for (std::size_t i = 0; i < count; i++) {
+            registers[i] = GetCpuIdCurrentThread(queries[i].eax, queries[i].ecx);
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
 
-    return cpureg;
+    pthread_setaffinity_np(thread, m_cpusetsize, current);
 }
 
 }
@@ -6,21 +6,29 @@
 
 namespace rjcp::cpuid {
 
-auto CpuIdNative::GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister
+CpuIdNative::CpuIdNative(unsigned int cpunum) noexcept
+    : m_cpunum(cpunum) { }
+
+void CpuIdNative::GetCpuId(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept
 {
+    if (count == 0) return;
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic) - Caller provides count elements
     unsigned int runmask = 1 << m_cpunum;
     int result = ThreadCtl(_NTO_TCTL_RUNMASK_GET_AND_SET, &runmask);
     if (result == -1) {
         // Can't set the affinity, so return the default set.
-        return CpuIdRegister{};
+        for (std::size_t i = 0; i < count; i++) registers[i] = CpuIdRegister{};
+        return;
     }
 
-    CpuIdRegister cpureg = GetCpuIdCurrentThread(eax, ecx);
+    for (std::size_t i = 0; i < count; i++) {
+        registers[i] = GetCpuIdCurrentThread(queries[i].eax, queries[i].ecx);
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
 
     // Restore the thread affinity.
     ThreadCtl(_NTO_TCTL_RUNMASK_GET_AND_SET, &runmask);
-
-    return cpureg;
 }
 
 }
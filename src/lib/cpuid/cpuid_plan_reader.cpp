@@ -0,0 +1,97 @@
+#include "cpuid/cpuid_plan_reader.h"
+
+namespace rjcp::cpuid {
+
+CpuIdPlanReader::CpuIdPlanReader(const ICpuId& cpuid, const std::vector<CpuIdQuery>& plan)
+    : m_cpuid{cpuid}
+{
+    m_queries.reserve(plan.size());
+    if (plan.empty()) return;
+
+    std::vector<CpuIdRegister> registers(plan.size());
+    m_cpuid.GetCpuId(plan.data(), registers.data(), plan.size());
+
+    // Invalid results aren't stored, so they're queried again if needed.
+    m_results.Reserve(plan.size());
+    for (const auto& reg : registers) {
+        m_results.AddLeaf(reg);
+    }
+}
+
+auto CpuIdPlanReader::GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister
+{
+    RecordQuery(CpuIdQuery{eax, ecx});
+
+    auto result = m_results.FindLeaf(eax, ecx);
+    if (result != nullptr) return *result;
+
+    m_misses++;
+    return m_cpuid.GetCpuId(eax, ecx);
+}
+
+void CpuIdPlanReader::GetCpuId(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept
+{
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    std::size_t misses = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        RecordQuery(queries[i]);
+
+        auto result = m_results.FindLeaf(queries[i].eax, queries[i].ecx);
+        if (result != nullptr) {
+            registers[i] = *result;
+        } else {
+            registers[i] = CpuIdRegister{};
+            misses++;
+        }
+    }
+    if (misses == 0) return;
+
+    m_misses += misses;
+    try {
+        std::vector<CpuIdQuery> missed{};
+        std::vector<std::size_t> positions{};
+        missed.reserve(misses);
+        positions.reserve(misses);
+        for (std::size_t i = 0; i < count; i++) {
+            if (!registers[i].IsValid()) {
+                missed.push_back(queries[i]);
+                positions.push_back(i);
+            }
+        }
+
+        std::vector<CpuIdRegister> results(misses);
+        m_cpuid.GetCpuId(missed.data(), results.data(), misses);
+        for (std::size_t i = 0; i < misses; i++) {
+            registers[positions[i]] = results[i];
+        }
+    } catch (...) {
+        // Without memory for the batch, query the misses one at a time.
+        for (std::size_t i = 0; i < count; i++) {
+            if (!registers[i].IsValid()) {
+                registers[i] = m_cpuid.GetCpuId(queries[i].eax, queries[i].ecx);
+            }
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+void CpuIdPlanReader::RecordQuery(const CpuIdQuery& query) const noexcept
+{
+    try {
+        m_queries.push_back(query);
+    } catch (...) {
+        // The query isn't recorded, so the next plan only misses it.
+    }
+}
+
+auto CpuIdPlanReader::Queries() const noexcept -> const std::vector<CpuIdQuery>&
+{
+    return m_queries;
+}
+
+auto CpuIdPlanReader::Misses() const noexcept -> std::size_t
+{
+    return m_misses;
+}
+
+}
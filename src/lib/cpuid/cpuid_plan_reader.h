@@ -0,0 +1,88 @@
+#ifndef RJCP_LIB_CPUID_CPUID_PLAN_READER_H
+#define RJCP_LIB_CPUID_CPUID_PLAN_READER_H
+
+#include "cpuid/icpuid.h"
+#include "cpuid/tree/cpuid_processor.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace rjcp::cpuid {
+
+/**
+ * @brief Query a CPU by executing a known list of queries as a single batch.
+ *
+ * When enumerating many CPUs, the same queries are usually made for every CPU.
+ * The queries made for one CPU are a plan for the next CPU. This reader
+ * executes the plan on construction as a single batch, and then answers
+ * queries from those results. A query that isn't in the plan (e.g. the CPU has
+ * a different structure) is made on the CPU directly.
+ *
+ * All queries are recorded, so that they can be used as the plan for the next
+ * CPU.
+ */
+class CpuIdPlanReader final : public ICpuId
+{
+public:
+    /**
+     * @brief Construct a new CpuId Plan Reader object.
+     *
+     * @param cpuid The CPUID object to query. It must exist for the lifetime
+     * of this object.
+     * @param plan The queries to make in advance. It may be empty, in which
+     * case all queries are made directly and only recorded.
+     */
+    CpuIdPlanReader(const ICpuId& cpuid, const std::vector<CpuIdQuery>& plan);
+
+    /**
+     * @brief Get the CPUID for the given EAX and ECX registers.
+     *
+     * @param eax The major leaf (EAX register) to query.
+     * @param ecx The minor leaf (ECX register) to query.
+     * @return CpuIdRegister The result from the plan, else the result of
+     * querying the CPU.
+     */
+    auto GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister override;
+
+    /**
+     * @brief Get the CPUID for a list of EAX and ECX registers.
+     *
+     * Queries that are not in the plan are given to the CPU as a single batch.
+     *
+     * @param queries The list of count EAX, ECX values to query for.
+     * @param registers The list of count registers to write the results to.
+     * @param count The number of queries.
+     */
+    void GetCpuId(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept override;
+
+    /**
+     * @brief Get the queries made on this object, in order.
+     *
+     * @return const std::vector<CpuIdQuery>& The queries made.
+     */
+    auto Queries() const noexcept -> const std::vector<CpuIdQuery>&;
+
+    /**
+     * @brief Get the number of queries that were not in the plan.
+     *
+     * @return std::size_t The number of queries made directly on the CPU.
+     */
+    auto Misses() const noexcept -> std::size_t;
+
+private:
+    /**
+     * @brief Record a query for the next plan, ignoring allocation failures.
+     *
+     * @param query The query that was made.
+     */
+    void RecordQuery(const CpuIdQuery& query) const noexcept;
+
+    const ICpuId& m_cpuid;
+    tree::CpuIdProcessor m_results{};
+    mutable std::vector<CpuIdQuery> m_queries{};
+    mutable std::size_t m_misses{0};
+};
+
+}
+
+#endif
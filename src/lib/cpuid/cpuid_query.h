@@ -0,0 +1,28 @@
+#ifndef RJCP_LIB_CPUID_CPUID_QUERY_H
+#define RJCP_LIB_CPUID_CPUID_QUERY_H
+
+#include <cstdint>
+
+namespace rjcp::cpuid {
+
+/**
+ * @brief The input registers for a single execution of the CPUID instruction.
+ *
+ */
+struct CpuIdQuery {
+    /**
+     * @brief The major leaf (EAX register) to query.
+     *
+     */
+    std::uint32_t eax;
+
+    /**
+     * @brief The minor leaf (ECX register) to query.
+     *
+     */
+    std::uint32_t ecx;
+};
+
+}
+
+#endif
@@ -5,12 +5,16 @@ namespace rjcp::cpuid {
 constexpr std::uint32_t Invalid = 0xFFFFFFFF;
 
 CpuIdRegister::CpuIdRegister() noexcept
-    : m_InEax{Invalid}, m_InEcx{Invalid}, m_Eax(0), m_Ebx(0), m_Ecx(0), m_Edx(0), m_IsValid{false}
+    : m_InEax{Invalid}, m_InEcx{Invalid}, m_Value{0, 0, 0, 0}, m_IsValid{false}
 { }
 
 // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
 CpuIdRegister::CpuIdRegister(std::uint32_t ieax, std::uint32_t iecx, std::uint32_t eax, std::uint32_t ebx, std::uint32_t ecx, std::uint32_t edx) noexcept
-    : m_InEax{ieax}, m_InEcx{iecx}, m_Eax(eax), m_Ebx(ebx), m_Ecx(ecx), m_Edx(edx), m_IsValid{true}
+    : m_InEax{ieax}, m_InEcx{iecx}, m_Value{eax, ebx, ecx, edx}, m_IsValid{true}
+{ }
+
+CpuIdRegister::CpuIdRegister(std::uint32_t ieax, std::uint32_t iecx, const CpuIdValue& value) noexcept
+    : m_InEax{ieax}, m_InEcx{iecx}, m_Value{value}, m_IsValid{true}
 { }
 
 auto CpuIdRegister::InEax() const noexcept -> std::uint32_t
@@ -25,22 +29,27 @@ auto CpuIdRegister::InEcx() const noexcept -> std::uint32_t
 
 auto CpuIdRegister::Eax() const noexcept -> std::uint32_t
 {
-    return m_Eax;
+    return m_Value.eax;
 }
 
 auto CpuIdRegister::Ebx() const noexcept -> std::uint32_t
 {
-    return m_Ebx;
+    return m_Value.ebx;
 }
 
 auto CpuIdRegister::Ecx() const noexcept -> std::uint32_t
 {
-    return m_Ecx;
+    return m_Value.ecx;
 }
 
 auto CpuIdRegister::Edx() const noexcept -> std::uint32_t
 {
-    return m_Edx;
+    return m_Value.edx;
+}
+
+auto CpuIdRegister::Value() const noexcept -> CpuIdValue
+{
+    return m_Value;
 }
 
 auto CpuIdRegister::IsValid() const noexcept -> bool
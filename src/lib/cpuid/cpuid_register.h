@@ -1,6 +1,8 @@
 #ifndef RJCP_LIB_CPUID_CPUID_REGISTER_H
 #define RJCP_LIB_CPUID_CPUID_REGISTER_H
 
+#include "cpuid/cpuid_value.h"
+
 #include <cstdint>
 
 namespace rjcp::cpuid {
@@ -30,6 +32,15 @@ public:
      */
     CpuIdRegister(std::uint32_t ieax, std::uint32_t iecx, std::uint32_t eax, std::uint32_t ebx, std::uint32_t ecx, std::uint32_t edx) noexcept;
 
+    /**
+     * @brief Construct a new Cpu Id Register object from the compact result.
+     *
+     * @param ieax The input EAX register
+     * @param iecx The input ECX register
+     * @param value The result of the CPUID instruction.
+     */
+    CpuIdRegister(std::uint32_t ieax, std::uint32_t iecx, const CpuIdValue& value) noexcept;
+
     /**
      * @brief Indicates if the register data is valid.
      *
@@ -83,13 +94,17 @@ public:
      */
     auto Edx() const noexcept -> std::uint32_t;
 
+    /**
+     * @brief The result of the CPUID instruction in its compact form.
+     *
+     * @return CpuIdValue The EAX, EBX, ECX and EDX registers.
+     */
+    auto Value() const noexcept -> CpuIdValue;
+
 private:
     std::uint32_t m_InEax;
     std::uint32_t m_InEcx;
-    std::uint32_t m_Eax;
-    std::uint32_t m_Ebx;
-    std::uint32_t m_Ecx;
-    std::uint32_t m_Edx;
+    CpuIdValue m_Value;
     bool m_IsValid;
 };
 
@@ -0,0 +1,84 @@
+#include "cpuid/cpuid_system.h"
+#include "cpuid/cpuid_device_config.h"
+#include "cpuid/cpuid_factory.h"
+#include "cpuid/cpuid_native_config.h"
+#include "cpuid/tree/cpuid_write_snapshot.h"
+
+#include <mutex>
+#include <stdexcept>
+
+namespace rjcp::cpuid {
+
+namespace {
+
+std::once_flag g_system_once{};
+std::mutex g_system_mutex{};
+CpuIdSystemOptions g_system_options{};
+bool g_system_started{};
+std::unique_ptr<const CpuIdSystem> g_system{};
+
+auto CreateCpuIdSystem(const CpuIdSystemOptions& options) -> std::unique_ptr<const CpuIdSystem>
+{
+    GetCpuIdOptions getOptions{options.workers};
+    if (options.reader == CpuIdSystemReader::device) {
+        // The device is read from any CPU, so the workers aren't pinned.
+        auto factory = CreateCpuIdFactory(CpuIdDeviceConfig{});
+        if (factory) {
+            auto system = std::make_unique<const CpuIdSystem>(*factory, GetCpuIdOptions{options.workers, false, false});
+
+            // Without the device driver, every read fails, and each CPU is
+            // recorded without results, so the snapshot isn't empty.
+            if (system->HasResults()) return system;
+        }
+    }
+
+    auto factory = CreateCpuIdFactory(CpuIdNativeConfig{});
+    if (!factory) throw std::runtime_error{"CpuIdSystem: the native CPUID factory couldn't be created"};
+    return std::make_unique<const CpuIdSystem>(*factory, getOptions);
+}
+
+}
+
+auto CpuIdSystem::Configure(const CpuIdSystemOptions& options) -> bool
+{
+    std::lock_guard<std::mutex> lock{g_system_mutex};
+    if (g_system_started) return false;
+    g_system_options = options;
+    return true;
+}
+
+auto CpuIdSystem::Get() -> const CpuIdSystem&
+{
+    // If the enumeration throws, the next call tries again, and the options
+    // can still be changed until then.
+    std::call_once(g_system_once, []() {
+        CpuIdSystemOptions options{};
+        {
+            std::lock_guard<std::mutex> lock{g_system_mutex};
+            options = g_system_options;
+        }
+        auto system = CreateCpuIdSystem(options);
+
+        std::lock_guard<std::mutex> lock{g_system_mutex};
+        g_system = std::move(system);
+        g_system_started = true;
+    });
+    return *g_system;
+}
+
+auto CpuIdSystem::HasResults() const noexcept -> bool
+{
+    for (std::size_t pos = 0; pos < m_snapshot->Size(); pos++) {
+        if (m_snapshot->GetProcessorAt(pos).Size() != 0) return true;
+    }
+    return false;
+}
+
+CpuIdSystem::CpuIdSystem(ICpuIdFactory& factory, const GetCpuIdOptions& options)
+{
+    auto tree = GetCpuId(factory, options);
+    m_snapshot = tree::CpuIdSnapshot::Open(tree::GetCpuIdSnapshot(*tree));
+    if (!m_snapshot) throw std::runtime_error{"CpuIdSystem: the snapshot of the CPUs couldn't be opened"};
+}
+
+}
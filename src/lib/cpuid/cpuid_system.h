@@ -0,0 +1,160 @@
+#ifndef RJCP_LIB_CPUID_CPUID_SYSTEM_H
+#define RJCP_LIB_CPUID_CPUID_SYSTEM_H
+
+#include "cpuid/get_cpuid.h"
+#include "cpuid/icpuid_factory.h"
+#include "cpuid/tree/cpuid_register_ptr.h"
+#include "cpuid/tree/cpuid_snapshot.h"
+#include "cpuid/tree/cpuid_snapshot_processor.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace rjcp::cpuid {
+
+/**
+ * @brief The reader used to enumerate the CPUs of the system.
+ */
+enum class CpuIdSystemReader
+{
+    /**
+     * @brief Use the CPUID instruction, pinning the thread to each CPU.
+     */
+    native,
+
+    /**
+     * @brief Use the device /dev/cpu/N/cpuid, falling back to the native
+     * reader if the device isn't available.
+     */
+    device
+};
+
+/**
+ * @brief Options on how CpuIdSystem::Get() enumerates the CPUs.
+ */
+class CpuIdSystemOptions
+{
+public:
+    explicit CpuIdSystemOptions(CpuIdSystemReader reader = CpuIdSystemReader::native, unsigned int workers = 1)
+        : reader{reader}, workers{workers}
+    { }
+
+    /**
+     * @brief The reader used to enumerate the CPUs.
+     */
+    CpuIdSystemReader reader;
+
+    /**
+     * @brief The maximum number of threads that enumerate CPUs concurrently.
+     *
+     * See GetCpuIdOptions::workers. The workers are only pinned to the CPUs
+     * for the native reader.
+     */
+    unsigned int workers;
+};
+
+/**
+ * @brief An immutable snapshot of the CPUID information for all CPUs.
+ *
+ * The system snapshot returned by Get() is enumerated once on first use and
+ * then shared by all consumers in the process. The snapshot never changes, so
+ * all methods are thread safe and don't take locks.
+ */
+class CpuIdSystem final
+{
+public:
+    /**
+     * @brief Set how the system snapshot is enumerated.
+     *
+     * This must be called before the first call to Get(), e.g. at the start of
+     * main(), and has no effect afterwards.
+     *
+     * @param options The options on how to enumerate the CPUs.
+     * @return true if the options are used.
+     * @return false if the system snapshot was already enumerated.
+     */
+    static auto Configure(const CpuIdSystemOptions& options) -> bool;
+
+    /**
+     * @brief Get the system snapshot, enumerating all CPUs on first use.
+     *
+     * Concurrent calls on first use wait for the single enumeration to
+     * complete. If the enumeration throws, the exception is given to the
+     * caller, and the next call enumerates again.
+     *
+     * @return const CpuIdSystem& The system snapshot, valid until the end of
+     * the process.
+     */
+    static auto Get() -> const CpuIdSystem&;
+
+    /**
+     * @brief Enumerate all CPUs of the factory into a new snapshot.
+     *
+     * @param factory The factory to create the CPUID object for each CPU.
+     * @param options The options on how to enumerate the CPUs.
+     * @throws std::runtime_error The snapshot of the CPUs couldn't be opened,
+     * e.g. a CPU number is larger than the snapshot supports.
+     */
+    CpuIdSystem(ICpuIdFactory& factory, const GetCpuIdOptions& options = GetCpuIdOptions{});
+
+    /**
+     * @brief Get the snapshot of all CPUs.
+     *
+     * @return const std::shared_ptr<const tree::CpuIdSnapshot>& The snapshot.
+     */
+    auto GetSnapshot() const noexcept -> const std::shared_ptr<const tree::CpuIdSnapshot>& {
+        return m_snapshot;
+    }
+
+    /**
+     * @brief Get the number of CPUs in the snapshot.
+     *
+     * @return std::size_t The number of CPUs.
+     */
+    auto Size() const noexcept -> std::size_t {
+        return m_snapshot->Size();
+    }
+
+    /**
+     * @brief Check if any CPU in the snapshot has results.
+     *
+     * A CPU that couldn't be read (e.g. the device driver isn't loaded) is in
+     * the snapshot without any leaves. If no CPU could be read, the snapshot
+     * isn't empty, but has no results.
+     *
+     * @return true if at least one CPU has leaves.
+     */
+    auto HasResults() const noexcept -> bool;
+
+    /**
+     * @brief Get the CPU with the given CPU number.
+     *
+     * @param cpu The CPU number.
+     * @return tree::CpuIdSnapshotProcessor The view of the CPU, which is false
+     * if the CPU doesn't exist.
+     */
+    auto GetProcessor(unsigned int cpu) const noexcept -> tree::CpuIdSnapshotProcessor {
+        return m_snapshot->GetProcessor(cpu);
+    }
+
+    /**
+     * @brief Get the leaf of a CPU.
+     *
+     * @param cpu The CPU number.
+     * @param eax The input EAX value.
+     * @param ecx The input ECX value.
+     * @return tree::CpuIdRegisterPtr The register, or nullptr if it doesn't
+     * exist.
+     */
+    auto GetLeaf(unsigned int cpu, std::uint32_t eax, std::uint32_t ecx) const noexcept -> tree::CpuIdRegisterPtr {
+        return m_snapshot->GetProcessor(cpu).GetLeaf(eax, ecx);
+    }
+
+private:
+    std::shared_ptr<const tree::CpuIdSnapshot> m_snapshot;
+};
+
+}
+
+#endif
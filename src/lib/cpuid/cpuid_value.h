@@ -0,0 +1,52 @@
+#ifndef RJCP_LIB_CPUID_CPUID_VALUE_H
+#define RJCP_LIB_CPUID_CPUID_VALUE_H
+
+#include <cstdint>
+
+namespace rjcp::cpuid {
+
+/**
+ * @brief The output registers of the CPUID instruction.
+ *
+ * This is the compact form of the result, without the input registers, for
+ * storing many results where the input is already known (e.g. it is the key of
+ * a container).
+ */
+struct CpuIdValue {
+    std::uint32_t eax;   ///< The result of the CPUID instruction EAX register.
+    std::uint32_t ebx;   ///< The result of the CPUID instruction EBX register.
+    std::uint32_t ecx;   ///< The result of the CPUID instruction ECX register.
+    std::uint32_t edx;   ///< The result of the CPUID instruction EDX register.
+};
+
+static_assert(sizeof(CpuIdValue) == 16, "CpuIdValue must be packed to 16 bytes");
+
+/**
+ * @brief Compare two CPUID results.
+ *
+ * @param lhs The left hand side to compare.
+ * @param rhs The right hand side to compare.
+ * @return true All four registers are the same.
+ * @return false At least one register is different.
+ */
+inline auto operator==(const CpuIdValue& lhs, const CpuIdValue& rhs) noexcept -> bool
+{
+    return lhs.eax == rhs.eax && lhs.ebx == rhs.ebx && lhs.ecx == rhs.ecx && lhs.edx == rhs.edx;
+}
+
+/**
+ * @brief Compare two CPUID results.
+ *
+ * @param lhs The left hand side to compare.
+ * @param rhs The right hand side to compare.
+ * @return true At least one register is different.
+ * @return false All four registers are the same.
+ */
+inline auto operator!=(const CpuIdValue& lhs, const CpuIdValue& rhs) noexcept -> bool
+{
+    return !(lhs == rhs);
+}
+
+}
+
+#endif
@@ -1,4 +1,18 @@
 #include "cpuid/get_cpuid.h"
+#include "cpuid/cpuid_plan_reader.h"
+#include "cpuid/tree/cpuid_tree_sink.h"
+#include "os/qnx/native/sched/sched.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
 
 namespace rjcp::cpuid {
 
@@ -15,49 +29,360 @@ void GetCpuIdIntelExtended(ICpuId& cpuid, tree::CpuIdProcessor& processor);
 void GetCpuIdHypervisor(ICpuId& cpuid, tree::CpuIdProcessor& processor);
 void GetCpuIdRegion(ICpuId& cpuid, tree::CpuIdProcessor& processor, std::uint32_t region);
 
+// The maximum number of queries given to ICpuId::GetCpuId at once, so that the
+// buffers can be kept on the stack.
+constexpr std::size_t BatchSize = 256;
+
+// The number of registers to reserve per CPU. Most CPUs have fewer leaves than
+// this, so the processor is built with a single allocation.
+constexpr std::size_t ReserveLeafs = 256;
+
+/**
+ * @brief Query a consecutive range of subleafs for a leaf as batches.
+ *
+ * @tparam Callback The type of callback.
+ * @param cpuid The CPUID object to get the CPUID information.
+ * @param leaf The leaf (EAX register) to query.
+ * @param first The first subleaf (ECX register) to query.
+ * @param last The last subleaf (ECX register) to query, inclusive.
+ * @param callback Called for each subleaf in order as `callback(subleaf,
+ * reg)`.
+ */
+template<typename Callback>
+void GetCpuIdSubleafs(ICpuId& cpuid, std::uint32_t leaf, std::uint32_t first, std::uint32_t last, Callback&& callback)
+{
+    std::array<CpuIdQuery, BatchSize> queries{};
+    std::array<CpuIdRegister, BatchSize> registers{};
+
+    std::uint64_t subleaf = first;
+    while (subleaf <= last) {
+        std::size_t count = 0;
+        while (count < BatchSize && subleaf + count <= last) {
+            queries.at(count) = CpuIdQuery{leaf, static_cast<std::uint32_t>(subleaf + count)};
+            count++;
+        }
+
+        cpuid.GetCpuId(queries.data(), registers.data(), count);
+        for (std::size_t i = 0; i < count; i++) {
+            callback(queries.at(i).ecx, registers.at(i));
+        }
+        subleaf += count;
+    }
+}
+
+/**
+ * @brief Query subleaf zero of a consecutive range of leafs as batches.
+ *
+ * @tparam Callback The type of callback.
+ * @param cpuid The CPUID object to get the CPUID information.
+ * @param first The first leaf (EAX register) to query.
+ * @param last The last leaf (EAX register) to query, inclusive.
+ * @param callback Called for each leaf in order as `callback(leaf, reg)`.
+ */
+template<typename Callback>
+void GetCpuIdLeafs(ICpuId& cpuid, std::uint32_t first, std::uint32_t last, Callback&& callback)
+{
+    std::array<CpuIdQuery, BatchSize> queries{};
+    std::array<CpuIdRegister, BatchSize> registers{};
+
+    std::uint64_t leaf = first;
+    while (leaf <= last) {
+        std::size_t count = 0;
+        while (count < BatchSize && leaf + count <= last) {
+            queries.at(count) = CpuIdQuery{static_cast<std::uint32_t>(leaf + count), 0};
+            count++;
+        }
+
+        cpuid.GetCpuId(queries.data(), registers.data(), count);
+        for (std::size_t i = 0; i < count; i++) {
+            callback(queries.at(i).eax, registers.at(i));
+        }
+        leaf += count;
+    }
+}
+
+/**
+ * @brief Get all CPUID registers for a single CPU.
+ *
+ * @param cpuid The CPUID object to get the CPUID information.
+ * @return tree::CpuIdProcessor The registers for the CPU. It is empty if the
+ * CPU couldn't be queried.
+ */
+auto GetCpuIdProcessor(ICpuId& cpuid) -> tree::CpuIdProcessor
+{
+    auto reg = cpuid.GetCpuId(0, 0);
+    tree::CpuIdProcessor processor{};
+    if (!reg.IsValid()) {
+        // Couldn't get the CPU, so show that it is empty.
+        return processor;
+    }
+    processor.Reserve(ReserveLeafs);
+    processor.AddLeaf(reg);
+
+    CpuType type = CpuType::VENDOR_UNKNOWN;
+    if (reg.Ebx() == 0x756E6547 && reg.Ecx() == 0x6C65746E && reg.Edx() == 0x49656E69) {
+        // GenuineIntel
+        type = CpuType::VENDOR_INTEL;
+    } else if (reg.Ebx() == 0x68747541 && reg.Ecx() == 0x444d4163 && reg.Edx() == 0x69746E65) {
+        // AuthenticAMD
+        type = CpuType::VENDOR_AMD;
+    }
+
+    switch (type) {
+    case CpuType::VENDOR_INTEL:
+    case CpuType::VENDOR_AMD:
+        GetCpuIdIntelStandard(cpuid, processor);
+        GetCpuIdIntelExtended(cpuid, processor);
+        GetCpuIdHypervisor(cpuid, processor);
+        break;
+    default:
+        GetCpuIdStandard(cpuid, processor);
+        break;
+    }
+
+    return processor;
+}
+
+/**
+ * @brief The queries made to enumerate a CPU, to be made in advance for the
+ * next CPU.
+ */
+using CpuIdPlan = std::shared_ptr<const std::vector<CpuIdQuery>>;
+
+/**
+ * @brief Get all CPUID registers for a single CPU using a plan.
+ *
+ * The queries in the plan are made as a single batch, and the enumeration
+ * answered from those results. If the CPU needs queries that aren't in the
+ * plan (e.g. it has a different maximum leaf, vendor, or number of subleafs,
+ * such as on a hybrid CPU) the plan is replaced with the queries made for this
+ * CPU.
+ *
+ * @param cpuid The CPUID object to get the CPUID information.
+ * @param plan The plan to use, which is updated if the CPU is different. It
+ * may be nullptr for the first CPU.
+ * @return tree::CpuIdProcessor The registers for the CPU. It is empty if the
+ * CPU couldn't be queried.
+ */
+auto GetCpuIdProcessor(ICpuId& cpuid, CpuIdPlan& plan) -> tree::CpuIdProcessor
+{
+    static const std::vector<CpuIdQuery> noplan{};
+
+    CpuIdPlanReader reader{cpuid, plan ? *plan : noplan};
+    auto processor = GetCpuIdProcessor(reader);
+
+    // Don't learn from a CPU that couldn't be read.
+    if (!processor.IsEmpty() && (!plan || reader.Misses() > 0)) {
+        plan = std::make_shared<const std::vector<CpuIdQuery>>(reader.Queries());
+    }
+    return processor;
+}
+
+/**
+ * @brief Record the CPUs before the next CPU that can't be queried as
+ * disallowed.
+ *
+ * @param sink The sink to receive the results.
+ * @param next The next CPU number to give to the sink, updated to cpunum.
+ * @param cpunum The CPU number about to be given to the sink, or the number of
+ * threads after the last CPU.
+ */
+void GetCpuIdSkipped(ICpuIdSink& sink, unsigned int& next, unsigned int cpunum)
+{
+    for (; next < cpunum; next++) {
+        sink.Disallowed(next);
+    }
+}
+
+/**
+ * @brief Query the CPUs sequentially on the current thread.
+ *
+ * @param factory The factory to create the CPUID object for each CPU.
+ * @param cpus The CPUs to query, from ICpuIdFactory::cpus().
+ * @param sink The sink to receive the results.
+ */
+void GetCpuIdSequential(ICpuIdFactory& factory, const std::vector<unsigned int>& cpus, ICpuIdSink& sink)
+{
+    CpuIdPlan plan{};
+    unsigned int next = 0;
+    bool failed = false;
+
+    sink.Begin();
+    for (unsigned int cpunum : cpus) {
+        auto cpuid = factory.create(cpunum);
+        if (!cpuid) {
+            failed = true;
+            break;
+        }
+
+        GetCpuIdSkipped(sink, next, cpunum);
+        sink.Processor(cpunum, GetCpuIdProcessor(*cpuid, plan));
+        next = cpunum + 1;
+    }
+    if (!failed) GetCpuIdSkipped(sink, next, factory.threads());
+    sink.End();
+}
+
+void GetCpuId(ICpuIdFactory& factory, ICpuIdSink& sink)
+{
+    GetCpuIdSequential(factory, factory.cpus(), sink);
+}
+
 auto GetCpuId(ICpuIdFactory& factory) -> std::unique_ptr<tree::CpuIdTree>
 {
     auto tree = std::make_unique<tree::CpuIdTree>();
+    tree::CpuIdTreeSink sink{*tree};
+    GetCpuId(factory, sink);
+    return tree;
+}
+
+/**
+ * @brief Query all CPUs with a pool of worker threads.
+ *
+ * The processors are given to the sink on the calling thread in CPU order, as
+ * soon as the next CPU is enumerated.
+ *
+ * @param factory The factory to create the CPUID object for each CPU.
+ * @param cpus The CPUs to query, from ICpuIdFactory::cpus().
+ * @param workers The number of worker threads.
+ * @param pin If the worker threads are pinned to the CPU being enumerated.
+ * @param sink The sink to receive the results.
+ */
+void GetCpuIdParallel(ICpuIdFactory& factory, const std::vector<unsigned int>& cpus, unsigned int workers, bool pin, ICpuIdSink& sink)
+{
+    std::size_t count = cpus.size();
 
-    unsigned int threads = factory.threads();
+    // Each CPU is enumerated independently into its own slot, in the order of
+    // the list. A CPU that couldn't be created is marked as failed, which ends
+    // the output as for the sequential enumeration. An exception while
+    // enumerating a CPU is kept in its slot and rethrown on the calling thread.
+    enum class SlotState { PENDING, DONE, FAILED, EXCEPTION };
+    std::vector<tree::CpuIdProcessor> processors(count);
+    std::vector<std::exception_ptr> errors(count);
+    std::vector<SlotState> states(count, SlotState::PENDING);
+    std::mutex slotlock{};
+    std::condition_variable slotready{};
+    std::atomic<std::size_t> next{0};
 
-    for (unsigned int cpunum = 0; cpunum < threads; cpunum++) {
-        auto cpuid = factory.create(cpunum);
-        if (!cpuid) return tree;
-
-        auto reg = cpuid->GetCpuId(0, 0);
-        tree::CpuIdProcessor processor{};
-        if (!reg.IsValid()) {
-            // Couldn't get the CPU, so show that it is empty.
-            tree->SetProcessor(cpunum, std::move(processor));
-            continue;
+    // The plan is shared by all workers, the latest one found is used.
+    std::mutex planlock{};
+    CpuIdPlan sharedplan{};
+
+    auto worker = [&]() {
+        std::size_t slot = next.fetch_add(1);
+        while (slot < count) {
+            unsigned int cpunum = cpus[slot];
+            SlotState state = SlotState::FAILED;
+            tree::CpuIdProcessor processor{};
+            std::exception_ptr error{};
+            try {
+                auto cpuid = factory.create(cpunum);
+                if (cpuid) {
+                    CpuIdPlan plan{};
+                    {
+                        std::lock_guard<std::mutex> lock{planlock};
+                        plan = sharedplan;
+                    }
+                    CpuIdPlan previous = plan;
+
+                    // If pinning fails, the CPUID object still gets the correct
+                    // results, e.g. the native reader moves the thread itself.
+                    if (pin) os::qnx::native::sched::set_affinity(cpunum);
+                    processor = GetCpuIdProcessor(*cpuid, plan);
+                    state = SlotState::DONE;
+
+                    if (plan != previous) {
+                        std::lock_guard<std::mutex> lock{planlock};
+                        sharedplan = plan;
+                    }
+                }
+            } catch (...) {
+                error = std::current_exception();
+                state = SlotState::EXCEPTION;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock{slotlock};
+                processors[slot] = std::move(processor);
+                errors[slot] = std::move(error);
+                states[slot] = state;
+            }
+            slotready.notify_all();
+            slot = next.fetch_add(1);
         }
-        processor.AddLeaf(reg);
-
-        CpuType type = CpuType::VENDOR_UNKNOWN;
-        if (reg.Ebx() == 0x756E6547 && reg.Ecx() == 0x6C65746E && reg.Edx() == 0x49656E69) {
-            // GenuineIntel
-            type = CpuType::VENDOR_INTEL;
-        } else if (reg.Ebx() == 0x68747541 && reg.Ecx() == 0x444d4163 && reg.Edx() == 0x69746E65) {
-            // AuthenticAMD
-            type = CpuType::VENDOR_AMD;
+    };
+
+    std::vector<std::thread> pool{};
+    pool.reserve(workers);
+    try {
+        for (unsigned int i = 0; i < workers; i++) {
+            pool.emplace_back(worker);
         }
+    } catch (const std::system_error&) {
+        // Continue with the threads that could be started.
+    }
+    if (pool.empty()) {
+        GetCpuIdSequential(factory, cpus, sink);
+        return;
+    }
 
-        switch (type) {
-        case CpuType::VENDOR_INTEL:
-        case CpuType::VENDOR_AMD:
-            GetCpuIdIntelStandard(*cpuid, processor);
-            GetCpuIdIntelExtended(*cpuid, processor);
-            GetCpuIdHypervisor(*cpuid, processor);
-            break;
-        default:
-            GetCpuIdStandard(*cpuid, processor);
-            break;
+    auto join = [&pool]() {
+        for (auto& thread : pool) {
+            thread.join();
         }
+    };
+
+    try {
+        unsigned int nextcpu = 0;
+        bool failed = false;
+        sink.Begin();
+        for (std::size_t slot = 0; slot < count; slot++) {
+            tree::CpuIdProcessor processor{};
+            {
+                std::unique_lock<std::mutex> lock{slotlock};
+                slotready.wait(lock, [&states, slot]() { return states[slot] != SlotState::PENDING; });
+                if (states[slot] == SlotState::EXCEPTION) std::rethrow_exception(errors[slot]);
+                if (states[slot] == SlotState::FAILED) {
+                    failed = true;
+                    break;
+                }
+                processor = std::move(processors[slot]);
+            }
+            GetCpuIdSkipped(sink, nextcpu, cpus[slot]);
+            sink.Processor(cpus[slot], processor);
+            nextcpu = cpus[slot] + 1;
+        }
+        if (!failed) GetCpuIdSkipped(sink, nextcpu, factory.threads());
+        sink.End();
+    } catch (...) {
+        // Stop the workers from starting on more CPUs.
+        next.store(count);
+        join();
+        throw;
+    }
+
+    // Workers may still be enumerating CPUs after a failed CPU.
+    next.store(count);
+    join();
+}
 
-        tree->SetProcessor(cpunum, std::move(processor));
+void GetCpuId(ICpuIdFactory& factory, const GetCpuIdOptions& options, ICpuIdSink& sink)
+{
+    std::vector<unsigned int> cpus = factory.cpus();
+    auto workers = static_cast<unsigned int>(std::min<std::size_t>(options.workers, cpus.size()));
+    if (workers <= 1) {
+        GetCpuIdSequential(factory, cpus, sink);
+    } else {
+        GetCpuIdParallel(factory, cpus, workers, options.pin, sink);
     }
+}
 
+auto GetCpuId(ICpuIdFactory& factory, const GetCpuIdOptions& options) -> std::unique_ptr<tree::CpuIdTree>
+{
+    auto tree = std::make_unique<tree::CpuIdTree>();
+    tree::CpuIdTreeSink sink{*tree};
+    GetCpuId(factory, options, sink);
+    if (options.intern) tree->Intern();
     return tree;
 }
 
@@ -67,21 +392,30 @@ auto GetCpuId(ICpuIdFactory& factory) -> std::unique_ptr<tree::CpuIdTree>
  * When comparing Intel with AMD, they don't overlap, so while the bits have
  * different meanings in some cases, the same algorithm works for both.
  *
+ * Subleaf zero of all leafs is queried as a batch first. Subleafs are queried
+ * as a batch when the number of subleafs is known in advance.
+ *
  * @param cpuid The CPUID object to get the CPUID information.
  * @param processor The tree to put the CPUID information after the query.
  */
 void GetCpuIdIntelStandard(ICpuId& cpuid, tree::CpuIdProcessor& processor)
 {
-    const CpuIdRegister* reg0 = processor.GetLeaf(0, 0);
+    auto reg0 = processor.FindLeaf(0, 0);
     if (reg0 == nullptr) return;
 
     std::uint32_t leafs = reg0->Eax();
-    std::uint32_t leaf = 1;
+    if (leafs > 0xFFFF) leafs = 0xFFFF;
+
+    auto add_valid = [&processor](std::uint32_t, const CpuIdRegister& reg) {
+        if (reg.IsValid())
+            processor.AddLeaf(reg);
+    };
+
     bool sgx = false;
-    while (leaf <= leafs && leaf <= 0xFFFF) {
+    GetCpuIdLeafs(cpuid, 1, leafs, [&](std::uint32_t leaf, const CpuIdRegister& leafreg) {
         switch (leaf) {
         case 4: {
-            CpuIdRegister reg = cpuid.GetCpuId(leaf, 0);
+            CpuIdRegister reg = leafreg;
             if (reg.IsValid()) {
                 processor.AddLeaf(reg);
 
@@ -96,71 +430,59 @@ void GetCpuIdIntelStandard(ICpuId& cpuid, tree::CpuIdProcessor& processor)
             break;
         }
         case 7: {
-            CpuIdRegister reg = cpuid.GetCpuId(leaf, 0);
-            if (reg.IsValid()) {
-                processor.AddLeaf(reg);
-                sgx = reg.Ebx() & 0x00000004;
+            if (leafreg.IsValid()) {
+                processor.AddLeaf(leafreg);
+                sgx = leafreg.Ebx() & 0x00000004;
 
-                std::uint32_t features = reg.Eax();
-                for (std::uint32_t i = 1; i <= features; i++) {
-                    reg = cpuid.GetCpuId(leaf, i);
-                    if (reg.IsValid())
-                        processor.AddLeaf(reg);
-                }
+                std::uint32_t features = leafreg.Eax();
+                GetCpuIdSubleafs(cpuid, leaf, 1, features, add_valid);
             }
             break;
         }
         case 11:
         case 31: {
-            CpuIdRegister reg;
-            std::uint32_t subleaf = 0;
-            do {
+            CpuIdRegister reg = leafreg;
+            if (reg.IsValid())
+                processor.AddLeaf(reg);
+
+            std::uint32_t subleaf = 1;
+            while (subleaf < 0xFF && reg.IsValid() && (reg.Ebx() & 0x0000FFFF)) {
                 reg = cpuid.GetCpuId(leaf, subleaf);
                 if (reg.IsValid())
                     processor.AddLeaf(reg);
                 subleaf++;
-            } while(subleaf < 0xFF && reg.IsValid() && (reg.Ebx() & 0x0000FFFF));
+            }
             break;
         }
         case 13: {
-            CpuIdRegister reg;
-            for (std::uint32_t i = 0; i < 64; i++) {
-                reg = cpuid.GetCpuId(leaf, i);
+            GetCpuIdSubleafs(cpuid, leaf, 0, 63, [&processor](std::uint32_t subleaf, const CpuIdRegister& reg) {
                 if (reg.IsValid() &&
-                  (i <= 2 || reg.Eax() || reg.Ebx() || reg.Ecx() || reg.Edx()))
+                  (subleaf <= 2 || reg.Eax() || reg.Ebx() || reg.Ecx() || reg.Edx()))
                     processor.AddLeaf(reg);
-            }
+            });
             break;
         }
         case 15: {
-            for (std::uint32_t i = 0; i < 2; i++) {
-                CpuIdRegister reg = cpuid.GetCpuId(leaf, i);
-                if (reg.IsValid())
-                    processor.AddLeaf(reg);
-            }
+            GetCpuIdSubleafs(cpuid, leaf, 0, 1, add_valid);
             break;
         }
         case 16: {
-            CpuIdRegister reg = cpuid.GetCpuId(leaf, 0);
-            if (reg.IsValid()) {
-                processor.AddLeaf(reg);
+            if (leafreg.IsValid()) {
+                processor.AddLeaf(leafreg);
 
-                std::uint32_t resid = 1;
-                std::uint32_t residbit = reg.Ebx() >> 1;
+                std::uint32_t resids = 0;
+                std::uint32_t residbit = leafreg.Ebx() >> 1;
                 while (residbit) {
-                    reg = cpuid.GetCpuId(leaf, resid);
-                    if (reg.IsValid())
-                        processor.AddLeaf(reg);
                     residbit >>= 1;
-                    resid++;
+                    resids++;
                 }
+                GetCpuIdSubleafs(cpuid, leaf, 1, resids, add_valid);
             }
             break;
         }
         case 18: {
-            CpuIdRegister reg0 = cpuid.GetCpuId(leaf, 0);
-            if (reg0.IsValid())
-                processor.AddLeaf(reg0);
+            if (leafreg.IsValid())
+                processor.AddLeaf(leafreg);
 
             CpuIdRegister reg1 = cpuid.GetCpuId(leaf, 1);
             if (reg1.IsValid())
@@ -184,28 +506,21 @@ void GetCpuIdIntelStandard(ICpuId& cpuid, tree::CpuIdProcessor& processor)
         case 23:
         case 24:
         case 32: {
-            CpuIdRegister reg = cpuid.GetCpuId(leaf, 0);
-            if (reg.IsValid()) {
-                processor.AddLeaf(reg);
+            if (leafreg.IsValid()) {
+                processor.AddLeaf(leafreg);
 
-                std::uint32_t subleafs = reg.Eax();
-                for (std::uint32_t i = 1; i <= subleafs; i++) {
-                    reg = cpuid.GetCpuId(leaf, i);
-                    if (reg.IsValid())
-                        processor.AddLeaf(reg);
-                }
+                std::uint32_t subleafs = leafreg.Eax();
+                GetCpuIdSubleafs(cpuid, leaf, 1, subleafs, add_valid);
             }
             break;
         }
         default: {
-            CpuIdRegister reg = cpuid.GetCpuId(leaf, 0);
-            if (reg.IsValid())
-                processor.AddLeaf(reg);
+            if (leafreg.IsValid())
+                processor.AddLeaf(leafreg);
             break;
         }
         }
-        leaf++;
-    }
+    });
 }
 
 void GetCpuIdStandard(ICpuId& cpuid, tree::CpuIdProcessor& processor)
@@ -229,50 +544,55 @@ void GetCpuIdIntelExtended(ICpuId& cpuid, tree::CpuIdProcessor& processor)
     processor.AddLeaf(reg0);
 
     std::uint32_t leafs = reg0.Eax();
-    std::uint32_t leaf = 0x80000001;
-    while (leaf <= leafs && leaf <= 0x8000FFFF) {
+    if (leafs > 0x8000FFFF) leafs = 0x8000FFFF;
+
+    GetCpuIdLeafs(cpuid, 0x80000001, leafs, [&](std::uint32_t leaf, const CpuIdRegister& leafreg) {
         switch (leaf) {
         case 0x8000001D: {
             // AMD Specification, Volume 3, CPUID instruction.
-            CpuIdRegister reg;
-            std::uint32_t subleaf = 0;
-            do {
+            CpuIdRegister reg = leafreg;
+            if (reg.IsValid())
+                processor.AddLeaf(reg);
+
+            std::uint32_t subleaf = 1;
+            while (subleaf < 0xFF && reg.IsValid() && (reg.Eax() & 0x0000000F) != 0) {
                 reg = cpuid.GetCpuId(leaf, subleaf);
                 if (reg.IsValid())
                     processor.AddLeaf(reg);
                 subleaf++;
-            } while(subleaf < 0xFF && reg.IsValid() && (reg.Eax() & 0x0000000F) != 0);
+            }
             break;
         }
         case 0x80000026: {
             // AMD Specification, Volume 3, CPUID instruction.
-            CpuIdRegister reg;
-            std::uint32_t subleaf = 0;
-            do {
+            CpuIdRegister reg = leafreg;
+            if (reg.IsValid())
+                processor.AddLeaf(reg);
+
+            std::uint32_t subleaf = 1;
+            while (subleaf < 0xFF && reg.IsValid() && (reg.Ecx() & 0x0000FF00)) {
                 reg = cpuid.GetCpuId(leaf, subleaf);
                 if (reg.IsValid())
                     processor.AddLeaf(reg);
                 subleaf++;
-            } while(subleaf < 0xFF && reg.IsValid() && (reg.Ecx() & 0x0000FF00));
+            }
             break;
         }
         default: {
-            CpuIdRegister reg = cpuid.GetCpuId(leaf, 0);
-            if (reg.IsValid())
-                processor.AddLeaf(reg);
+            if (leafreg.IsValid())
+                processor.AddLeaf(leafreg);
             break;
         }
         }
-        leaf++;
-    }
+    });
 }
 
 void GetCpuIdHypervisor(ICpuId& cpuid, tree::CpuIdProcessor& processor)
 {
-    const CpuIdRegister* reg0 = processor.GetLeaf(0, 0);
+    auto reg0 = processor.FindLeaf(0, 0);
     if (reg0 == nullptr) return;
 
-    const CpuIdRegister* reg1 = processor.GetLeaf(1, 0);
+    auto reg1 = processor.FindLeaf(1, 0);
     if (reg1 == nullptr) return;
     if ((reg1->Ecx() & 0x80000000) != 0) {
         GetCpuIdRegion(cpuid, processor, 0x40000000);
@@ -286,11 +606,10 @@ void GetCpuIdRegion(ICpuId& cpuid, tree::CpuIdProcessor& processor, std::uint32_
 
     processor.AddLeaf(reg0);
     std::uint32_t leafs = reg0.Eax();
-    std::uint32_t leaf = region + 1;
-    while (leaf <= leafs) {
-        processor.AddLeaf(cpuid.GetCpuId(leaf, 0));
-        leaf++;
-    }
+    GetCpuIdLeafs(cpuid, region + 1, leafs, [&processor](std::uint32_t, const CpuIdRegister& reg) {
+        if (reg.IsValid())
+            processor.AddLeaf(reg);
+    });
 }
 
 }
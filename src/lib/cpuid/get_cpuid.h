@@ -2,14 +2,100 @@
 #define RJCP_CPUID_GET_CPUID_H
 
 #include "cpuid/icpuid_factory.h"
+#include "cpuid/icpuid_sink.h"
 #include "cpuid/tree/cpuid_tree.h"
 
 #include <memory>
 
 namespace rjcp::cpuid {
 
+/**
+ * @brief Options on how GetCpuId() enumerates the CPUs.
+ *
+ */
+class GetCpuIdOptions
+{
+public:
+    explicit GetCpuIdOptions(unsigned int workers = 1, bool intern = false, bool pin = true)
+        : workers{workers}, intern{intern}, pin{pin}
+    { }
+
+    /**
+     * @brief The maximum number of threads that enumerate CPUs concurrently.
+     *
+     * A value of 0 or 1 enumerates all CPUs sequentially on the calling thread.
+     * Otherwise the ICpuIdFactory::create() method must be thread safe.
+     */
+    unsigned int workers;
+
+    /**
+     * @brief Share identical results between CPUs in the tree returned.
+     *
+     * See tree::CpuIdTree::Intern(). This reduces the memory used by the tree
+     * on systems with many similar CPUs. It only applies to the overloads of
+     * GetCpuId() that return a tree.
+     */
+    bool intern;
+
+    /**
+     * @brief Pin each worker thread to the CPU that it enumerates.
+     *
+     * Pinning the worker saves the native reader from moving the thread for
+     * each query. Readers that don't run on the CPU they query, such as the
+     * device reader, should not pin the workers, so that the workers aren't
+     * moved and the Operating System can run them anywhere. The number of
+     * workers then sets how many CPUs are read concurrently.
+     */
+    bool pin;
+};
+
+/**
+ * @brief Query all CPUs sequentially on the current thread.
+ *
+ * @param factory The factory to create the CPUID object for each CPU.
+ * @return std::unique_ptr<tree::CpuIdTree> The results for all CPUs.
+ */
 auto GetCpuId(ICpuIdFactory& factory) -> std::unique_ptr<tree::CpuIdTree>;
 
+/**
+ * @brief Query all CPUs with the given options.
+ *
+ * The results are the same as for GetCpuId(ICpuIdFactory&), independent of the
+ * number of workers.
+ *
+ * @param factory The factory to create the CPUID object for each CPU.
+ * @param options The options on how to enumerate the CPUs.
+ * @return std::unique_ptr<tree::CpuIdTree> The results for all CPUs.
+ */
+auto GetCpuId(ICpuIdFactory& factory, const GetCpuIdOptions& options) -> std::unique_ptr<tree::CpuIdTree>;
+
+/**
+ * @brief Query all CPUs sequentially on the current thread, giving each CPU to
+ * the sink as soon as it is enumerated.
+ *
+ * Only the CPU being enumerated is held in memory, so large systems can be
+ * written out without building a tree. Each CPU is still built as a
+ * CpuIdProcessor before it is given to the sink with ICpuIdSink::Processor(),
+ * as the enumeration looks up earlier results (e.g. the maximum leaf and the
+ * vendor) and the queries aren't made in the sorted order of the registers.
+ *
+ * @param factory The factory to create the CPUID object for each CPU.
+ * @param sink The sink to receive the results.
+ */
+void GetCpuId(ICpuIdFactory& factory, ICpuIdSink& sink);
+
+/**
+ * @brief Query all CPUs with the given options, giving each CPU to the sink in
+ * CPU order as soon as it is available.
+ *
+ * The sink is only called from the calling thread.
+ *
+ * @param factory The factory to create the CPUID object for each CPU.
+ * @param options The options on how to enumerate the CPUs.
+ * @param sink The sink to receive the results.
+ */
+void GetCpuId(ICpuIdFactory& factory, const GetCpuIdOptions& options, ICpuIdSink& sink);
+
 }
 
 #endif
@@ -1,8 +1,10 @@
 #ifndef RJCP_LIB_CPUID_ICPUID_H
 #define RJCP_LIB_CPUID_ICPUID_H
 
+#include "cpuid/cpuid_query.h"
 #include "cpuid/cpuid_register.h"
 
+#include <cstddef>
 #include <cstdint>
 
 namespace rjcp::cpuid {
@@ -19,6 +21,27 @@ public:
      */
     virtual auto GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister = 0;
 
+    /**
+     * @brief Get the CPU ID registers for a list of EAX, ECX values.
+     *
+     * The result for queries[i] is written to registers[i]. Implementations
+     * should override this to amortise the cost of accessing the CPU, such as
+     * setting the thread affinity, over all queries. The results are the same
+     * as calling GetCpuId(eax, ecx) for each query, which is what the default
+     * does.
+     *
+     * @param queries The list of count EAX, ECX values to query for.
+     * @param registers The list of count registers to write the results to.
+     * @param count The number of queries.
+     */
+    virtual void GetCpuId(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept
+    {
+        for (std::size_t i = 0; i < count; i++) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            registers[i] = GetCpuId(queries[i].eax, queries[i].ecx);
+        }
+    }
+
     /**
      * @brief Destroy the ICpuId object
      *
@@ -6,6 +6,7 @@
 #include "cpuid/cpuid_device.h"
 
 #include <memory>
+#include <vector>
 
 namespace rjcp::cpuid {
 
@@ -23,10 +24,32 @@ public:
     /**
      * @brief Get the number of threads (CPUs)
      *
+     * This is the number of CPUs of the system, e.g. from the online CPUs, and
+     * doesn't depend on the CPUs that this process may run on.
+     *
      * @return unsigned int The number of threads.
      */
     virtual auto threads() const -> unsigned int = 0;
 
+    /**
+     * @brief Get the CPUs that can be queried.
+     *
+     * GetCpuId() only creates objects for these CPUs. CPUs less than threads()
+     * that aren't in the list, e.g. because the process isn't allowed to run
+     * on them, are recorded as disallowed without being queried.
+     *
+     * @return std::vector<unsigned int> The CPU numbers in ascending order. By
+     * default, all CPUs from zero to threads() - 1.
+     */
+    virtual auto cpus() const -> std::vector<unsigned int>
+    {
+        std::vector<unsigned int> result(threads());
+        for (unsigned int cpu = 0; cpu < result.size(); cpu++) {
+            result[cpu] = cpu;
+        }
+        return result;
+    }
+
     /**
      * @brief Destroy the ICpuIdFactory object
      *
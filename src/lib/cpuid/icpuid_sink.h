@@ -0,0 +1,99 @@
+#ifndef RJCP_LIB_CPUID_ICPUID_SINK_H
+#define RJCP_LIB_CPUID_ICPUID_SINK_H
+
+#include "cpuid/cpuid_register.h"
+#include "cpuid/tree/cpuid_processor.h"
+
+namespace rjcp::cpuid {
+
+/**
+ * @brief Receives the results of enumerating CPUs, as they become available.
+ *
+ * The enumeration calls Begin(), then for each CPU in order, Processor(), and
+ * finally End(). By default, Processor() calls BeginProcessor(), Register()
+ * for each register sorted by EAX, then ECX, and EndProcessor(), or
+ * Disallowed() for a CPU that the process may not query. A sink that can use
+ * the processor directly may override Processor() instead.
+ *
+ * The methods are only called from one thread at a time.
+ */
+class ICpuIdSink
+{
+public:
+    /**
+     * @brief Called before any CPU.
+     *
+     */
+    virtual void Begin() = 0;
+
+    /**
+     * @brief Called when the registers for a CPU follow.
+     *
+     * @param cpu The CPU number.
+     */
+    virtual void BeginProcessor(unsigned int cpu) = 0;
+
+    /**
+     * @brief Called for each register of the current CPU.
+     *
+     * @param reg The register.
+     */
+    virtual void Register(const CpuIdRegister& reg) = 0;
+
+    /**
+     * @brief Called after all registers for a CPU.
+     *
+     * @param cpu The CPU number.
+     */
+    virtual void EndProcessor(unsigned int cpu) = 0;
+
+    /**
+     * @brief Called instead of BeginProcessor() and EndProcessor() for a CPU
+     * that wasn't queried, because the process isn't allowed to run on it.
+     *
+     * By default, the CPU is given as a CPU without registers.
+     *
+     * @param cpu The CPU number.
+     */
+    virtual void Disallowed(unsigned int cpu)
+    {
+        BeginProcessor(cpu);
+        EndProcessor(cpu);
+    }
+
+    /**
+     * @brief Called after all CPUs.
+     *
+     */
+    virtual void End() = 0;
+
+    /**
+     * @brief Called with all registers of a CPU.
+     *
+     * @param cpu The CPU number.
+     * @param processor The registers of the CPU.
+     */
+    virtual void Processor(unsigned int cpu, const tree::CpuIdProcessor& processor)
+    {
+        if (processor.IsDisallowed()) {
+            Disallowed(cpu);
+            return;
+        }
+
+        BeginProcessor(cpu);
+        for (const auto& leaf : processor.Leaves()) {
+            Register(leaf.second);
+        }
+        EndProcessor(cpu);
+    }
+
+    /**
+     * @brief Destroy the ICpuIdSink object
+     *
+     */
+    virtual ~ICpuIdSink() = default;
+};
+
+}
+
+#endif
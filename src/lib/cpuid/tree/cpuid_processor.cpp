@@ -1,74 +1,379 @@
 #include "cpuid/tree/cpuid_processor.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace rjcp::cpuid::tree {
 
+CpuIdProcessor::CpuIdProcessor(const CpuIdProcessor& tree)
+: m_storage(tree.m_storage), m_delta(tree.m_delta), m_disallowed(tree.m_disallowed)
+{
+    // The storage of a processor whose registers may be changed through its
+    // iterators is written to, so can't be shared.
+    if (tree.m_writable) {
+        tree.UpdateStorage();
+        m_storage = std::make_shared<CpuIdStorage>(*tree.m_storage);
+    }
+}
+
 CpuIdProcessor::CpuIdProcessor(CpuIdProcessor&& tree)
-: m_node(std::move(tree.m_node))
-{ }
+: m_storage(std::move(tree.m_storage)), m_delta(std::move(tree.m_delta)), m_disallowed(tree.m_disallowed),
+  m_registers(std::move(tree.m_registers)), m_writable(tree.m_writable)
+{
+    tree.m_storage.reset();
+    tree.m_delta.clear();
+    tree.m_registers.reset();
+    tree.m_writable = false;
+}
+
+auto CpuIdProcessor::operator=(const CpuIdProcessor& other) -> CpuIdProcessor&
+{
+    if (this == &other) return *this;
+    return *this = CpuIdProcessor{other};
+}
 
 auto CpuIdProcessor::operator=(CpuIdProcessor&& other) -> CpuIdProcessor&
 {
-    m_node = std::move(other.m_node);
+    m_storage = std::move(other.m_storage);
+    m_delta = std::move(other.m_delta);
+    m_disallowed = other.m_disallowed;
+    m_registers = std::move(other.m_registers);
+    m_writable = other.m_writable;
+    other.m_storage.reset();
+    other.m_delta.clear();
+    other.m_registers.reset();
+    other.m_writable = false;
     return *this;
 }
 
+auto CpuIdProcessor::GetValue(std::size_t position) const noexcept -> const CpuIdValue&
+{
+    if (!m_delta.empty()) {
+        auto delta = std::lower_bound(m_delta.cbegin(), m_delta.cend(), position,
+            [](const CpuIdDelta::value_type& entry, std::size_t position) {
+                return entry.first < position;
+            });
+        if (delta != m_delta.cend() && delta->first == position) return delta->second;
+    }
+    return m_storage->values[position];
+}
+
+auto CpuIdProcessor::GetStorage() -> CpuIdStorage&
+{
+    if (!m_storage) {
+        m_storage = std::make_shared<CpuIdStorage>();
+        return *m_storage;
+    }
+
+    // Copy on write, so that other processors sharing the storage don't see
+    // the change.
+    if (m_storage.use_count() > 1) {
+        m_storage = std::make_shared<CpuIdStorage>(*m_storage);
+    }
+    for (const auto& delta : m_delta) {
+        m_storage->values[delta.first] = delta.second;
+    }
+    m_delta.clear();
+    return *m_storage;
+}
+
+auto CpuIdProcessor::GetRegisters() const -> CpuIdRegisters&
+{
+    std::lock_guard<std::mutex> lock{m_registersLock};
+    if (!m_registers) {
+        auto registers = std::make_unique<CpuIdRegisters>();
+        for (const auto& leaf : LeafRange{this}) {
+            registers->emplace_hint(registers->end(),
+                CpuIdLeaf{leaf.second.InEax(), leaf.second.InEcx()}, leaf.second);
+        }
+        m_registers = std::move(registers);
+    }
+    return *m_registers;
+}
+
+auto CpuIdProcessor::GetWritableRegisters() -> CpuIdRegisters&
+{
+    CpuIdRegisters& registers = GetRegisters();
+    if (!m_writable) {
+        // The registers are copied back to the storage when it is read, so it
+        // must not be shared with other processors.
+        GetStorage();
+        m_writable = true;
+    }
+    return registers;
+}
+
+void CpuIdProcessor::UpdateStorage() const
+{
+    if (!m_writable) return;
+
+    // The keys can't be changed through the iterators, so the registers are
+    // at the same positions as in the storage.
+    std::lock_guard<std::mutex> lock{m_registersLock};
+    CpuIdValues& values = m_storage->values;
+    std::size_t position = 0;
+    for (const auto& reg : *m_registers) {
+        CpuIdValue value = reg.second.Value();
+        if (values[position] != value) values[position] = value;
+        position++;
+    }
+}
+
 // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
 auto CpuIdProcessor::GetLeaf(std::uint32_t eax, std::uint32_t ecx) const -> const CpuIdRegister*
 {
-    auto result = m_node.find(CpuIdKey{eax, ecx});
-    if (result == m_node.cend()) {
-        return nullptr;
-    }
+    if (IsEmpty()) return nullptr;
 
-    return &(*result).second;
+    const CpuIdRegisters& registers = GetRegisters();
+    auto result = registers.find(CpuIdLeaf{eax, ecx});
+    if (result == registers.cend()) return nullptr;
+    return &result->second;
 }
 
-template<typename T>
-auto CpuIdProcessor::AddLeafInternal(T&& cpureg) -> bool
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+auto CpuIdProcessor::FindLeaf(std::uint32_t eax, std::uint32_t ecx) const -> CpuIdRegisterPtr
 {
-    auto value = m_node.emplace(
-        std::make_pair(CpuIdKey(cpureg.InEax(), cpureg.InEcx()), std::forward<T>(cpureg)));
-    return value.second;
+    if (!m_storage) return nullptr;
+    UpdateStorage();
+    const CpuIdStorage& storage = *m_storage;
+
+    auto first = storage.keys.cbegin();
+    std::size_t slot = common::GetIndexSlot(eax);
+    if (storage.indexed && slot != common::IndexSize) {
+        std::size_t position = storage.index[slot];
+        if (ecx == 0) {
+            if (position == 0) return nullptr;
+            return CpuIdRegisterPtr{CpuIdRegister{eax, ecx, GetValue(position - 1)}};
+        }
+
+        // The subleafs of a leaf sort after subleaf 0, so only search from
+        // there.
+        if (position != 0) first += static_cast<CpuIdKeys::difference_type>(position);
+    }
+
+    CpuIdKey key = GetKey(eax, ecx);
+    auto result = std::lower_bound(first, storage.keys.cend(), key);
+    if (result == storage.keys.cend() || *result != key) {
+        return nullptr;
+    }
+
+    auto position = static_cast<std::size_t>(result - storage.keys.cbegin());
+    return CpuIdRegisterPtr{CpuIdRegister{eax, ecx, GetValue(position)}};
 }
 
 auto CpuIdProcessor::AddLeaf(const CpuIdRegister& cpureg) -> bool
 {
-    return AddLeafInternal(cpureg);
+    // Only valid registers can be stored, the compact form has no space to
+    // record that it is invalid.
+    if (!cpureg.IsValid()) return false;
+
+    CpuIdKey key = GetKey(cpureg.InEax(), cpureg.InEcx());
+
+    // The enumeration usually adds registers in order, so appending is the
+    // common case and needs no search.
+    if (!m_storage || m_storage->keys.empty() || m_storage->keys.back() < key) {
+        CpuIdStorage& storage = GetStorage();
+        storage.keys.push_back(key);
+        storage.values.push_back(cpureg.Value());
+        UpdateIndex(storage, storage.keys.size() - 1, cpureg.InEax(), cpureg.InEcx());
+        if (m_registers) m_registers->emplace_hint(m_registers->end(), CpuIdLeaf{cpureg.InEax(), cpureg.InEcx()}, cpureg);
+        return true;
+    }
+
+    const CpuIdKeys& keys = m_storage->keys;
+    auto result = std::lower_bound(keys.cbegin(), keys.cend(), key);
+    if (result != keys.cend() && *result == key) {
+        return false;
+    }
+    auto position = static_cast<std::size_t>(result - keys.cbegin());
+
+    CpuIdStorage& storage = GetStorage();
+    storage.keys.insert(storage.keys.begin() + static_cast<CpuIdKeys::difference_type>(position), key);
+    storage.values.insert(storage.values.begin() + static_cast<CpuIdValues::difference_type>(position), cpureg.Value());
+
+    // Everything after the new leaf has moved by one.
+    if (storage.indexed) {
+        for (auto& entry : storage.index) {
+            if (entry > position) entry++;
+        }
+    }
+    UpdateIndex(storage, position, cpureg.InEax(), cpureg.InEcx());
+    if (m_registers) m_registers->emplace(CpuIdLeaf{cpureg.InEax(), cpureg.InEcx()}, cpureg);
+    return true;
 }
 
 auto CpuIdProcessor::AddLeaf(CpuIdRegister&& cpureg) -> bool
 {
-    return AddLeafInternal(std::move(cpureg));
+    return AddLeaf(static_cast<const CpuIdRegister&>(cpureg));
+}
+
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+void CpuIdProcessor::UpdateIndex(CpuIdStorage& storage, std::size_t position, std::uint32_t eax, std::uint32_t ecx) noexcept
+{
+    if (!storage.indexed) return;
+
+    if (storage.keys.size() >= std::numeric_limits<CpuIdIndex::value_type>::max()) {
+        // The positions no longer fit in the index, so only search. This isn't
+        // expected for real processors.
+        storage.indexed = false;
+        return;
+    }
+
+    std::size_t slot = common::GetIndexSlot(eax);
+    if (slot == common::IndexSize || ecx != 0) return;
+    storage.index[slot] = static_cast<CpuIdIndex::value_type>(position + 1);
+}
+
+auto CpuIdProcessor::Intern(const CpuIdProcessor& other) -> bool
+{
+    // Only share storage that has no delta of its own, and isn't written
+    // through the iterators.
+    if (m_writable || other.m_writable) return false;
+    if (!other.m_storage || !other.m_delta.empty()) return false;
+    if (m_storage == other.m_storage && m_delta.empty()) return true;
+    if (!m_storage || m_storage->keys != other.m_storage->keys) return false;
+
+    std::size_t size = m_storage->keys.size();
+    std::size_t maxdelta = size / common::MaxDeltaDivisor;
+    const CpuIdValues& values = other.m_storage->values;
+    CpuIdDelta delta{};
+    for (std::size_t position = 0; position < size; position++) {
+        const CpuIdValue& value = GetValue(position);
+        if (value != values[position]) {
+            if (delta.size() >= maxdelta) return false;
+            delta.emplace_back(static_cast<std::uint32_t>(position), value);
+        }
+    }
+
+    m_storage = other.m_storage;
+    m_delta = std::move(delta);
+    return true;
+}
+
+void CpuIdProcessor::Reserve(std::size_t count)
+{
+    CpuIdStorage& storage = GetStorage();
+    storage.keys.reserve(count);
+    storage.values.reserve(count);
 }
 
 auto CpuIdProcessor::Size() const noexcept -> std::size_t
 {
-    return m_node.size();
+    if (!m_storage) return 0;
+    return m_storage->keys.size();
 }
 
 auto CpuIdProcessor::IsEmpty() const noexcept -> bool
 {
-    return m_node.size() == 0;
+    return Size() == 0;
+}
+
+void CpuIdProcessor::SetDisallowed(bool disallowed) noexcept
+{
+    m_disallowed = disallowed;
+}
+
+auto CpuIdProcessor::IsDisallowed() const noexcept -> bool
+{
+    return m_disallowed;
+}
+
+auto CpuIdProcessor::operator==(const CpuIdProcessor& other) const noexcept -> bool
+{
+    if (m_disallowed != other.m_disallowed) return false;
+    UpdateStorage();
+    other.UpdateStorage();
+
+    std::size_t size = Size();
+    if (size != other.Size()) return false;
+    if (size == 0) return true;
+
+    if (m_storage != other.m_storage) {
+        if (m_storage->keys != other.m_storage->keys) return false;
+        if (m_delta.empty() && other.m_delta.empty()) {
+            return m_storage->values == other.m_storage->values;
+        }
+    } else if (m_delta == other.m_delta) {
+        return true;
+    }
+
+    for (std::size_t position = 0; position < size; position++) {
+        if (GetValue(position) != other.GetValue(position)) return false;
+    }
+    return true;
+}
+
+auto CpuIdProcessor::operator!=(const CpuIdProcessor& other) const noexcept -> bool
+{
+    return !(*this == other);
+}
+
+auto CpuIdProcessor::Leaves() const -> LeafRange
+{
+    UpdateStorage();
+    return LeafRange{this};
 }
 
 auto CpuIdProcessor::begin() noexcept -> iterator
 {
-    return m_node.begin();
+    return GetWritableRegisters().begin();
 }
 
 auto CpuIdProcessor::end() noexcept -> iterator
 {
-    return m_node.end();
+    return GetWritableRegisters().end();
 }
 
 auto CpuIdProcessor::cbegin() const noexcept -> const_iterator
 {
-    return m_node.cbegin();
+    return GetRegisters().cbegin();
 }
 
 auto CpuIdProcessor::cend() const noexcept -> const_iterator
 {
-    return m_node.cend();
+    return GetRegisters().cend();
+}
+
+CpuIdProcessor::LeafIterator::LeafIterator(const CpuIdProcessor* processor, std::size_t position) noexcept
+: m_processor{processor}, m_position{position}
+{ }
+
+auto CpuIdProcessor::LeafIterator::operator*() const noexcept -> reference
+{
+    CpuIdKey key = m_processor->m_storage->keys[m_position];
+    m_value.first = key;
+    m_value.second = CpuIdRegister{
+        static_cast<std::uint32_t>(key >> 32), static_cast<std::uint32_t>(key),
+        m_processor->GetValue(m_position)};
+    return m_value;
+}
+
+auto CpuIdProcessor::LeafIterator::operator->() const noexcept -> pointer
+{
+    return &**this;
+}
+
+auto CpuIdProcessor::LeafIterator::operator++() noexcept -> LeafIterator&
+{
+    m_position++;
+    return *this;
+}
+
+auto CpuIdProcessor::LeafIterator::operator++(int) noexcept -> LeafIterator
+{
+    LeafIterator result = *this;
+    m_position++;
+    return result;
+}
+
+auto CpuIdProcessor::LeafIterator::operator==(const LeafIterator& other) const noexcept -> bool
+{
+    return m_processor == other.m_processor && m_position == other.m_position;
+}
+
+auto CpuIdProcessor::LeafIterator::operator!=(const LeafIterator& other) const noexcept -> bool
+{
+    return !(*this == other);
 }
 
 }
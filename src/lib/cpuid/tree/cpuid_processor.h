@@ -2,32 +2,100 @@
 #define RJCP_LIB_CPUID_TREE_CPUID_PROCESSOR_H
 
 #include "cpuid/cpuid_register.h"
+#include "cpuid/cpuid_value.h"
+#include "cpuid/tree/cpuid_register_ptr.h"
+#include "cpuid/tree/cpuid_tree_common.h"
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 namespace rjcp::cpuid::tree {
 
 class CpuIdProcessor
 {
 private:
-    struct CpuIdKey {
-        CpuIdKey(std::uint32_t eax, std::uint32_t ecx)
+    /**
+     * @brief The key for a leaf, which is EAX in the upper 32-bits and ECX in
+     * the lower 32-bits, so that integer ordering sorts by EAX, then ECX.
+     */
+    using CpuIdKey = std::uint64_t;
+
+    /**
+     * @brief The leaves are kept as two arrays sorted by the key, one for the
+     * keys and one for the compact results at the same position. This is a
+     * contiguous block of memory which is cheaper to build and search than a
+     * node based container, as registers are usually added in order. Searches
+     * only touch the keys.
+     */
+    using CpuIdKeys = std::vector<CpuIdKey>;
+    using CpuIdValues = std::vector<CpuIdValue>;
+
+    /**
+     * @brief A direct index for subleaf 0 of the leaves in the standard,
+     * hypervisor and extended regions.
+     *
+     * Each entry is the position in the arrays plus one, or zero if the leaf
+     * doesn't exist.
+     */
+    using CpuIdIndex = std::array<std::uint16_t, common::IndexSize>;
+
+    /**
+     * @brief The storage for the registers.
+     *
+     * The storage is shared between copies of a processor, and between
+     * processors with the same leaves after interning. It is copied before it
+     * is modified if it is shared (copy on write).
+     */
+    struct CpuIdStorage {
+        CpuIdKeys keys{};
+        CpuIdValues values{};
+        CpuIdIndex index{};
+        bool indexed{true};
+    };
+
+    /**
+     * @brief The results of this processor that are different to the shared
+     * storage, as the position in the storage and the result, sorted by the
+     * position.
+     */
+    using CpuIdDelta = std::vector<std::pair<std::uint32_t, CpuIdValue>>;
+
+    /**
+     * @brief The key of the registers given by GetLeaf() and the iterators.
+     */
+    struct CpuIdLeaf {
+        CpuIdLeaf(std::uint32_t eax, std::uint32_t ecx)
         : eax{eax}, ecx{ecx} { }
 
         std::uint32_t eax;
         std::uint32_t ecx;
     };
 
-    struct CpuIdKeySort {
-        auto operator()(const CpuIdKey& lhs, const CpuIdKey& rhs) const -> bool
+    struct CpuIdLeafSort {
+        auto operator()(const CpuIdLeaf& lhs, const CpuIdLeaf& rhs) const -> bool
         {
-            if (lhs.eax > rhs.eax) return false;
-            return lhs.eax < rhs.eax || lhs.ecx < rhs.ecx;
+            if (lhs.eax != rhs.eax) return lhs.eax < rhs.eax;
+            return lhs.ecx < rhs.ecx;
         }
     };
 
-    using CpuIdNode = std::map<CpuIdKey, CpuIdRegister, CpuIdKeySort>;
+    /**
+     * @brief The registers as CpuIdRegister objects, for GetLeaf() and the
+     * iterators, which give pointers and references to registers.
+     *
+     * It is built from the storage when it is first needed, and then kept up
+     * to date with AddLeaf().
+     */
+    using CpuIdRegisters = std::map<CpuIdLeaf, CpuIdRegister, CpuIdLeafSort>;
+
+    friend class CpuIdTree;
 
 public:
     /**
@@ -41,7 +109,7 @@ public:
      *
      * @param tree The object to copy from.
      */
-    CpuIdProcessor(const CpuIdProcessor& tree) = default;
+    CpuIdProcessor(const CpuIdProcessor& tree);
 
     /**
      * @brief Construct a new CPU register list from another object (move).
@@ -62,7 +130,7 @@ public:
      * @param other The other CPU register list to copy from.
      * @return CpuIdTree& The reference to this object.
      */
-    auto operator=(const CpuIdProcessor& other) -> CpuIdProcessor& = default;
+    auto operator=(const CpuIdProcessor& other) -> CpuIdProcessor&;
 
     /**
      * @brief Move Assignment operator.
@@ -75,6 +143,9 @@ public:
     /**
      * @brief Get the Leaf object for the given EAX and ECX value.
      *
+     * The first call converts all registers to CpuIdRegister objects, which
+     * are kept with this object. Use FindLeaf() to avoid this.
+     *
      * @param eax The CPUID EAX value.
      * @param ecx The CPUID ECX value.
      * @return CpuIdRegister* The object stored. If it is undefined, then
@@ -82,6 +153,17 @@ public:
      */
     auto GetLeaf(std::uint32_t eax, std::uint32_t ecx) const -> const CpuIdRegister*;
 
+    /**
+     * @brief Find the register for the given EAX and ECX value in the compact
+     * storage.
+     *
+     * @param eax The CPUID EAX value.
+     * @param ecx The CPUID ECX value.
+     * @return CpuIdRegisterPtr A copy of the register. If it is undefined,
+     * then nullptr is returned.
+     */
+    auto FindLeaf(std::uint32_t eax, std::uint32_t ecx) const -> CpuIdRegisterPtr;
+
     /**
      * @brief Add the CPUID register data to this object.
      *
@@ -90,7 +172,8 @@ public:
      *
      * @param cpureg The CPUID register data to add to this object.
      * @return true The object was added.
-     * @return false The object already exists and was not added.
+     * @return false The object already exists, or is not valid, and was not
+     * added.
      */
     auto AddLeaf(const CpuIdRegister& cpureg) -> bool;
 
@@ -102,10 +185,36 @@ public:
      *
      * @param cpureg The CPUID register data to add to this object.
      * @return true The object was added.
-     * @return false The object already exists and was not added.
+     * @return false The object already exists, or is not valid, and was not
+     * added.
      */
     auto AddLeaf(CpuIdRegister&& cpureg) -> bool;
 
+    /**
+     * @brief Reserve storage for the number of registers expected.
+     *
+     * This is only a hint, so that building this object from many registers
+     * doesn't need to reallocate for every few registers that are added.
+     *
+     * @param count The number of registers expected to be added.
+     */
+    void Reserve(std::size_t count);
+
+    /**
+     * @brief Share the storage of another processor with the same leaves.
+     *
+     * If this processor has the same leaves (the same EAX and ECX) as the
+     * other processor, and most of the results are identical, then the storage
+     * of the other processor is shared, and only the results that are
+     * different are stored by this processor. Iterating and getting leaves
+     * work as before.
+     *
+     * @param other The processor to share the storage with.
+     * @return true The storage of the other processor is now shared.
+     * @return false The processors are too different, nothing was changed.
+     */
+    auto Intern(const CpuIdProcessor& other) -> bool;
+
     /**
      * @brief Get the number of registers defined in this data structure.
      *
@@ -121,13 +230,108 @@ public:
      */
     auto IsEmpty() const noexcept -> bool;
 
+    /**
+     * @brief Mark the processor as one that the process isn't allowed to
+     * query.
+     *
+     * A disallowed processor has no registers, and is recorded so that it
+     * isn't mistaken for a processor that was queried and returned nothing.
+     *
+     * @param disallowed If the processor is disallowed.
+     */
+    void SetDisallowed(bool disallowed) noexcept;
+
+    /**
+     * @brief Test if the processor wasn't queried, because the process isn't
+     * allowed to run on it.
+     *
+     * @return true The processor is disallowed.
+     * @return false The processor was queried.
+     */
+    auto IsDisallowed() const noexcept -> bool;
+
+    /**
+     * @brief Compare the registers of two processors.
+     *
+     * @param other The processor to compare with.
+     * @return true Both processors have the same leaves with the same results.
+     * @return false The processors are different.
+     */
+    auto operator==(const CpuIdProcessor& other) const noexcept -> bool;
+
+    /**
+     * @brief Compare the registers of two processors.
+     *
+     * @param other The processor to compare with.
+     * @return true The processors are different.
+     * @return false Both processors have the same leaves with the same results.
+     */
+    auto operator!=(const CpuIdProcessor& other) const noexcept -> bool;
+
+    /**
+     * @brief An iterator over the compact storage, in the order of EAX, then
+     * ECX.
+     *
+     * Dereferencing the iterator gives a pair of the key and a CpuIdRegister
+     * that is held by the iterator. The reference is valid until the iterator
+     * is changed or destroyed. The registers can't be modified through the
+     * iterator.
+     */
+    class LeafIterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::pair<CpuIdKey, CpuIdRegister>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        LeafIterator() noexcept = default;
+        LeafIterator(const CpuIdProcessor* processor, std::size_t position) noexcept;
+
+        auto operator*() const noexcept -> reference;
+        auto operator->() const noexcept -> pointer;
+        auto operator++() noexcept -> LeafIterator&;
+        auto operator++(int) noexcept -> LeafIterator;
+        auto operator==(const LeafIterator& other) const noexcept -> bool;
+        auto operator!=(const LeafIterator& other) const noexcept -> bool;
+
+    private:
+        const CpuIdProcessor* m_processor{nullptr};
+        std::size_t m_position{0};
+        mutable value_type m_value{};
+    };
+
+    /**
+     * @brief The registers in the compact storage, for a range based loop.
+     */
+    class LeafRange
+    {
+    public:
+        explicit LeafRange(const CpuIdProcessor* processor) noexcept : m_processor{processor} { }
+
+        auto begin() const noexcept -> LeafIterator { return LeafIterator{m_processor, 0}; }
+        auto end() const noexcept -> LeafIterator { return LeafIterator{m_processor, m_processor->Size()}; }
+
+    private:
+        const CpuIdProcessor* m_processor;
+    };
+
+    /**
+     * @brief Get the registers from the compact storage, without converting
+     * them to CpuIdRegister objects that are kept with this object.
+     *
+     * @return LeafRange The registers, valid until this object is modified.
+     */
+    auto Leaves() const -> LeafRange;
+
     /**
      * @brief The type for the iterator.
      *
      * Use this type to know what the iterator type is, instead of relying on
      * private details.
      */
-    using iterator = CpuIdNode::iterator;
+    using iterator = CpuIdRegisters::iterator;
 
     /**
      * @brief The type for the constant iterator.
@@ -135,11 +339,14 @@ public:
      * Use this type to know what the constant iterator type is, instead of
      * relying on private details.
      */
-    using const_iterator = CpuIdNode::const_iterator;
+    using const_iterator = CpuIdRegisters::const_iterator;
 
     /**
      * @brief Iterator to the first element.
      *
+     * The registers may be changed through the iterator. This processor then
+     * no longer shares its storage with other processors.
+     *
      * @return iterator The iterator to the first element.
      */
     auto begin() noexcept -> iterator;
@@ -166,10 +373,28 @@ public:
     auto cend() const noexcept -> const_iterator;
 
 private:
-    CpuIdNode m_node{};
+    std::shared_ptr<CpuIdStorage> m_storage{};
+    CpuIdDelta m_delta{};
+    bool m_disallowed{false};
+
+    // The registers for GetLeaf() and the iterators. After begin() or end(),
+    // the registers may have been changed, and are copied to the storage
+    // before it is read.
+    mutable std::mutex m_registersLock{};
+    mutable std::unique_ptr<CpuIdRegisters> m_registers{};
+    bool m_writable{false};
+
+    static void UpdateIndex(CpuIdStorage& storage, std::size_t position, std::uint32_t eax, std::uint32_t ecx) noexcept;
+    auto GetValue(std::size_t position) const noexcept -> const CpuIdValue&;
+    auto GetStorage() -> CpuIdStorage&;
+    auto GetRegisters() const -> CpuIdRegisters&;
+    auto GetWritableRegisters() -> CpuIdRegisters&;
+    void UpdateStorage() const;
 
-    template<typename T>
-    auto AddLeafInternal(T&& cpureg) -> bool;
+    static constexpr auto GetKey(std::uint32_t eax, std::uint32_t ecx) noexcept -> CpuIdKey
+    {
+        return (static_cast<CpuIdKey>(eax) << 32) | ecx;
+    }
 };
 
 }
@@ -0,0 +1,363 @@
+#include "cpuid/tree/cpuid_read_xml.h"
+#include "cpuid/tree/cpuid_tree_sink.h"
+#include "cpuid/tree/cpuid_xml_format.h"
+#include "os/qnx/native/file/mapped_file.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace rjcp::cpuid::tree {
+
+namespace {
+
+// The value of each hex digit, or 0xFF if the character isn't a hex digit.
+constexpr auto MakeHexDigits() -> std::array<std::uint8_t, 256>
+{
+    std::array<std::uint8_t, 256> table{};
+    for (std::size_t i = 0; i < 256; i++) table[i] = 0xFF;
+    for (std::size_t i = 0; i < 10; i++) table['0' + i] = static_cast<std::uint8_t>(i);
+    for (std::size_t i = 0; i < 6; i++) {
+        table['A' + i] = static_cast<std::uint8_t>(10 + i);
+        table['a' + i] = static_cast<std::uint8_t>(10 + i);
+    }
+    return table;
+}
+
+constexpr std::array<std::uint8_t, 256> HexDigits = MakeHexDigits();
+
+/**
+ * @brief Decode exactly eight hex digits.
+ */
+auto DecodeHex(const char* text, std::uint32_t& value) noexcept -> bool
+{
+    // An invalid digit has the upper bits set, which are checked once at the
+    // end.
+    std::uint32_t result = 0;
+    std::uint8_t check = 0;
+    for (std::size_t i = 0; i < xml::HexLength; i++) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        std::uint8_t digit = HexDigits[static_cast<unsigned char>(text[i])];
+        check |= digit;
+        result = (result << 4) | (digit & 0xF);
+    }
+    value = result;
+    return check < 16;
+}
+
+/**
+ * @brief A tag, with the attributes that are of interest.
+ */
+struct XmlTag
+{
+    std::string_view name{};
+    std::string_view eax{};
+    std::string_view ecx{};
+    bool disallowed{};
+    bool closing{};
+    bool empty{};
+};
+
+/**
+ * @brief A forward only reader over the XML text, which understands the
+ * subset of XML needed for the CPUID format.
+ */
+class XmlReader
+{
+public:
+    XmlReader(std::string_view xml) noexcept : m_xml{xml} { }
+
+    /**
+     * @brief Skip whitespace, comments, processing instructions and the
+     * document type, stopping at the next tag or text.
+     */
+    auto SkipMisc() noexcept -> bool
+    {
+        while (true) {
+            SkipSpace();
+            if (StartsWith("<?")) {
+                if (!SkipPast("?>")) return false;
+            } else if (StartsWith("<!--")) {
+                if (!SkipPast("-->")) return false;
+            } else if (StartsWith("<!")) {
+                if (!SkipPast(">")) return false;
+            } else {
+                return true;
+            }
+        }
+    }
+
+    auto AtEnd() const noexcept -> bool { return m_pos >= m_xml.size(); }
+
+    /**
+     * @brief Read the next tag, after skipping whitespace and comments.
+     */
+    auto ReadTag(XmlTag& tag) noexcept -> bool
+    {
+        tag = XmlTag{};
+        if (!SkipMisc() || !Consume('<')) return false;
+        tag.closing = Consume('/');
+        tag.name = ReadName();
+        if (tag.name.empty()) return false;
+
+        while (true) {
+            SkipSpace();
+            if (Consume('>')) return true;
+            if (StartsWith("/>")) {
+                m_pos += 2;
+                tag.empty = true;
+                return !tag.closing;
+            }
+
+            std::string_view name = ReadName();
+            if (name.empty()) return false;
+            SkipSpace();
+            if (!Consume('=')) return false;
+            SkipSpace();
+            if (AtEnd()) return false;
+            char quote = m_xml[m_pos];
+            if (quote != '"' && quote != '\'') return false;
+            m_pos++;
+            std::size_t end = m_xml.find(quote, m_pos);
+            if (end == std::string_view::npos) return false;
+            std::string_view value = m_xml.substr(m_pos, end - m_pos);
+            m_pos = end + 1;
+
+            if (name == "eax") {
+                tag.eax = value;
+            } else if (name == "ecx") {
+                tag.ecx = value;
+            } else if (name == "disallowed") {
+                tag.disallowed = value == "true";
+            }
+        }
+    }
+
+    /**
+     * @brief Read a register in exactly the layout written by CpuIdXmlSink.
+     *
+     * Nearly all registers in a file are in this layout, and can be decoded
+     * at fixed offsets without searching. Otherwise nothing is consumed, and
+     * the register should be read with ReadTag().
+     */
+    auto ReadFixedRegister(CpuIdRegister& reg) noexcept -> bool
+    {
+        if (m_xml.size() - m_pos < xml::Register.size()) return false;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const char* text = m_xml.data() + m_pos;
+
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic) - Length checked above
+        if (!Matches(text, 0, xml::InEaxOffset)) return false;
+        if (!Matches(text, xml::InEaxOffset + xml::HexLength, xml::InEcxOffset)) return false;
+        if (!Matches(text, xml::InEcxOffset + xml::HexLength, xml::EaxOffset)) return false;
+        if (text[xml::EbxOffset - 1] != ',' || text[xml::EcxOffset - 1] != ',' || text[xml::EdxOffset - 1] != ',') return false;
+        if (!Matches(text, xml::EdxOffset + xml::HexLength, xml::Register.size())) return false;
+
+        std::uint32_t eax = 0;
+        std::uint32_t ecx = 0;
+        CpuIdValue value{};
+        bool valid = DecodeHex(text + xml::InEaxOffset, eax);
+        valid &= DecodeHex(text + xml::InEcxOffset, ecx);
+        valid &= DecodeHex(text + xml::EaxOffset, value.eax);
+        valid &= DecodeHex(text + xml::EbxOffset, value.ebx);
+        valid &= DecodeHex(text + xml::EcxOffset, value.ecx);
+        valid &= DecodeHex(text + xml::EdxOffset, value.edx);
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if (!valid) return false;
+
+        reg = CpuIdRegister{eax, ecx, value};
+        m_pos += xml::Register.size();
+        return true;
+    }
+
+    /**
+     * @brief Read the text up to the next tag.
+     */
+    auto ReadText() noexcept -> std::string_view
+    {
+        std::size_t end = m_xml.find('<', m_pos);
+        if (end == std::string_view::npos) end = m_xml.size();
+        std::string_view text = m_xml.substr(m_pos, end - m_pos);
+        m_pos = end;
+        return text;
+    }
+
+    void SkipSpace() noexcept
+    {
+        while (m_pos < m_xml.size() && IsSpace(m_xml[m_pos])) m_pos++;
+    }
+
+private:
+    std::string_view m_xml;
+    std::size_t m_pos{};
+
+    static auto Matches(const char* text, std::size_t start, std::size_t end) noexcept -> bool
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        return std::memcmp(text + start, xml::Register.data() + start, end - start) == 0;
+    }
+
+    static auto IsSpace(char c) noexcept -> bool
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    static auto IsNameChar(char c) noexcept -> bool
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+            c == '_' || c == '-' || c == ':' || c == '.';
+    }
+
+    auto StartsWith(std::string_view text) const noexcept -> bool
+    {
+        return m_xml.compare(m_pos, text.size(), text) == 0;
+    }
+
+    auto SkipPast(std::string_view text) noexcept -> bool
+    {
+        std::size_t end = m_xml.find(text, m_pos);
+        if (end == std::string_view::npos) return false;
+        m_pos = end + text.size();
+        return true;
+    }
+
+    auto Consume(char c) noexcept -> bool
+    {
+        if (m_pos >= m_xml.size() || m_xml[m_pos] != c) return false;
+        m_pos++;
+        return true;
+    }
+
+    auto ReadName() noexcept -> std::string_view
+    {
+        std::size_t start = m_pos;
+        while (m_pos < m_xml.size() && IsNameChar(m_xml[m_pos])) m_pos++;
+        return m_xml.substr(start, m_pos - start);
+    }
+};
+
+/**
+ * @brief Decode a hex value of one to eight digits, ignoring surrounding
+ * whitespace.
+ */
+auto ParseHex(std::string_view text, std::uint32_t& value) noexcept -> bool
+{
+    std::size_t start = text.find_first_not_of(" \t\r\n");
+    std::size_t end = text.find_last_not_of(" \t\r\n");
+    if (start == std::string_view::npos) return false;
+    if (end - start >= 8) return false;
+
+    std::uint32_t result = 0;
+    for (std::size_t i = start; i <= end; i++) {
+        std::uint8_t digit = HexDigits[static_cast<unsigned char>(text[i])];
+        if (digit == 0xFF) return false;
+        result = (result << 4) | digit;
+    }
+    value = result;
+    return true;
+}
+
+/**
+ * @brief Decode the four comma separated result registers.
+ */
+auto ParseValue(std::string_view text, CpuIdValue& value) noexcept -> bool
+{
+    std::array<std::uint32_t*, 4> regs = { &value.eax, &value.ebx, &value.ecx, &value.edx };
+    for (std::size_t i = 0; i < regs.size(); i++) {
+        std::size_t comma = i < regs.size() - 1 ? text.find(',') : text.size();
+        if (comma == std::string_view::npos) return false;
+        if (!ParseHex(text.substr(0, comma), *regs[i])) return false;
+        text.remove_prefix(i < regs.size() - 1 ? comma + 1 : comma);
+    }
+    return true;
+}
+
+auto ReadRegister(XmlReader& reader, const XmlTag& tag, ICpuIdSink& sink) -> bool
+{
+    std::uint32_t eax = 0;
+    std::uint32_t ecx = 0;
+    if (tag.empty || !ParseHex(tag.eax, eax) || !ParseHex(tag.ecx, ecx)) return false;
+
+    CpuIdValue value{};
+    if (!ParseValue(reader.ReadText(), value)) return false;
+
+    XmlTag end{};
+    if (!reader.ReadTag(end) || !end.closing || end.name != "register") return false;
+
+    sink.Register(CpuIdRegister{eax, ecx, value});
+    return true;
+}
+
+auto ReadProcessor(XmlReader& reader, unsigned int cpu, ICpuIdSink& sink) -> bool
+{
+    sink.BeginProcessor(cpu);
+    XmlTag tag{};
+    CpuIdRegister reg{};
+    while (true) {
+        reader.SkipSpace();
+        if (reader.ReadFixedRegister(reg)) {
+            sink.Register(reg);
+            continue;
+        }
+
+        if (!reader.ReadTag(tag)) return false;
+        if (tag.closing) {
+            if (tag.name != "processor") return false;
+            sink.EndProcessor(cpu);
+            return true;
+        }
+        if (tag.name != "register" || !ReadRegister(reader, tag, sink)) return false;
+    }
+}
+
+}
+
+auto ReadCpuIdXml(std::string_view xml, ICpuIdSink& sink) -> bool
+{
+    XmlReader reader{xml};
+    XmlTag tag{};
+    if (!reader.ReadTag(tag) || tag.closing || tag.name != "cpuid") return false;
+
+    sink.Begin();
+    if (!tag.empty) {
+        unsigned int cpu = 0;
+        while (true) {
+            if (!reader.ReadTag(tag)) return false;
+            if (tag.closing) {
+                if (tag.name != "cpuid") return false;
+                break;
+            }
+            if (tag.name != "processor") return false;
+            if (tag.disallowed) {
+                // A disallowed CPU has no registers.
+                if (!tag.empty && (!reader.ReadTag(tag) || !tag.closing || tag.name != "processor")) return false;
+                sink.Disallowed(cpu);
+            } else if (tag.empty) {
+                sink.BeginProcessor(cpu);
+                sink.EndProcessor(cpu);
+            } else if (!ReadProcessor(reader, cpu, sink)) {
+                return false;
+            }
+            cpu++;
+        }
+    }
+
+    if (!reader.SkipMisc() || !reader.AtEnd()) return false;
+    sink.End();
+    return true;
+}
+
+auto ReadCpuIdXml(const std::string& fileName) -> std::unique_ptr<CpuIdTree>
+{
+    auto file = os::qnx::native::file::map(fileName);
+    if (!file) return nullptr;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast) - The file is text
+    std::string_view xml{reinterpret_cast<const char*>(file->Data()), file->Size()};
+    auto tree = std::make_unique<CpuIdTree>();
+    CpuIdTreeSink sink{*tree};
+    if (!ReadCpuIdXml(xml, sink)) return nullptr;
+    return tree;
+}
+
+}
@@ -0,0 +1,42 @@
+#ifndef RJCP_LIB_CPUID_TREE_CPUID_READ_XML_H
+#define RJCP_LIB_CPUID_TREE_CPUID_READ_XML_H
+
+#include "cpuid/icpuid_sink.h"
+#include "cpuid/tree/cpuid_tree.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace rjcp::cpuid::tree {
+
+/**
+ * @brief Reads XML as written by WriteCpuIdXml(), giving each element to the
+ * sink as it is parsed.
+ *
+ * The XML format doesn't record the CPU numbers, so processors are numbered
+ * from zero in the order they are found. No document is built in memory, the
+ * values are decoded directly from the text.
+ *
+ * @param xml The XML text.
+ * @param sink The sink to receive the CPUs.
+ * @return true The XML was read completely.
+ * @return false The XML is malformed. The sink may have received some of the
+ * CPUs, but End() is not called.
+ */
+auto ReadCpuIdXml(std::string_view xml, ICpuIdSink& sink) -> bool;
+
+/**
+ * @brief Reads XML from a file as written by WriteCpuIdXml() into a new tree.
+ *
+ * The file is mapped into memory and parsed without copying.
+ *
+ * @param fileName The name of the file to read.
+ * @return std::unique_ptr<CpuIdTree> The CPUs in the file, or nullptr if the
+ * file can't be read or is malformed.
+ */
+auto ReadCpuIdXml(const std::string& fileName) -> std::unique_ptr<CpuIdTree>;
+
+}
+
+#endif
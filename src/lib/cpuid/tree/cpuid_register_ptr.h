@@ -0,0 +1,111 @@
+#ifndef RJCP_LIB_CPUID_TREE_CPUID_REGISTER_PTR_H
+#define RJCP_LIB_CPUID_TREE_CPUID_REGISTER_PTR_H
+
+#include "cpuid/cpuid_register.h"
+
+#include <cstddef>
+
+namespace rjcp::cpuid::tree {
+
+/**
+ * @brief A pointer like result to a register in a CPUID tree.
+ *
+ * The tree stores registers in a compact form, so there is no CpuIdRegister
+ * object to point to when a register is found in the compact form, e.g. with
+ * CpuIdProcessor::FindLeaf(). This object holds a copy instead, and behaves
+ * like a pointer to a constant register. It is the same as nullptr if the
+ * register doesn't exist.
+ */
+class CpuIdRegisterPtr
+{
+public:
+    /**
+     * @brief Construct a pointer to no register.
+     *
+     */
+    CpuIdRegisterPtr() noexcept = default;
+
+    /**
+     * @brief Construct a pointer to no register.
+     *
+     */
+    CpuIdRegisterPtr(std::nullptr_t) noexcept { }
+
+    /**
+     * @brief Construct a pointer to the register.
+     *
+     * @param reg The register to point to. If it is not valid, this object is
+     * the same as nullptr.
+     */
+    explicit CpuIdRegisterPtr(const CpuIdRegister& reg) noexcept
+    : m_reg{reg} { }
+
+    /**
+     * @brief Get the pointer to the register.
+     *
+     * @return const CpuIdRegister* The register, or nullptr if there is no
+     * register. It is only valid while this object exists.
+     */
+    auto get() const noexcept -> const CpuIdRegister*
+    {
+        return m_reg.IsValid() ? &m_reg : nullptr;
+    }
+
+    /**
+     * @brief Access the register. It must not be nullptr.
+     *
+     * @return const CpuIdRegister* The register.
+     */
+    auto operator->() const noexcept -> const CpuIdRegister*
+    {
+        return &m_reg;
+    }
+
+    /**
+     * @brief Access the register. It must not be nullptr.
+     *
+     * @return const CpuIdRegister& The register.
+     */
+    auto operator*() const noexcept -> const CpuIdRegister&
+    {
+        return m_reg;
+    }
+
+    /**
+     * @brief Test if there is a register.
+     *
+     * @return true There is a register.
+     * @return false This is nullptr.
+     */
+    explicit operator bool() const noexcept
+    {
+        return m_reg.IsValid();
+    }
+
+    friend auto operator==(const CpuIdRegisterPtr& lhs, std::nullptr_t) noexcept -> bool
+    {
+        return !lhs.m_reg.IsValid();
+    }
+
+    friend auto operator==(std::nullptr_t, const CpuIdRegisterPtr& rhs) noexcept -> bool
+    {
+        return !rhs.m_reg.IsValid();
+    }
+
+    friend auto operator!=(const CpuIdRegisterPtr& lhs, std::nullptr_t) noexcept -> bool
+    {
+        return lhs.m_reg.IsValid();
+    }
+
+    friend auto operator!=(std::nullptr_t, const CpuIdRegisterPtr& rhs) noexcept -> bool
+    {
+        return rhs.m_reg.IsValid();
+    }
+
+private:
+    CpuIdRegister m_reg{};
+};
+
+}
+
+#endif
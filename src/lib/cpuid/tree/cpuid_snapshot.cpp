@@ -0,0 +1,168 @@
+#include "cpuid/tree/cpuid_snapshot.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace rjcp::cpuid::tree {
+
+namespace {
+
+/**
+ * @brief Check that the section is aligned and completely inside the
+ * snapshot.
+ */
+auto IsInside(const snapshot::SnapshotSection& section, std::size_t element, std::size_t size) noexcept -> bool
+{
+    if (section.offset % snapshot::Alignment != 0) return false;
+    if (section.offset > size) return false;
+    return section.count <= (size - section.offset) / element;
+}
+
+/**
+ * @brief Check that the run of elements is inside a section.
+ */
+auto IsInside(std::uint32_t first, std::uint32_t count, const snapshot::SnapshotSection& section) noexcept -> bool
+{
+    return first <= section.count && count <= section.count - first;
+}
+
+template<typename T>
+auto GetSection(const std::uint8_t* data, const snapshot::SnapshotSection& section) noexcept -> const T*
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic) - Checked by IsInside
+    return reinterpret_cast<const T*>(data + section.offset);
+}
+
+}
+
+auto CpuIdSnapshot::Open(const std::string& fileName) -> std::unique_ptr<CpuIdSnapshot>
+{
+    auto file = os::qnx::native::file::map(fileName);
+    if (!file) return nullptr;
+
+    std::unique_ptr<CpuIdSnapshot> result{new CpuIdSnapshot()};
+    result->m_file = std::move(*file);
+    if (!result->Load(result->m_file.Data(), result->m_file.Size())) return nullptr;
+    return result;
+}
+
+auto CpuIdSnapshot::Open(const std::uint8_t* data, std::size_t size) -> std::unique_ptr<CpuIdSnapshot>
+{
+    std::unique_ptr<CpuIdSnapshot> result{new CpuIdSnapshot()};
+    if (!result->Load(data, size)) return nullptr;
+    return result;
+}
+
+auto CpuIdSnapshot::Open(std::vector<std::uint8_t>&& data) -> std::unique_ptr<CpuIdSnapshot>
+{
+    // The allocation of a vector is aligned for any fundamental type.
+    std::unique_ptr<CpuIdSnapshot> result{new CpuIdSnapshot()};
+    result->m_buffer = std::move(data);
+    if (!result->Load(result->m_buffer.data(), result->m_buffer.size())) return nullptr;
+    return result;
+}
+
+auto CpuIdSnapshot::Load(const std::uint8_t* data, std::size_t size) noexcept -> bool
+{
+    // The structures are read in place, so must be aligned.
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (data == nullptr || reinterpret_cast<std::uintptr_t>(data) % snapshot::Alignment != 0) return false;
+    if (size < sizeof(snapshot::SnapshotHeader)) return false;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto* header = reinterpret_cast<const snapshot::SnapshotHeader*>(data);
+    if (header->magic != snapshot::Magic) return false;
+    if (header->version != snapshot::Version) return false;
+    if (header->byteorder != snapshot::ByteOrder) return false;
+
+    snapshot::SnapshotSection table{sizeof(snapshot::SnapshotHeader), header->cpus};
+    if (!IsInside(table, sizeof(snapshot::SnapshotCpu), size)) return false;
+    if (!IsInside(header->keys, sizeof(std::uint64_t), size)) return false;
+    if (!IsInside(header->values, sizeof(CpuIdValue), size)) return false;
+    if (!IsInside(header->deltas, sizeof(snapshot::SnapshotDelta), size)) return false;
+    if (!IsInside(header->indexes, sizeof(snapshot::SnapshotIndex), size)) return false;
+
+    const auto* cpus = GetSection<snapshot::SnapshotCpu>(data, table);
+    const auto* deltas = GetSection<snapshot::SnapshotDelta>(data, header->deltas);
+    for (std::size_t i = 0; i < header->cpus; i++) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const snapshot::SnapshotCpu& cpu = cpus[i];
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if (cpu.cpu > snapshot::MaxCpu) return false;
+        if (i > 0 && cpus[i - 1].cpu >= cpu.cpu) return false;
+        if ((cpu.flags & ~snapshot::CpuDisallowed) != 0) return false;
+        if ((cpu.flags & snapshot::CpuDisallowed) != 0 && cpu.count != 0) return false;
+        if (!IsInside(cpu.keys, cpu.count, header->keys)) return false;
+        if (!IsInside(cpu.values, cpu.count, header->values)) return false;
+        if (!IsInside(cpu.deltas, cpu.deltacount, header->deltas)) return false;
+        if (cpu.index != snapshot::NoIndex && cpu.index >= header->indexes.count) return false;
+
+        // The deltas are searched, so must be sorted and for a register that
+        // exists.
+        for (std::uint32_t d = 0; d < cpu.deltacount; d++) {
+            // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            const snapshot::SnapshotDelta& delta = deltas[cpu.deltas + d];
+            if (delta.position >= cpu.count) return false;
+            if (d > 0 && deltas[cpu.deltas + d - 1].position >= delta.position) return false;
+            // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+    }
+
+    m_cpus = cpus;
+    m_count = header->cpus;
+    m_keys = GetSection<std::uint64_t>(data, header->keys);
+    m_values = GetSection<CpuIdValue>(data, header->values);
+    m_deltas = deltas;
+    m_indexes = GetSection<snapshot::SnapshotIndex>(data, header->indexes);
+    return true;
+}
+
+auto CpuIdSnapshot::Size() const noexcept -> std::size_t
+{
+    return m_count;
+}
+
+auto CpuIdSnapshot::GetProcessor(unsigned int cpu) const noexcept -> CpuIdSnapshotProcessor
+{
+    // CPU numbers are usually dense, so the CPU is at its own position.
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    if (cpu < m_count && m_cpus[cpu].cpu == cpu) return CpuIdSnapshotProcessor{*this, m_cpus[cpu]};
+
+    const snapshot::SnapshotCpu* last = m_cpus + m_count;
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const snapshot::SnapshotCpu* found = std::lower_bound(m_cpus, last, cpu,
+        [](const snapshot::SnapshotCpu& entry, unsigned int cpu) {
+            return entry.cpu < cpu;
+        });
+    if (found == last || found->cpu != cpu) return CpuIdSnapshotProcessor{};
+    return CpuIdSnapshotProcessor{*this, *found};
+}
+
+auto CpuIdSnapshot::GetProcessorAt(std::size_t position) const noexcept -> CpuIdSnapshotProcessor
+{
+    if (position >= m_count) return CpuIdSnapshotProcessor{};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return CpuIdSnapshotProcessor{*this, m_cpus[position]};
+}
+
+void CpuIdSnapshot::Emit(ICpuIdSink& sink) const
+{
+    sink.Begin();
+    for (std::size_t position = 0; position < m_count; position++) {
+        CpuIdSnapshotProcessor processor = GetProcessorAt(position);
+        unsigned int cpu = processor.Cpu();
+        if (processor.IsDisallowed()) {
+            sink.Disallowed(cpu);
+            continue;
+        }
+
+        sink.BeginProcessor(cpu);
+        for (std::size_t reg = 0; reg < processor.Size(); reg++) {
+            sink.Register(processor.GetRegister(reg));
+        }
+        sink.EndProcessor(cpu);
+    }
+    sink.End();
+}
+
+}
@@ -0,0 +1,114 @@
+#ifndef RJCP_LIB_CPUID_TREE_CPUID_SNAPSHOT_H
+#define RJCP_LIB_CPUID_TREE_CPUID_SNAPSHOT_H
+
+#include "cpuid/icpuid_sink.h"
+#include "cpuid/tree/cpuid_snapshot_format.h"
+#include "cpuid/tree/cpuid_snapshot_processor.h"
+#include "os/qnx/native/file/mapped_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace rjcp::cpuid::tree {
+
+/**
+ * @brief A read-only view of a binary CPUID snapshot written by
+ * WriteCpuIdSnapshot().
+ *
+ * The registers are read directly from the snapshot in memory, usually a
+ * mapped file. Opening a snapshot only checks that all CPUs refer to data
+ * inside the snapshot, nothing is parsed or copied.
+ */
+class CpuIdSnapshot
+{
+public:
+    /**
+     * @brief Map the snapshot file into memory.
+     *
+     * @param fileName The name of the file to read.
+     * @return std::unique_ptr<CpuIdSnapshot> The snapshot, or nullptr if the
+     * file can't be read or isn't a valid snapshot.
+     */
+    static auto Open(const std::string& fileName) -> std::unique_ptr<CpuIdSnapshot>;
+
+    /**
+     * @brief Use the snapshot in memory.
+     *
+     * @param data The snapshot, which must be aligned to 8 bytes, and exist
+     * for the lifetime of the result.
+     * @param size The length of the snapshot in bytes.
+     * @return std::unique_ptr<CpuIdSnapshot> The snapshot, or nullptr if it
+     * isn't a valid snapshot.
+     */
+    static auto Open(const std::uint8_t* data, std::size_t size) -> std::unique_ptr<CpuIdSnapshot>;
+
+    /**
+     * @brief Take ownership of the snapshot in memory.
+     *
+     * @param data The snapshot, e.g. from GetCpuIdSnapshot().
+     * @return std::unique_ptr<CpuIdSnapshot> The snapshot, or nullptr if it
+     * isn't a valid snapshot.
+     */
+    static auto Open(std::vector<std::uint8_t>&& data) -> std::unique_ptr<CpuIdSnapshot>;
+
+    CpuIdSnapshot(const CpuIdSnapshot&) = delete;
+    auto operator=(const CpuIdSnapshot&) -> CpuIdSnapshot& = delete;
+    CpuIdSnapshot(CpuIdSnapshot&&) = delete;
+    auto operator=(CpuIdSnapshot&&) -> CpuIdSnapshot& = delete;
+    ~CpuIdSnapshot() = default;
+
+    /**
+     * @brief Get the number of CPUs in the snapshot.
+     *
+     * @return std::size_t The number of CPUs.
+     */
+    auto Size() const noexcept -> std::size_t;
+
+    /**
+     * @brief Get the CPU with the given CPU number.
+     *
+     * @param cpu The CPU number.
+     * @return CpuIdSnapshotProcessor The view of the CPU, which is false if the
+     * CPU doesn't exist.
+     */
+    auto GetProcessor(unsigned int cpu) const noexcept -> CpuIdSnapshotProcessor;
+
+    /**
+     * @brief Get the CPU at the position in the snapshot, sorted by the CPU
+     * number.
+     *
+     * @param position The position, less than Size().
+     * @return CpuIdSnapshotProcessor The view of the CPU.
+     */
+    auto GetProcessorAt(std::size_t position) const noexcept -> CpuIdSnapshotProcessor;
+
+    /**
+     * @brief Give all CPUs to the sink, in the order of the CPU number.
+     *
+     * @param sink The sink to receive the CPUs.
+     */
+    void Emit(ICpuIdSink& sink) const;
+
+private:
+    CpuIdSnapshot() noexcept = default;
+
+    auto Load(const std::uint8_t* data, std::size_t size) noexcept -> bool;
+
+    os::qnx::native::file::MappedFile m_file{};
+    std::vector<std::uint8_t> m_buffer{};
+    const snapshot::SnapshotCpu* m_cpus{};
+    std::size_t m_count{};
+    const std::uint64_t* m_keys{};
+    const CpuIdValue* m_values{};
+    const snapshot::SnapshotDelta* m_deltas{};
+    const snapshot::SnapshotIndex* m_indexes{};
+
+    friend class CpuIdSnapshotProcessor;
+};
+
+}
+
+#endif
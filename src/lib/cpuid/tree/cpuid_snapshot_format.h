@@ -0,0 +1,124 @@
+#ifndef RJCP_LIB_CPUID_TREE_CPUID_SNAPSHOT_FORMAT_H
+#define RJCP_LIB_CPUID_TREE_CPUID_SNAPSHOT_FORMAT_H
+
+#include "cpuid/cpuid_value.h"
+#include "cpuid/tree/cpuid_tree_common.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief The layout of a binary CPUID snapshot, written by
+ * WriteCpuIdSnapshot() and read by CpuIdSnapshot.
+ *
+ * The file is a header, followed by a table of CPUs, followed by the sections
+ * of keys, values, deltas and indexes. All integers are in the byte order of
+ * the machine that wrote the snapshot, which is checked when it is opened.
+ * Every section starts on an 8-byte boundary, so that the file can be used
+ * directly from memory.
+ *
+ * Each CPU refers to a run of sorted keys (EAX in the upper 32-bits, ECX in
+ * the lower 32-bits) and a run of values at the same positions. CPUs with the
+ * same leaves share the same run of keys and index. A CPU whose results are
+ * mostly the same as a previous CPU with the same leaves shares its values,
+ * and only stores the results that are different as deltas.
+ */
+namespace rjcp::cpuid::tree::snapshot {
+
+constexpr std::array<char, 8> Magic = { 'C', 'P', 'U', 'I', 'D', 'S', 'N', 'P' };
+// Version 2 added the flags of each CPU. Older files are rejected, so that a
+// disallowed CPU isn't read as a CPU without registers.
+constexpr std::uint32_t Version = 2;
+constexpr std::uint32_t ByteOrder = 0x01020304;
+constexpr std::size_t Alignment = 8;
+
+/**
+ * @brief The number of slots in the index of leaves, the same as
+ * CpuIdProcessor.
+ */
+constexpr std::size_t IndexSize = common::IndexSize;
+
+/**
+ * @brief The largest CPU number in a snapshot, the same as CpuIdTree. Readers
+ * allocate per CPU number, so a malformed snapshot can't allocate excessive
+ * memory.
+ */
+constexpr std::uint32_t MaxCpu = common::MaxCpu;
+
+/**
+ * @brief A flag in SnapshotCpu::flags for a CPU that wasn't queried, because
+ * the process isn't allowed to run on it. It has no registers.
+ */
+constexpr std::uint32_t CpuDisallowed = 0x00000001;
+
+/**
+ * @brief A value in SnapshotCpu::index when the CPU has no index.
+ */
+constexpr std::uint32_t NoIndex = 0xFFFFFFFF;
+
+/**
+ * @brief The position of a section in the file and its number of elements.
+ */
+struct SnapshotSection {
+    std::uint64_t offset;
+    std::uint64_t count;
+};
+
+/**
+ * @brief The header at the start of the file.
+ */
+struct SnapshotHeader {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t byteorder;
+    std::uint32_t cpus;
+    std::uint32_t reserved;
+    SnapshotSection keys;       // std::uint64_t
+    SnapshotSection values;     // CpuIdValue
+    SnapshotSection deltas;     // SnapshotDelta
+    SnapshotSection indexes;    // std::array<std::uint16_t, IndexSize>
+};
+
+/**
+ * @brief A CPU in the table following the header, sorted by the CPU number.
+ *
+ * The fields keys, values and deltas are the position of the first element
+ * in their sections, index is the number of the index in its section. The
+ * flags are CpuDisallowed, or zero.
+ */
+struct SnapshotCpu {
+    std::uint32_t cpu;
+    std::uint32_t count;
+    std::uint32_t keys;
+    std::uint32_t values;
+    std::uint32_t deltas;
+    std::uint32_t deltacount;
+    std::uint32_t index;
+    std::uint32_t flags;
+};
+
+/**
+ * @brief A result that is different to the shared values, sorted by position.
+ */
+struct SnapshotDelta {
+    std::uint32_t position;
+    std::uint32_t reserved;
+    CpuIdValue value;
+};
+
+/**
+ * @brief An index of subleaf 0 of the leaves, each entry being the position
+ * plus one, or zero if the leaf doesn't exist.
+ */
+using SnapshotIndex = std::array<std::uint16_t, IndexSize>;
+
+static_assert(sizeof(SnapshotHeader) == 88);
+static_assert(sizeof(SnapshotCpu) == 32);
+static_assert(sizeof(SnapshotDelta) == 24);
+static_assert(sizeof(SnapshotIndex) == IndexSize * 2);
+static_assert(sizeof(SnapshotIndex) % Alignment == 0);
+
+}
+
+#endif
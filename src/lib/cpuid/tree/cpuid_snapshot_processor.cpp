@@ -0,0 +1,98 @@
+#include "cpuid/tree/cpuid_snapshot_processor.h"
+#include "cpuid/tree/cpuid_snapshot.h"
+#include "cpuid/tree/cpuid_tree_common.h"
+
+#include <algorithm>
+
+namespace rjcp::cpuid::tree {
+
+// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic) - Runs are checked when the snapshot is opened
+
+CpuIdSnapshotProcessor::CpuIdSnapshotProcessor(const CpuIdSnapshot& snapshot, const snapshot::SnapshotCpu& cpu) noexcept
+    : m_cpu{&cpu},
+      m_keys{snapshot.m_keys + cpu.keys},
+      m_values{snapshot.m_values + cpu.values},
+      m_deltas{snapshot.m_deltas + cpu.deltas},
+      m_index{cpu.index == snapshot::NoIndex ? nullptr : snapshot.m_indexes + cpu.index}
+{ }
+
+auto CpuIdSnapshotProcessor::Cpu() const noexcept -> unsigned int
+{
+    if (!m_cpu) return 0;
+    return m_cpu->cpu;
+}
+
+auto CpuIdSnapshotProcessor::Size() const noexcept -> std::size_t
+{
+    if (!m_cpu) return 0;
+    return m_cpu->count;
+}
+
+auto CpuIdSnapshotProcessor::IsDisallowed() const noexcept -> bool
+{
+    if (!m_cpu) return false;
+    return (m_cpu->flags & snapshot::CpuDisallowed) != 0;
+}
+
+auto CpuIdSnapshotProcessor::GetValue(std::size_t position) const noexcept -> const CpuIdValue&
+{
+    if (m_cpu->deltacount != 0) {
+        const snapshot::SnapshotDelta* last = m_deltas + m_cpu->deltacount;
+        const snapshot::SnapshotDelta* delta = std::lower_bound(m_deltas, last, position,
+            [](const snapshot::SnapshotDelta& entry, std::size_t position) {
+                return entry.position < position;
+            });
+        if (delta != last && delta->position == position) return delta->value;
+    }
+    return m_values[position];
+}
+
+auto CpuIdSnapshotProcessor::GetRegister(std::size_t position) const noexcept -> CpuIdRegister
+{
+    if (position >= Size()) return CpuIdRegister{};
+    std::uint64_t key = m_keys[position];
+    return CpuIdRegister{static_cast<std::uint32_t>(key >> 32), static_cast<std::uint32_t>(key), GetValue(position)};
+}
+
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+auto CpuIdSnapshotProcessor::GetLeaf(std::uint32_t eax, std::uint32_t ecx) const noexcept -> CpuIdRegisterPtr
+{
+    if (!m_cpu) return nullptr;
+
+    const std::uint64_t* first = m_keys;
+    const std::uint64_t* last = m_keys + m_cpu->count;
+    std::size_t slot = common::GetIndexSlot(eax);
+    if (m_index && slot != snapshot::IndexSize) {
+        std::size_t position = (*m_index)[slot];
+        if (position <= m_cpu->count) {
+            if (ecx == 0) {
+                if (position == 0) return nullptr;
+                return CpuIdRegisterPtr{CpuIdRegister{eax, ecx, GetValue(position - 1)}};
+            }
+
+            // The subleafs of a leaf sort after subleaf 0, so only search from
+            // there.
+            first += position;
+        }
+    }
+
+    std::uint64_t key = (static_cast<std::uint64_t>(eax) << 32) | ecx;
+    const std::uint64_t* result = std::lower_bound(first, last, key);
+    if (result == last || *result != key) return nullptr;
+    return CpuIdRegisterPtr{CpuIdRegister{eax, ecx, GetValue(static_cast<std::size_t>(result - m_keys))}};
+}
+
+auto CpuIdSnapshotProcessor::ToProcessor() const -> CpuIdProcessor
+{
+    CpuIdProcessor processor{};
+    processor.SetDisallowed(IsDisallowed());
+    processor.Reserve(Size());
+    for (std::size_t position = 0; position < Size(); position++) {
+        processor.AddLeaf(GetRegister(position));
+    }
+    return processor;
+}
+
+// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+}
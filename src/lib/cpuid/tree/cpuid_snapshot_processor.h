@@ -0,0 +1,105 @@
+#ifndef RJCP_LIB_CPUID_TREE_CPUID_SNAPSHOT_PROCESSOR_H
+#define RJCP_LIB_CPUID_TREE_CPUID_SNAPSHOT_PROCESSOR_H
+
+#include "cpuid/cpuid_register.h"
+#include "cpuid/tree/cpuid_processor.h"
+#include "cpuid/tree/cpuid_register_ptr.h"
+#include "cpuid/tree/cpuid_snapshot_format.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rjcp::cpuid::tree {
+
+class CpuIdSnapshot;
+
+/**
+ * @brief A view of a single CPU in a CpuIdSnapshot.
+ *
+ * The view points into the snapshot, it is only valid as long as the snapshot
+ * exists. It is cheap to copy.
+ */
+class CpuIdSnapshotProcessor
+{
+public:
+    /**
+     * @brief Construct a view of no CPU.
+     *
+     */
+    CpuIdSnapshotProcessor() noexcept = default;
+
+    /**
+     * @brief Test if the view is of a CPU in the snapshot.
+     *
+     * @return true The CPU exists.
+     * @return false The CPU doesn't exist.
+     */
+    explicit operator bool() const noexcept { return m_cpu != nullptr; }
+
+    /**
+     * @brief Get the CPU number.
+     *
+     * @return unsigned int The CPU number, or zero if there is no CPU.
+     */
+    auto Cpu() const noexcept -> unsigned int;
+
+    /**
+     * @brief Get the number of registers for the CPU.
+     *
+     * @return std::size_t The number of registers.
+     */
+    auto Size() const noexcept -> std::size_t;
+
+    /**
+     * @brief Test if the CPU wasn't queried, because the process isn't allowed
+     * to run on it.
+     *
+     * @return true The CPU is disallowed, it has no registers.
+     * @return false The CPU was queried, or doesn't exist.
+     */
+    auto IsDisallowed() const noexcept -> bool;
+
+    /**
+     * @brief Get the register at the given position, sorted by EAX, then ECX.
+     *
+     * @param position The position, less than Size().
+     * @return CpuIdRegister The register.
+     */
+    auto GetRegister(std::size_t position) const noexcept -> CpuIdRegister;
+
+    /**
+     * @brief Get the register for the leaf and subleaf.
+     *
+     * Subleaf 0 of the first leaves of the standard, hypervisor and extended
+     * regions are found with an index, others with a binary search.
+     *
+     * @param eax The CPUID leaf.
+     * @param ecx The CPUID subleaf.
+     * @return CpuIdRegisterPtr The register, or nullptr if it doesn't exist.
+     */
+    auto GetLeaf(std::uint32_t eax, std::uint32_t ecx) const noexcept -> CpuIdRegisterPtr;
+
+    /**
+     * @brief Copy the registers of the CPU to a new processor.
+     *
+     * @return CpuIdProcessor The processor with all registers.
+     */
+    auto ToProcessor() const -> CpuIdProcessor;
+
+private:
+    CpuIdSnapshotProcessor(const CpuIdSnapshot& snapshot, const snapshot::SnapshotCpu& cpu) noexcept;
+
+    auto GetValue(std::size_t position) const noexcept -> const CpuIdValue&;
+
+    const snapshot::SnapshotCpu* m_cpu{};
+    const std::uint64_t* m_keys{};
+    const CpuIdValue* m_values{};
+    const snapshot::SnapshotDelta* m_deltas{};
+    const snapshot::SnapshotIndex* m_index{};
+
+    friend class CpuIdSnapshot;
+};
+
+}
+
+#endif
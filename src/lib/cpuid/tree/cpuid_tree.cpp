@@ -1,32 +1,67 @@
 #include "cpuid/tree/cpuid_tree.h"
+#include "cpuid/tree/cpuid_tree_common.h"
 
 #include <cassert>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace rjcp::cpuid::tree {
 
 CpuIdTree::CpuIdTree(CpuIdTree&& tree)
-: m_registers{std::move(tree.m_registers)}
-{ }
+: m_registers{std::move(tree.m_registers)}, m_present{std::move(tree.m_present)}, m_count{tree.m_count}
+{
+    tree.m_registers.clear();
+    tree.m_present.clear();
+    tree.m_count = 0;
+}
+
+auto CpuIdTree::operator=(const CpuIdTree& other) -> CpuIdTree&
+{
+    // The elements can't be assigned, as the CPU number is constant, so copy
+    // and then move the vector.
+    if (this == &other) return *this;
+    CpuIdTree tree{other};
+    return *this = std::move(tree);
+}
 
 auto CpuIdTree::operator=(CpuIdTree&& tree) -> CpuIdTree&
 {
     m_registers = std::move(tree.m_registers);
+    m_present = std::move(tree.m_present);
+    m_count = tree.m_count;
+    tree.m_registers.clear();
+    tree.m_present.clear();
+    tree.m_count = 0;
     return *this;
 }
 
 auto CpuIdTree::GetProcessor(unsigned int cpu) const -> const CpuIdProcessor*
 {
-    auto result = m_registers.find(cpu);
-    if (result == m_registers.cend()) return nullptr;
-    return &(*result).second;
+    if (cpu >= m_present.size() || !m_present[cpu]) return nullptr;
+    return &m_registers[cpu].second;
 }
 
 template<typename T>
 auto CpuIdTree::SetProcessorInternal(unsigned int cpu, T&& tree) -> bool
 {
-    auto value = m_registers.emplace(
-        std::make_pair(cpu, std::forward<T>(tree)));
-    return value.second;
+    if (cpu > MaxCpu) return false;
+
+    if (cpu < m_present.size()) {
+        if (m_present[cpu]) return false;
+    } else {
+        // CPUs between the last one and this one are not present. The vector
+        // grows geometrically, as CPUs are usually set in order.
+        for (std::size_t slot = m_registers.size(); slot <= cpu; slot++) {
+            m_registers.emplace_back(static_cast<unsigned int>(slot), CpuIdProcessor{});
+        }
+        m_present.resize(static_cast<std::size_t>(cpu) + 1, false);
+    }
+
+    m_registers[cpu].second = std::forward<T>(tree);
+    m_present[cpu] = true;
+    m_count++;
+    return true;
 }
 
 auto CpuIdTree::SetProcessor(unsigned int cpu, const CpuIdProcessor& tree) -> bool
@@ -39,34 +74,92 @@ auto CpuIdTree::SetProcessor(unsigned int cpu, CpuIdProcessor&& tree) -> bool
     return SetProcessorInternal(cpu, std::move(tree));
 }
 
+auto CpuIdTree::Intern() -> CpuIdTreeStats
+{
+    // Processors are grouped by their leaves. Each group has one or more
+    // processors whose storage can be shared with the others.
+    std::unordered_map<std::uint64_t, std::vector<const CpuIdProcessor*>> bases{};
+
+    for (std::size_t cpu = 0; cpu < m_registers.size(); cpu++) {
+        if (!m_present[cpu]) continue;
+        CpuIdProcessor& processor = m_registers[cpu].second;
+        if (processor.IsEmpty()) continue;
+
+        auto& group = bases[common::HashKeys(processor.m_storage->keys)];
+        bool interned = false;
+        for (const auto* base : group) {
+            if (processor.Intern(*base)) {
+                interned = true;
+                break;
+            }
+        }
+
+        if (!interned) {
+            // Storage can only be shared if it has no delta.
+            if (!processor.m_delta.empty()) processor.GetStorage();
+            group.push_back(&processor);
+        }
+    }
+
+    return Stats();
+}
+
+auto CpuIdTree::Stats() const -> CpuIdTreeStats
+{
+    std::unordered_set<const void*> storages{};
+    std::size_t leaves = 0;
+    std::size_t stored = 0;
+
+    for (auto processor = cbegin(); processor != cend(); ++processor) {
+        const CpuIdProcessor& cpu = processor->second;
+        std::size_t size = cpu.Size();
+        leaves += size;
+        if (size == 0) continue;
+
+        if (storages.insert(cpu.m_storage.get()).second) stored += size;
+        stored += cpu.m_delta.size();
+    }
+
+    return CpuIdTreeStats{leaves, stored};
+}
+
+void CpuIdTree::Emit(ICpuIdSink& sink) const
+{
+    sink.Begin();
+    for (auto processor = cbegin(); processor != cend(); ++processor) {
+        sink.Processor(processor->first, processor->second);
+    }
+    sink.End();
+}
+
 auto CpuIdTree::Size() const noexcept -> std::size_t
 {
-    return m_registers.size();
+    return m_count;
 }
 
 auto CpuIdTree::IsEmpty() const noexcept -> bool
 {
-    return m_registers.size() == 0;
+    return m_count == 0;
 }
 
 auto CpuIdTree::begin() noexcept -> iterator
 {
-    return m_registers.begin();
+    return iterator{&m_registers, &m_present, 0};
 }
 
 auto CpuIdTree::end() noexcept -> iterator
 {
-    return m_registers.end();
+    return iterator{&m_registers, &m_present, m_present.size()};
 }
 
 auto CpuIdTree::cbegin() const noexcept -> const_iterator
 {
-    return m_registers.cbegin();
+    return const_iterator{&m_registers, &m_present, 0};
 }
 
 auto CpuIdTree::cend() const noexcept -> const_iterator
 {
-    return m_registers.cend();
+    return const_iterator{&m_registers, &m_present, m_present.size()};
 }
 
 }
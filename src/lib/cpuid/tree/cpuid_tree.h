@@ -1,18 +1,116 @@
 #ifndef RJCP_LIB_CPUID_TREE_CPUID_TREE_H
 #define RJCP_LIB_CPUID_TREE_CPUID_TREE_H
 
+#include "cpuid/icpuid_sink.h"
 #include "cpuid/tree/cpuid_processor.h"
+#include "cpuid/tree/cpuid_tree_common.h"
+#include "cpuid/tree/cpuid_tree_stats.h"
 
-#include <map>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace rjcp::cpuid::tree {
 
 class CpuIdTree
 {
 private:
-    using CpuIdMap = std::map<unsigned int, CpuIdProcessor>;
+    /**
+     * @brief The processors, indexed directly by the CPU number. Each element
+     * also contains the CPU number, so that iteration can return the same pair
+     * as a map would. The CPU number is constant, so it can't be changed
+     * through an iterator.
+     */
+    using CpuIdVector = std::vector<std::pair<const unsigned int, CpuIdProcessor>>;
+
+    /**
+     * @brief A bitmap of which elements in the vector are defined. CPUs that
+     * are offline or couldn't be read are not defined.
+     */
+    using CpuIdPresent = std::vector<bool>;
+
+    /**
+     * @brief An iterator over the defined processors, in the order of the CPU
+     * number.
+     *
+     * @tparam Value The type of the element.
+     * @tparam Vector The type of the vector (constant or not constant).
+     */
+    template<typename Value, typename Vector>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::remove_const_t<Value>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value*;
+        using reference = Value&;
+
+        Iterator() noexcept = default;
+
+        Iterator(Vector* processors, const CpuIdPresent* present, std::size_t position) noexcept
+        : m_processors{processors}, m_present{present}, m_position{position}
+        {
+            Skip();
+        }
+
+        auto operator*() const noexcept -> reference
+        {
+            return (*m_processors)[m_position];
+        }
+
+        auto operator->() const noexcept -> pointer
+        {
+            return &(*m_processors)[m_position];
+        }
+
+        auto operator++() noexcept -> Iterator&
+        {
+            m_position++;
+            Skip();
+            return *this;
+        }
+
+        auto operator++(int) noexcept -> Iterator
+        {
+            Iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        auto operator==(const Iterator& other) const noexcept -> bool
+        {
+            return m_processors == other.m_processors && m_position == other.m_position;
+        }
+
+        auto operator!=(const Iterator& other) const noexcept -> bool
+        {
+            return !(*this == other);
+        }
+
+    private:
+        Vector* m_processors{nullptr};
+        const CpuIdPresent* m_present{nullptr};
+        std::size_t m_position{0};
+
+        void Skip() noexcept
+        {
+            while (m_position < m_present->size() && !(*m_present)[m_position]) {
+                m_position++;
+            }
+        }
+    };
 
 public:
+    /**
+     * @brief The largest CPU number that can be set, the same as the largest
+     * CPU accepted from the operating system. The processors are indexed by
+     * the CPU number, so a larger number would allocate excessive memory.
+     */
+    static constexpr unsigned int MaxCpu = common::MaxCpu;
+
     /**
      * @brief Construct a new CPUID Tree object.
      *
@@ -45,7 +143,7 @@ public:
      * @param other The other CPUID Tree object to copy from.
      * @return CpuIdTree& The reference to this object.
      */
-    auto operator=(const CpuIdTree& other) -> CpuIdTree& = default;
+    auto operator=(const CpuIdTree& other) -> CpuIdTree&;
 
     /**
      * @brief Move Assignment operator.
@@ -59,7 +157,12 @@ public:
      * @brief Get the Processor object for the given CPU.
      *
      * Given a CPU number, get the processor object. You should not call to get
-     * the processor object for negative values of cpu.
+     * the processor object for negative values of cpu. This is a constant time
+     * operation.
+     *
+     * The processors are stored in a vector indexed by the CPU number, so the
+     * pointer is invalidated when a processor with a larger CPU number than
+     * all others is set, as are iterators.
      *
      * @param cpu The CPU to get the processor object for.
      * @return CpuIdProcessor* The processor object that exists, or nullptr if
@@ -73,7 +176,8 @@ public:
      * @param cpu The CPU to set the processor object for.
      * @param tree The object to set.
      * @return true The object was set.
-     * @return false The object already exists and was not set.
+     * @return false The object already exists, or the CPU number is larger
+     * than MaxCpu, and was not set.
      */
     auto SetProcessor(unsigned int cpu, const CpuIdProcessor& tree) -> bool;
 
@@ -83,10 +187,41 @@ public:
      * @param cpu The CPU to set the processor object for.
      * @param tree The object to set.
      * @return true The object was set.
-     * @return false The object already exists and was not set.
+     * @return false The object already exists, or the CPU number is larger
+     * than MaxCpu, and was not set.
      */
     auto SetProcessor(unsigned int cpu, CpuIdProcessor&& tree) -> bool;
 
+    /**
+     * @brief Share identical results between processors.
+     *
+     * Processors with the same leaves, where most of the results are the same
+     * (e.g. they differ only in the APIC identifiers), share the same storage
+     * and only store the results that are different. This reduces the memory
+     * for large systems. Getting and iterating over the registers is not
+     * changed.
+     *
+     * Modifying a processor later copies its storage first, so other
+     * processors are not modified.
+     *
+     * @return CpuIdTreeStats The statistics after sharing.
+     */
+    auto Intern() -> CpuIdTreeStats;
+
+    /**
+     * @brief Get statistics on how many results are stored.
+     *
+     * @return CpuIdTreeStats The statistics of this tree.
+     */
+    auto Stats() const -> CpuIdTreeStats;
+
+    /**
+     * @brief Give all processors to a sink, in the order of the CPU number.
+     *
+     * @param sink The sink to receive the processors.
+     */
+    void Emit(ICpuIdSink& sink) const;
+
     /**
      * @brief Get the number of processors defined in this data structure.
      *
@@ -109,7 +244,7 @@ public:
      * Use this type to know what the iterator type is, instead of relying on
      * private details.
      */
-    using iterator = CpuIdMap::iterator;
+    using iterator = Iterator<CpuIdVector::value_type, CpuIdVector>;
 
     /**
      * @brief The type for the constant iterator.
@@ -117,7 +252,7 @@ public:
      * Use this type to know what the constant iterator type is, instead of
      * relying on private details.
      */
-    using const_iterator = CpuIdMap::const_iterator;
+    using const_iterator = Iterator<const CpuIdVector::value_type, const CpuIdVector>;
 
     /**
      * @brief Iterator to the first element.
@@ -148,7 +283,9 @@ public:
     auto cend() const noexcept -> const_iterator;
 
 private:
-    CpuIdMap m_registers{};
+    CpuIdVector m_registers{};
+    CpuIdPresent m_present{};
+    std::size_t m_count{0};
 
     template<typename T>
     auto SetProcessorInternal(unsigned int cpu, T&& tree) -> bool;
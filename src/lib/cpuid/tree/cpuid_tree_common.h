@@ -0,0 +1,77 @@
+#ifndef RJCP_LIB_CPUID_TREE_CPUID_TREE_COMMON_H
+#define RJCP_LIB_CPUID_TREE_CPUID_TREE_COMMON_H
+
+#include "os/qnx/native/sched/sched.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Constants and helpers shared by CpuIdProcessor, CpuIdTree and the
+ * binary snapshot, so that the data written is the same as the data in memory.
+ */
+namespace rjcp::cpuid::tree::common {
+
+/**
+ * @brief The largest CPU number in a tree or a snapshot, the same as the
+ * largest CPU accepted from the operating system.
+ */
+constexpr unsigned int MaxCpu = os::qnx::native::sched::MaxCpu;
+
+/**
+ * @brief Values are only shared with a processor with the same leaves if
+ * fewer than this fraction of the results are different.
+ */
+constexpr std::size_t MaxDeltaDivisor = 4;
+
+/**
+ * @brief The number of leaves indexed directly at the start of each of the
+ * standard, hypervisor and extended regions.
+ */
+constexpr std::size_t IndexRegionSize = 256;
+
+/**
+ * @brief The number of regions indexed directly.
+ */
+constexpr std::size_t IndexRegions = 3;
+
+/**
+ * @brief The number of slots in an index.
+ */
+constexpr std::size_t IndexSize = IndexRegions * IndexRegionSize;
+
+/**
+ * @brief Get the slot in the index for subleaf 0 of the leaf.
+ *
+ * @param eax The leaf.
+ * @return std::size_t The slot, or IndexSize if the leaf isn't indexed.
+ */
+constexpr auto GetIndexSlot(std::uint32_t eax) noexcept -> std::size_t
+{
+    std::uint32_t region = eax >> 30;
+    if (region == 3 || (eax & 0x3FFFFFFF) >= IndexRegionSize) return IndexSize;
+    return region * IndexRegionSize + (eax & 0x3FFFFFFF);
+}
+
+/**
+ * @brief Get the hash of the sorted keys of a processor, to find processors
+ * with the same leaves.
+ *
+ * @param keys The keys, with EAX in the upper 32-bits and ECX in the lower
+ * 32-bits.
+ * @return std::uint64_t The FNV-1a hash of the keys.
+ */
+inline auto HashKeys(const std::vector<std::uint64_t>& keys) noexcept -> std::uint64_t
+{
+    std::uint64_t hash = 0xCBF29CE484222325;
+    for (std::uint64_t key : keys) {
+        hash ^= key;
+        hash *= 0x100000001B3;
+    }
+    return hash;
+}
+
+}
+
+#endif
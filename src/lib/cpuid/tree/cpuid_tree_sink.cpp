@@ -0,0 +1,47 @@
+#include "cpuid/tree/cpuid_tree_sink.h"
+
+#include <utility>
+
+namespace rjcp::cpuid::tree {
+
+CpuIdTreeSink::CpuIdTreeSink(CpuIdTree& tree) noexcept
+    : m_tree{tree}
+{ }
+
+void CpuIdTreeSink::Begin()
+{ }
+
+void CpuIdTreeSink::BeginProcessor(unsigned int)
+{
+    // Processors usually have the same number of registers.
+    m_processor = CpuIdProcessor{};
+    m_processor.Reserve(m_size);
+}
+
+void CpuIdTreeSink::Register(const CpuIdRegister& reg)
+{
+    m_processor.AddLeaf(reg);
+}
+
+void CpuIdTreeSink::EndProcessor(unsigned int cpu)
+{
+    m_size = m_processor.Size();
+    m_tree.SetProcessor(cpu, std::move(m_processor));
+}
+
+void CpuIdTreeSink::End()
+{ }
+
+void CpuIdTreeSink::Disallowed(unsigned int cpu)
+{
+    CpuIdProcessor processor{};
+    processor.SetDisallowed(true);
+    m_tree.SetProcessor(cpu, std::move(processor));
+}
+
+void CpuIdTreeSink::Processor(unsigned int cpu, const CpuIdProcessor& processor)
+{
+    m_tree.SetProcessor(cpu, processor);
+}
+
+}
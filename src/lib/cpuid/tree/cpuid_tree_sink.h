@@ -0,0 +1,55 @@
+#ifndef RJCP_LIB_CPUID_TREE_CPUID_TREE_SINK_H
+#define RJCP_LIB_CPUID_TREE_CPUID_TREE_SINK_H
+
+#include "cpuid/icpuid_sink.h"
+#include "cpuid/tree/cpuid_tree.h"
+
+#include <cstddef>
+
+namespace rjcp::cpuid::tree {
+
+/**
+ * @brief A sink that builds a CpuIdTree.
+ *
+ */
+class CpuIdTreeSink final : public ICpuIdSink
+{
+public:
+    /**
+     * @brief Construct a new sink that adds processors to the tree.
+     *
+     * @param tree The tree to add to. It must exist for the lifetime of this
+     * object.
+     */
+    CpuIdTreeSink(CpuIdTree& tree) noexcept;
+
+    void Begin() override;
+    void BeginProcessor(unsigned int cpu) override;
+    void Register(const CpuIdRegister& reg) override;
+    void EndProcessor(unsigned int cpu) override;
+    void End() override;
+
+    /**
+     * @brief Adds the CPU to the tree, marked as disallowed.
+     *
+     * @param cpu The CPU number.
+     */
+    void Disallowed(unsigned int cpu) override;
+
+    /**
+     * @brief Adds the processor to the tree, sharing its storage.
+     *
+     * @param cpu The CPU number.
+     * @param processor The registers of the CPU.
+     */
+    void Processor(unsigned int cpu, const CpuIdProcessor& processor) override;
+
+private:
+    CpuIdTree& m_tree;
+    CpuIdProcessor m_processor{};
+    std::size_t m_size{};
+};
+
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef RJCP_LIB_CPUID_TREE_CPUID_TREE_STATS_H
+#define RJCP_LIB_CPUID_TREE_CPUID_TREE_STATS_H
+
+#include <cstddef>
+
+namespace rjcp::cpuid::tree {
+
+/**
+ * @brief Statistics on how many registers a CpuIdTree stores.
+ *
+ */
+class CpuIdTreeStats
+{
+public:
+    /**
+     * @brief Construct a new statistics object.
+     *
+     * @param leaves The number of leaves over all processors.
+     * @param stored The number of results that are stored.
+     */
+    CpuIdTreeStats(std::size_t leaves, std::size_t stored) noexcept
+    : m_leaves{leaves}, m_stored{stored} { }
+
+    /**
+     * @brief The number of leaves over all processors.
+     *
+     * @return std::size_t The number of leaves, as seen when iterating.
+     */
+    auto Leaves() const noexcept -> std::size_t { return m_leaves; }
+
+    /**
+     * @brief The number of results that are stored.
+     *
+     * This is less than the number of leaves if processors share results.
+     *
+     * @return std::size_t The number of results stored in memory.
+     */
+    auto Stored() const noexcept -> std::size_t { return m_stored; }
+
+    /**
+     * @brief The deduplication ratio.
+     *
+     * @return double The number of leaves for each stored result. It is 1.0 if
+     * nothing is shared, or if the tree is empty.
+     */
+    auto Ratio() const noexcept -> double
+    {
+        if (m_stored == 0) return 1.0;
+        return static_cast<double>(m_leaves) / static_cast<double>(m_stored);
+    }
+
+private:
+    std::size_t m_leaves;
+    std::size_t m_stored;
+};
+
+}
+
+#endif
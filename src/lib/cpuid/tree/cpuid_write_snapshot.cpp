@@ -0,0 +1,165 @@
+#include "cpuid/tree/cpuid_write_snapshot.h"
+#include "cpuid/tree/cpuid_snapshot_format.h"
+#include "cpuid/tree/cpuid_tree_common.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+namespace rjcp::cpuid::tree {
+
+namespace {
+
+/**
+ * @brief A run of keys already in the snapshot, with the values that other
+ * CPUs with the same keys may share.
+ */
+struct KeyRun {
+    std::uint32_t count;
+    std::uint32_t keys;
+    std::uint32_t values;
+    std::uint32_t index;
+};
+
+template<typename T>
+void AppendSection(std::vector<std::uint8_t>& buffer, snapshot::SnapshotSection& section, const std::vector<T>& data)
+{
+    section.offset = buffer.size();
+    section.count = data.size();
+    std::size_t length = data.size() * sizeof(T);
+    std::size_t padded = (length + snapshot::Alignment - 1) & ~(snapshot::Alignment - 1);
+    buffer.resize(buffer.size() + padded);
+    if (length != 0) std::memcpy(&buffer[section.offset], data.data(), length);
+}
+
+}
+
+auto GetCpuIdSnapshot(const CpuIdTree& tree) -> std::vector<std::uint8_t>
+{
+    std::vector<snapshot::SnapshotCpu> cpus{};
+    std::vector<std::uint64_t> keys{};
+    std::vector<CpuIdValue> values{};
+    std::vector<snapshot::SnapshotDelta> deltas{};
+    std::vector<snapshot::SnapshotIndex> indexes{};
+    std::unordered_multimap<std::uint64_t, KeyRun> runs{};
+
+    std::vector<std::uint64_t> cpukeys{};
+    std::vector<CpuIdValue> cpuvalues{};
+    cpus.reserve(tree.Size());
+    for (auto cpu = tree.cbegin(); cpu != tree.cend(); ++cpu) {
+        // CpuIdSnapshot rejects the file, so it isn't written.
+        if (cpu->first > snapshot::MaxCpu) return {};
+
+        const CpuIdProcessor& processor = cpu->second;
+        cpukeys.clear();
+        cpuvalues.clear();
+        for (const auto& leaf : processor.Leaves()) {
+            cpukeys.push_back(leaf.first);
+            cpuvalues.push_back(leaf.second.Value());
+        }
+
+        snapshot::SnapshotCpu entry{};
+        entry.cpu = cpu->first;
+        if (processor.IsDisallowed()) entry.flags = snapshot::CpuDisallowed;
+        entry.count = static_cast<std::uint32_t>(cpukeys.size());
+        entry.deltas = static_cast<std::uint32_t>(deltas.size());
+
+        // Share the keys with a previous CPU with the same leaves, and if the
+        // results are mostly the same, share its values too.
+        std::uint64_t hash = common::HashKeys(cpukeys);
+        const KeyRun* shared = nullptr;
+        auto [first, last] = runs.equal_range(hash);
+        for (auto run = first; run != last; ++run) {
+            if (run->second.count != cpukeys.size()) continue;
+            auto start = keys.cbegin() + static_cast<std::ptrdiff_t>(run->second.keys);
+            if (std::equal(cpukeys.cbegin(), cpukeys.cend(), start)) {
+                shared = &run->second;
+                break;
+            }
+        }
+
+        if (shared) {
+            entry.keys = shared->keys;
+            entry.index = shared->index;
+
+            std::size_t maxdelta = cpukeys.size() / common::MaxDeltaDivisor;
+            std::size_t delta = 0;
+            for (std::size_t position = 0; position < cpuvalues.size() && delta <= maxdelta; position++) {
+                if (cpuvalues[position] != values[shared->values + position]) delta++;
+            }
+
+            if (delta <= maxdelta) {
+                entry.values = shared->values;
+                for (std::size_t position = 0; position < cpuvalues.size(); position++) {
+                    if (cpuvalues[position] != values[shared->values + position]) {
+                        deltas.push_back(snapshot::SnapshotDelta{static_cast<std::uint32_t>(position), 0, cpuvalues[position]});
+                    }
+                }
+            } else {
+                entry.values = static_cast<std::uint32_t>(values.size());
+                values.insert(values.end(), cpuvalues.begin(), cpuvalues.end());
+            }
+        } else {
+            entry.keys = static_cast<std::uint32_t>(keys.size());
+            entry.values = static_cast<std::uint32_t>(values.size());
+            keys.insert(keys.end(), cpukeys.begin(), cpukeys.end());
+            values.insert(values.end(), cpuvalues.begin(), cpuvalues.end());
+
+            entry.index = snapshot::NoIndex;
+            if (cpukeys.size() < std::numeric_limits<std::uint16_t>::max()) {
+                snapshot::SnapshotIndex index{};
+                for (std::size_t position = 0; position < cpukeys.size(); position++) {
+                    auto eax = static_cast<std::uint32_t>(cpukeys[position] >> 32);
+                    auto ecx = static_cast<std::uint32_t>(cpukeys[position]);
+                    std::size_t slot = common::GetIndexSlot(eax);
+                    if (ecx == 0 && slot != snapshot::IndexSize) {
+                        index[slot] = static_cast<std::uint16_t>(position + 1);
+                    }
+                }
+                entry.index = static_cast<std::uint32_t>(indexes.size());
+                indexes.push_back(index);
+            }
+            runs.emplace(hash, KeyRun{entry.count, entry.keys, entry.values, entry.index});
+        }
+        entry.deltacount = static_cast<std::uint32_t>(deltas.size() - entry.deltas);
+        cpus.push_back(entry);
+    }
+
+    snapshot::SnapshotHeader header{};
+    header.magic = snapshot::Magic;
+    header.version = snapshot::Version;
+    header.byteorder = snapshot::ByteOrder;
+    header.cpus = static_cast<std::uint32_t>(cpus.size());
+
+    std::vector<std::uint8_t> buffer(sizeof(header));
+    snapshot::SnapshotSection table{};
+    AppendSection(buffer, table, cpus);
+    AppendSection(buffer, header.keys, keys);
+    AppendSection(buffer, header.values, values);
+    AppendSection(buffer, header.deltas, deltas);
+    AppendSection(buffer, header.indexes, indexes);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    return buffer;
+}
+
+void WriteCpuIdSnapshot(const CpuIdTree& tree, std::ostream& stream)
+{
+    std::vector<std::uint8_t> buffer = GetCpuIdSnapshot(tree);
+    if (buffer.empty()) {
+        stream.setstate(std::ios::failbit);
+        return;
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast) - Binary data
+    stream.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+}
+
+auto WriteCpuIdSnapshot(const CpuIdTree& tree, const os::qnx::native::file::FileHandle& file) -> bool
+{
+    std::vector<std::uint8_t> buffer = GetCpuIdSnapshot(tree);
+    if (buffer.empty()) return false;
+
+    return static_cast<bool>(os::qnx::native::file::write_all(file, buffer.data(), buffer.size()));
+}
+
+}
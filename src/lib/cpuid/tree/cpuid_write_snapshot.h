@@ -0,0 +1,47 @@
+#ifndef RJCP_LIB_CPUID_TREE_CPUID_WRITE_SNAPSHOT_H
+#define RJCP_LIB_CPUID_TREE_CPUID_WRITE_SNAPSHOT_H
+
+#include "cpuid/tree/cpuid_tree.h"
+#include "os/qnx/native/file/file.h"
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace rjcp::cpuid::tree {
+
+/**
+ * @brief Get the binary snapshot of the CPUID tree.
+ *
+ * See cpuid_snapshot_format.h for the layout. The snapshot can be read with
+ * CpuIdSnapshot.
+ *
+ * @param tree The CPUID data to write.
+ * @return std::vector<std::uint8_t> The snapshot, or empty if a CPU is larger
+ * than snapshot::MaxCpu.
+ */
+auto GetCpuIdSnapshot(const CpuIdTree& tree) -> std::vector<std::uint8_t>;
+
+/**
+ * @brief Writes the binary snapshot of the CPUID tree to the stream provided.
+ *
+ * @param tree The CPUID data to write.
+ * @param stream The stream to write the data to, which should be opened in
+ * binary mode. The failbit is set if the snapshot can't be written.
+ */
+void WriteCpuIdSnapshot(const CpuIdTree& tree, std::ostream& stream);
+
+/**
+ * @brief Writes the binary snapshot of the CPUID tree to the file provided.
+ *
+ * @param tree The CPUID data to write.
+ * @param file The file to write the data to.
+ * @return true The data was properly written to the file.
+ * @return false The data was not properly written to the file. It might be in
+ * an inconsistent state.
+ */
+auto WriteCpuIdSnapshot(const CpuIdTree& tree, const os::qnx::native::file::FileHandle& file) -> bool;
+
+}
+
+#endif
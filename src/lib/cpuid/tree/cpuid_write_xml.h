@@ -2,6 +2,7 @@
 #define RJCP_LIB_CPUID_TREE_CPUID_WRITE_XML_H
 
 #include "cpuid/tree/cpuid_tree.h"
+#include "os/qnx/native/file/file.h"
 
 #include <iostream>
 
@@ -16,7 +17,18 @@ namespace rjcp::cpuid::tree {
  * @return false The data was not properly written to the stream. It might be in
  * an inconsistent state.
  */
-void WriteCpuIdXml(CpuIdTree& tree, std::ostream& stream);
+void WriteCpuIdXml(const CpuIdTree& tree, std::ostream& stream);
+
+/**
+ * @brief Writes the CPUID tree directly to the file provided.
+ *
+ * @param tree The CPUID data to write.
+ * @param file The file to write the data to.
+ * @return true The data was properly written to the file.
+ * @return false The data was not properly written to the file. It might be in
+ * an inconsistent state.
+ */
+auto WriteCpuIdXml(const CpuIdTree& tree, const os::qnx::native::file::FileHandle& file) -> bool;
 
 }
 
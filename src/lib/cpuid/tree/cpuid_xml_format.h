@@ -0,0 +1,44 @@
+#ifndef RJCP_LIB_CPUID_TREE_CPUID_XML_FORMAT_H
+#define RJCP_LIB_CPUID_TREE_CPUID_XML_FORMAT_H
+
+#include <cstddef>
+#include <string_view>
+
+/**
+ * @brief The layout of the XML elements written by CpuIdXmlSink, so that the
+ * reader can decode the same layout directly.
+ */
+namespace rjcp::cpuid::tree::xml {
+
+constexpr std::string_view Begin =
+    "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+    "<cpuid type=\"x86\">\n";
+constexpr std::string_view End = "</cpuid>\n";
+constexpr std::string_view ProcessorBegin = "  <processor>\n";
+constexpr std::string_view ProcessorEnd = "  </processor>\n";
+constexpr std::string_view ProcessorDisallowed = "  <processor disallowed=\"true\" />\n";
+
+// Every register is the same length, the hex values are at known offsets.
+constexpr std::string_view RegisterIndent = "    ";
+constexpr std::string_view Register =
+    "<register eax=\"00000000\" ecx=\"00000000\">00000000,00000000,00000000,00000000</register>";
+constexpr std::size_t InEaxOffset = 15;
+constexpr std::size_t InEcxOffset = 30;
+constexpr std::size_t EaxOffset = 40;
+constexpr std::size_t EbxOffset = 49;
+constexpr std::size_t EcxOffset = 58;
+constexpr std::size_t EdxOffset = 67;
+constexpr std::size_t HexLength = 8;
+
+static_assert(Register.size() == 86);
+static_assert(Register.substr(InEaxOffset - 5, 5) == "eax=\"");
+static_assert(Register.substr(InEcxOffset - 5, 5) == "ecx=\"");
+static_assert(Register.substr(EaxOffset - 2, 2) == "\">");
+static_assert(Register[EbxOffset - 1] == ',');
+static_assert(Register[EcxOffset - 1] == ',');
+static_assert(Register[EdxOffset - 1] == ',');
+static_assert(Register.substr(EdxOffset + HexLength) == "</register>");
+
+}
+
+#endif
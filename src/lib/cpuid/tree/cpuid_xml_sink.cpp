@@ -0,0 +1,139 @@
+#include "cpuid/tree/cpuid_xml_sink.h"
+#include "cpuid/tree/cpuid_xml_format.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace rjcp::cpuid::tree {
+
+namespace {
+
+// The size of the buffer. It holds several hundred registers.
+constexpr std::size_t BufferSize = 65536;
+
+// Two upper case hex characters for each byte value.
+constexpr auto MakeHexTable() -> std::array<char, 512>
+{
+    constexpr std::string_view digits = "0123456789ABCDEF";
+    std::array<char, 512> table{};
+    for (std::size_t i = 0; i < 256; i++) {
+        table[i * 2] = digits[i >> 4];
+        table[i * 2 + 1] = digits[i & 0xF];
+    }
+    return table;
+}
+
+constexpr std::array<char, 512> HexTable = MakeHexTable();
+
+void WriteHex(char* out, std::uint32_t value) noexcept
+{
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic) - Buffer is sized by xml::Register
+    std::memcpy(out, &HexTable[((value >> 24) & 0xFF) * 2], 2);
+    std::memcpy(out + 2, &HexTable[((value >> 16) & 0xFF) * 2], 2);
+    std::memcpy(out + 4, &HexTable[((value >> 8) & 0xFF) * 2], 2);
+    std::memcpy(out + 6, &HexTable[(value & 0xFF) * 2], 2);
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+}
+
+CpuIdXmlSink::CpuIdXmlSink(std::ostream& stream)
+    : m_stream{&stream}, m_buffer(BufferSize)
+{ }
+
+CpuIdXmlSink::CpuIdXmlSink(const os::qnx::native::file::FileHandle& file)
+    : m_file{&file}, m_buffer(BufferSize)
+{ }
+
+CpuIdXmlSink::~CpuIdXmlSink()
+{
+    try {
+        Flush();
+    } catch (...) {
+        // The stream may throw, depending on its exception mask.
+    }
+}
+
+auto CpuIdXmlSink::Reserve(std::size_t length) -> char*
+{
+    if (m_length + length > m_buffer.size()) Flush();
+    char* out = &m_buffer[m_length];
+    m_length += length;
+    return out;
+}
+
+void CpuIdXmlSink::Append(const char* text, std::size_t length)
+{
+    std::memcpy(Reserve(length), text, length);
+}
+
+void CpuIdXmlSink::Flush()
+{
+    if (m_length == 0) return;
+
+    if (m_stream) {
+        m_stream->write(m_buffer.data(), static_cast<std::streamsize>(m_length));
+    } else if (m_file && m_error == 0) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast) - Bytes for the file layer
+        const auto* data = reinterpret_cast<const std::uint8_t*>(m_buffer.data());
+        auto written = os::qnx::native::file::write_all(*m_file, data, m_length);
+        if (!written) m_error = written.error();
+    }
+    m_length = 0;
+}
+
+void CpuIdXmlSink::Begin()
+{
+    Append(xml::Begin.data(), xml::Begin.size());
+}
+
+void CpuIdXmlSink::BeginProcessor(unsigned int)
+{
+    Append(xml::ProcessorBegin.data(), xml::ProcessorBegin.size());
+}
+
+void CpuIdXmlSink::Register(const CpuIdRegister& reg)
+{
+    // The line is copied and the hex values are written over the zeroes.
+    constexpr std::size_t length = xml::RegisterIndent.size() + xml::Register.size() + 1;
+    char* line = Reserve(length);
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic) - Offsets checked by xml::Register
+    std::memcpy(line, xml::RegisterIndent.data(), xml::RegisterIndent.size());
+    char* element = line + xml::RegisterIndent.size();
+    std::memcpy(element, xml::Register.data(), xml::Register.size());
+    element[xml::Register.size()] = '\n';
+    WriteHex(element + xml::InEaxOffset, reg.InEax());
+    WriteHex(element + xml::InEcxOffset, reg.InEcx());
+    WriteHex(element + xml::EaxOffset, reg.Eax());
+    WriteHex(element + xml::EbxOffset, reg.Ebx());
+    WriteHex(element + xml::EcxOffset, reg.Ecx());
+    WriteHex(element + xml::EdxOffset, reg.Edx());
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+void CpuIdXmlSink::EndProcessor(unsigned int)
+{
+    Append(xml::ProcessorEnd.data(), xml::ProcessorEnd.size());
+
+    // Each processor is written when it is complete, so that the output
+    // follows the enumeration. A processor is a few kilobytes, so this is
+    // still far fewer writes than one per line.
+    Flush();
+}
+
+void CpuIdXmlSink::Disallowed(unsigned int)
+{
+    Append(xml::ProcessorDisallowed.data(), xml::ProcessorDisallowed.size());
+    Flush();
+}
+
+void CpuIdXmlSink::End()
+{
+    Append(xml::End.data(), xml::End.size());
+    Flush();
+    if (m_stream) m_stream->flush();
+}
+
+}
@@ -0,0 +1,94 @@
+#ifndef RJCP_LIB_CPUID_TREE_CPUID_XML_SINK_H
+#define RJCP_LIB_CPUID_TREE_CPUID_XML_SINK_H
+
+#include "cpuid/icpuid_sink.h"
+#include "os/qnx/native/file/file.h"
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+namespace rjcp::cpuid::tree {
+
+/**
+ * @brief A sink that writes the CPUs as XML to a stream or a file.
+ *
+ * Each processor is formatted when it is received, so the output doesn't need
+ * the complete tree in memory. The output is collected in a buffer, which is
+ * written at the end of each processor, when it is full, and on End() or
+ * Flush().
+ */
+class CpuIdXmlSink final : public ICpuIdSink
+{
+public:
+    /**
+     * @brief Construct a new sink that writes to the stream.
+     *
+     * @param stream The stream to write to. It must exist for the lifetime of
+     * this object.
+     */
+    CpuIdXmlSink(std::ostream& stream);
+
+    /**
+     * @brief Construct a new sink that writes directly to the file handle.
+     *
+     * @param file The file to write to. It must exist for the lifetime of this
+     * object. The file is not closed by this object.
+     */
+    CpuIdXmlSink(const os::qnx::native::file::FileHandle& file);
+
+    CpuIdXmlSink(const CpuIdXmlSink&) = delete;
+    auto operator=(const CpuIdXmlSink&) -> CpuIdXmlSink& = delete;
+    CpuIdXmlSink(CpuIdXmlSink&&) = delete;
+    auto operator=(CpuIdXmlSink&&) -> CpuIdXmlSink& = delete;
+
+    void Begin() override;
+    void BeginProcessor(unsigned int cpu) override;
+    void Register(const CpuIdRegister& reg) override;
+    void EndProcessor(unsigned int cpu) override;
+    void End() override;
+
+    /**
+     * @brief Write an empty processor with the attribute disallowed="true".
+     *
+     * @param cpu The CPU number.
+     */
+    void Disallowed(unsigned int cpu) override;
+
+    /**
+     * @brief Write all buffered output.
+     *
+     */
+    void Flush();
+
+    /**
+     * @brief Get the error when writing to the file.
+     *
+     * After an error, no more output is written.
+     *
+     * @return int The errno of the first write to the file that failed, or
+     * zero if there was no error. Errors writing to a stream are given by the
+     * state of the stream.
+     */
+    auto Error() const noexcept -> int { return m_error; }
+
+    /**
+     * @brief Destroy the CpuIdXmlSink object, writing any buffered output.
+     *
+     */
+    ~CpuIdXmlSink() override;
+
+private:
+    std::ostream* m_stream{};
+    const os::qnx::native::file::FileHandle* m_file{};
+    std::vector<char> m_buffer{};
+    std::size_t m_length{};
+    int m_error{};
+
+    auto Reserve(std::size_t length) -> char*;
+    void Append(const char* text, std::size_t length);
+};
+
+}
+
+#endif
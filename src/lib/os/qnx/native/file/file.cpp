@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <climits>
 #include <iostream>
 #include <limits>
 
@@ -67,6 +68,50 @@ auto read(const FileHandle& fd, uint8_t* buf, std::size_t count) noexcept -> exp
     return static_cast<std::size_t>(bytes);
 }
 
+auto write(const FileHandle& fd, const uint8_t* buf, std::size_t count) noexcept -> expected<std::size_t>
+{
+    if (!fd)
+        return stdext::make_unexpected(EINVAL);
+    ssize_t bytes = ::write(fd.Get(), buf, count);
+    if (bytes == -1)
+        return stdext::make_unexpected(errno);
+
+    return static_cast<std::size_t>(bytes);
+}
+
+auto write_all(const FileHandle& fd, const uint8_t* buf, std::size_t count) noexcept -> expected<std::size_t>
+{
+    std::size_t written = 0;
+    while (written < count) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        auto bytes = write(fd, buf + written, count - written);
+        if (!bytes) {
+            if (bytes.error() == EINTR) continue;
+            return stdext::make_unexpected(bytes.error());
+        }
+        if (*bytes == 0)
+            return stdext::make_unexpected(EIO);
+        written += *bytes;
+    }
+    return written;
+}
+
+auto read_all(const FileHandle& fd, uint8_t* buf, std::size_t count) noexcept -> expected<std::size_t>
+{
+    std::size_t total = 0;
+    while (total < count) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        auto bytes = read(fd, buf + total, count - total);
+        if (!bytes) {
+            if (bytes.error() == EINTR) continue;
+            return stdext::make_unexpected(bytes.error());
+        }
+        if (*bytes == 0) break;
+        total += *bytes;
+    }
+    return total;
+}
+
 /**
  * @brief Converts a C++ `std::size_t` which is an unsigned integer (usually a
  * long) to the OS type.
@@ -203,4 +248,75 @@ auto pread64(const FileHandle &fd, uint8_t *buf, std::size_t count, std::size_t
     return static_cast<std::size_t>(bytes);
 }
 
+namespace {
+
+auto ciovcnt(std::size_t iovcnt) noexcept -> expected<int>
+{
+    if (iovcnt > IOV_MAX)
+        return stdext::make_unexpected(EINVAL);
+    return static_cast<int>(iovcnt);
+}
+
+}
+
+auto readv(const FileHandle &fd, const struct iovec *iov, std::size_t iovcnt) noexcept -> expected<std::size_t>
+{
+    if (!fd)
+        return stdext::make_unexpected(EINVAL);
+    auto count = ciovcnt(iovcnt);
+    if (!count)
+        return stdext::make_unexpected(count.error());
+
+    ssize_t bytes = ::readv(fd.Get(), iov, *count);
+    if (bytes == -1)
+        return stdext::make_unexpected(errno);
+
+    return static_cast<std::size_t>(bytes);
+}
+
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+auto preadv(const FileHandle &fd, const struct iovec *iov, std::size_t iovcnt, std::size_t seek) noexcept -> expected<std::size_t>
+{
+    if (!fd)
+        return stdext::make_unexpected(EINVAL);
+    auto count = ciovcnt(iovcnt);
+    if (!count)
+        return stdext::make_unexpected(count.error());
+
+#if HAVE_PREADV
+    ssize_t bytes = ::preadv(fd.Get(), iov, *count, coffset<off_t>(seek));
+    if (bytes == -1)
+        return stdext::make_unexpected(errno);
+
+    return static_cast<std::size_t>(bytes);
+#else
+    (void)iov;
+    (void)seek;
+    return stdext::make_unexpected(ENOSYS);
+#endif
+}
+
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+auto preadv2(const FileHandle &fd, const struct iovec *iov, std::size_t iovcnt, std::size_t seek, int flags) noexcept -> expected<std::size_t>
+{
+    if (!fd)
+        return stdext::make_unexpected(EINVAL);
+    auto count = ciovcnt(iovcnt);
+    if (!count)
+        return stdext::make_unexpected(count.error());
+
+#if HAVE_PREADV2
+    ssize_t bytes = ::preadv2(fd.Get(), iov, *count, coffset<off_t>(seek), flags);
+    if (bytes == -1)
+        return stdext::make_unexpected(errno);
+
+    return static_cast<std::size_t>(bytes);
+#else
+    (void)iov;
+    (void)seek;
+    (void)flags;
+    return stdext::make_unexpected(ENOSYS);
+#endif
+}
+
 }
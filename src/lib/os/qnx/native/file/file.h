@@ -5,8 +5,11 @@
 #include "stdext/expected.h"
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
 #include <cstdlib>
 #include <string>
 #include <vector>
@@ -105,6 +108,65 @@ auto read(const FileHandle& fd, std::vector<std::uint8_t>& buf, std::size_t offs
  */
 auto read(const FileHandle& fd, uint8_t* buf, std::size_t count) noexcept -> expected<std::size_t>;
 
+/**
+ * @brief Read from the file handle into the array provided, not more than
+ * count bytes.
+ *
+ * The data is written to the start, and will not exceed the size of the array.
+ * An array on the stack avoids allocating a buffer for small reads.
+ *
+ * @tparam N The size of the array.
+ * @param fd The file handle.
+ * @param buf The buffer to put the results.
+ * @param count The maximum number of bytes.
+ * @return std::size_t The number of bytes read.
+ */
+template<std::size_t N>
+auto read(const FileHandle& fd, std::array<std::uint8_t, N>& buf, std::size_t count) noexcept -> expected<std::size_t>
+{
+    return read(fd, buf.data(), std::min(count, N));
+}
+
+/**
+ * @brief Write to the file handle from the buffer provided, not more than
+ * count bytes.
+ *
+ * As with the Posix call, fewer bytes than requested may be written.
+ *
+ * @param fd The file handle.
+ * @param buf The buffer with the data to write.
+ * @param count The number of bytes to write.
+ * @return int The number of bytes written, or -1 on error.
+ */
+auto write(const FileHandle& fd, const uint8_t* buf, std::size_t count) noexcept -> expected<std::size_t>;
+
+/**
+ * @brief Write all count bytes to the file handle from the buffer provided.
+ *
+ * Short writes are continued, and writes interrupted by a signal are retried.
+ *
+ * @param fd The file handle.
+ * @param buf The buffer with the data to write.
+ * @param count The number of bytes to write.
+ * @return expected<std::size_t> The number of bytes written, which is count,
+ * or the error code. Some data may have been written on error.
+ */
+auto write_all(const FileHandle& fd, const uint8_t* buf, std::size_t count) noexcept -> expected<std::size_t>;
+
+/**
+ * @brief Read from the file handle into the buffer provided until count bytes
+ * are read, or the end of the file.
+ *
+ * Short reads are continued, and reads interrupted by a signal are retried.
+ *
+ * @param fd The file handle.
+ * @param buf The buffer to put the results.
+ * @param count The number of bytes to read.
+ * @return expected<std::size_t> The number of bytes read, which is less than
+ * count only at the end of the file, or the error code.
+ */
+auto read_all(const FileHandle& fd, uint8_t* buf, std::size_t count) noexcept -> expected<std::size_t>;
+
 /**
  * @brief Seeks to a specific position in the file
  *
@@ -157,6 +219,22 @@ auto pread(const FileHandle &fd, std::vector<std::uint8_t>& buf, std::size_t off
  */
 auto pread(const FileHandle &fd, uint8_t *buf, std::size_t count, std::size_t seek) noexcept -> expected<std::size_t>;
 
+/**
+ * @brief Reads from the file at a specific position into the array provided.
+ *
+ * @tparam N The size of the array.
+ * @param fd The file handle
+ * @param buf The buffer to put the results, not exceeding the size of the array.
+ * @param count The maximum number of bytes.
+ * @param seek The offset in the file to seek to, from the beginning
+ * @return int The number of bytes read, or -1 on error.
+ */
+template<std::size_t N>
+auto pread(const FileHandle &fd, std::array<std::uint8_t, N>& buf, std::size_t count, std::size_t seek) noexcept -> expected<std::size_t>
+{
+    return pread(fd, buf.data(), std::min(count, N), seek);
+}
+
 /**
  * @brief Reads from the file at a specific position
  *
@@ -191,6 +269,59 @@ auto pread64(const FileHandle &fd, std::vector<std::uint8_t>& buf, std::size_t o
  */
 auto pread64(const FileHandle &fd, uint8_t *buf, std::size_t count, std::size_t seek) noexcept -> expected<std::size_t>;
 
+/**
+ * @brief Reads from the file at a specific position into the array provided.
+ *
+ * @tparam N The size of the array.
+ * @param fd The file handle
+ * @param buf The buffer to put the results, not exceeding the size of the array.
+ * @param count The maximum number of bytes.
+ * @param seek The offset in the file to seek to, from the beginning
+ * @return int The number of bytes read, or -1 on error.
+ */
+template<std::size_t N>
+auto pread64(const FileHandle &fd, std::array<std::uint8_t, N>& buf, std::size_t count, std::size_t seek) noexcept -> expected<std::size_t>
+{
+    return pread64(fd, buf.data(), std::min(count, N), seek);
+}
+
+/**
+ * @brief Read from the file handle into the buffers provided, in order.
+ *
+ * @param fd The file handle.
+ * @param iov The buffers to put the results.
+ * @param iovcnt The number of buffers.
+ * @return int The number of bytes read, or -1 on error.
+ */
+auto readv(const FileHandle &fd, const struct iovec *iov, std::size_t iovcnt) noexcept -> expected<std::size_t>;
+
+/**
+ * @brief Reads from the file at a specific position into the buffers provided,
+ * in order.
+ *
+ * @param fd The file handle
+ * @param iov The buffers to put the results.
+ * @param iovcnt The number of buffers.
+ * @param seek The offset in the file to seek to, from the beginning
+ * @return int The number of bytes read, or -1 on error, e.g. ENOSYS if not
+ * supported by the Operating System.
+ */
+auto preadv(const FileHandle &fd, const struct iovec *iov, std::size_t iovcnt, std::size_t seek) noexcept -> expected<std::size_t>;
+
+/**
+ * @brief Reads from the file at a specific position into the buffers provided,
+ * in order, with flags.
+ *
+ * @param fd The file handle
+ * @param iov The buffers to put the results.
+ * @param iovcnt The number of buffers.
+ * @param seek The offset in the file to seek to, from the beginning
+ * @param flags The flags for the read, e.g. RWF_NOWAIT on Linux.
+ * @return int The number of bytes read, or -1 on error, e.g. ENOSYS if not
+ * supported by the Operating System.
+ */
+auto preadv2(const FileHandle &fd, const struct iovec *iov, std::size_t iovcnt, std::size_t seek, int flags) noexcept -> expected<std::size_t>;
+
 }
 
 #endif
@@ -0,0 +1,70 @@
+#include "os/qnx/native/file/mapped_file.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+#include <cerrno>
+#include <limits>
+#include <utility>
+
+namespace rjcp::os::qnx::native::file {
+
+MappedFile::MappedFile(const std::uint8_t* data, std::size_t size) noexcept
+    : m_data{data}, m_size{size}
+{ }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data{std::exchange(other.m_data, nullptr)}, m_size{std::exchange(other.m_size, 0)}
+{ }
+
+auto MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile&
+{
+    if (this != &other) {
+        MappedFile moved{std::move(other)};
+        std::swap(m_data, moved.m_data);
+        std::swap(m_size, moved.m_size);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() noexcept
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast) - munmap doesn't modify the data
+    if (m_data) munmap(const_cast<std::uint8_t*>(m_data), m_size);
+}
+
+auto map(const FileHandle& fd) noexcept -> expected<MappedFile>
+{
+    if (!fd)
+        return stdext::make_unexpected(EINVAL);
+
+    struct stat info{};
+    if (fstat(fd.Get(), &info) == -1)
+        return stdext::make_unexpected(errno);
+    if (info.st_size < 0)
+        return stdext::make_unexpected(EINVAL);
+    if (info.st_size == 0)
+        return MappedFile{};
+    if (static_cast<std::uintmax_t>(info.st_size) > std::numeric_limits<std::size_t>::max())
+        return stdext::make_unexpected(EFBIG);
+
+    auto size = static_cast<std::size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.Get(), 0);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast,performance-no-int-to-ptr) - Posix macro
+    if (data == MAP_FAILED)
+        return stdext::make_unexpected(errno);
+
+    return MappedFile{static_cast<const std::uint8_t*>(data), size};
+}
+
+auto map(const std::string& fileName) noexcept -> expected<MappedFile>
+{
+    auto fd = open(fileName, O_RDONLY);
+    if (!fd)
+        return stdext::make_unexpected(fd.error());
+
+    return map(*fd);
+}
+
+}
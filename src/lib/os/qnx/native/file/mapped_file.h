@@ -0,0 +1,97 @@
+#ifndef RJCP_LIB_OS_QNX_NATIVE_FILE_MAPPED_FILE_H
+#define RJCP_LIB_OS_QNX_NATIVE_FILE_MAPPED_FILE_H
+
+#include "os/qnx/native/file/file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace rjcp::os::qnx::native::file {
+
+/**
+ * @brief A read-only memory mapping of a complete file.
+ *
+ * The mapping is removed when this object is destroyed. The file handle used
+ * to create the mapping may be closed, the mapping remains valid.
+ */
+class MappedFile
+{
+public:
+    /**
+     * @brief Construct an empty mapping.
+     *
+     */
+    MappedFile() noexcept = default;
+
+    MappedFile(const MappedFile&) = delete;
+    auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+    /**
+     * @brief Move the mapping, leaving the other object empty.
+     *
+     * @param other The mapping to move.
+     */
+    MappedFile(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Move the mapping, leaving the other object empty.
+     *
+     * @param other The mapping to move.
+     * @return MappedFile& This object.
+     */
+    auto operator=(MappedFile&& other) noexcept -> MappedFile&;
+
+    /**
+     * @brief Get the start of the mapped file.
+     *
+     * @return const std::uint8_t* The start of the file, or nullptr if the
+     * mapping is empty.
+     */
+    auto Data() const noexcept -> const std::uint8_t* { return m_data; }
+
+    /**
+     * @brief Get the length of the mapped file.
+     *
+     * @return std::size_t The length of the file in bytes.
+     */
+    auto Size() const noexcept -> std::size_t { return m_size; }
+
+    /**
+     * @brief Destroy the MappedFile object, removing the mapping.
+     *
+     */
+    ~MappedFile() noexcept;
+
+private:
+    MappedFile(const std::uint8_t* data, std::size_t size) noexcept;
+
+    const std::uint8_t* m_data{};
+    std::size_t m_size{};
+
+    friend auto map(const FileHandle& fd) noexcept -> expected<MappedFile>;
+};
+
+/**
+ * @brief Maps the complete file read-only into memory.
+ *
+ * An empty file results in an empty mapping.
+ *
+ * @param fd The file handle, opened for reading.
+ * @return MappedFile The mapping of the file.
+ */
+auto map(const FileHandle& fd) noexcept -> expected<MappedFile>;
+
+/**
+ * @brief Opens the file and maps it read-only into memory.
+ *
+ * The file is closed after mapping.
+ *
+ * @param fileName The name of the file to map.
+ * @return MappedFile The mapping of the file.
+ */
+auto map(const std::string& fileName) noexcept -> expected<MappedFile>;
+
+}
+
+#endif
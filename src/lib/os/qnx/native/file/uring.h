@@ -0,0 +1,110 @@
+#ifndef RJCP_LIB_OS_QNX_NATIVE_FILE_URING_H
+#define RJCP_LIB_OS_QNX_NATIVE_FILE_URING_H
+
+#include "os/qnx/native/file/file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace rjcp::os::qnx::native::file {
+
+/**
+ * @brief A read at a specific position of a file, for reading in a batch.
+ *
+ */
+struct ReadRequest
+{
+    const FileHandle* fd;           ///< The file handle to read from.
+    std::uint8_t* buf;              ///< The buffer to put the results.
+    std::size_t count;              ///< The maximum number of bytes.
+    std::size_t seek;               ///< The offset in the file to read from.
+    expected<std::size_t> result;   ///< The number of bytes read, or the error code.
+};
+
+/**
+ * @brief Submits many reads to the Operating System with a single call.
+ *
+ * On Linux, this is an io_uring, set up with the system calls directly. Reads
+ * are placed in the submission queue, submitted together, and the completions
+ * are reaped in bulk. On other Operating Systems, creating the ring fails with
+ * ENOSYS.
+ *
+ * A ring must not be used by more than one thread at a time.
+ */
+class Uring
+{
+public:
+    /**
+     * @brief Construct an empty ring that can't read.
+     *
+     */
+    Uring() noexcept;
+
+    Uring(const Uring&) = delete;
+    auto operator=(const Uring&) -> Uring& = delete;
+
+    /**
+     * @brief Move the ring, leaving the other object empty.
+     *
+     * @param other The ring to move.
+     */
+    Uring(Uring&& other) noexcept;
+
+    /**
+     * @brief Move the ring, leaving the other object empty.
+     *
+     * @param other The ring to move.
+     * @return Uring& This object.
+     */
+    auto operator=(Uring&& other) noexcept -> Uring&;
+
+    /**
+     * @brief Destroy the ring, closing it.
+     *
+     */
+    ~Uring() noexcept;
+
+    /**
+     * @brief Check if the ring can be used for reading.
+     *
+     * @return true if the ring was set up.
+     */
+    explicit operator bool() const noexcept { return m_rings != nullptr; }
+
+    /**
+     * @brief Read all requests, submitting as many as fit in the ring at once.
+     *
+     * The result of each read is written to the request. The reads may complete
+     * in any order.
+     *
+     * @param requests The list of count reads.
+     * @param count The number of reads.
+     * @return expected<void> Nothing if all reads completed (each may have
+     * failed individually), or the error code if the ring couldn't be used.
+     */
+    auto pread(ReadRequest* requests, std::size_t count) noexcept -> expected<void>;
+
+private:
+    struct Rings;
+
+    explicit Uring(std::unique_ptr<Rings> rings) noexcept;
+
+    std::unique_ptr<Rings> m_rings{};
+
+    friend auto uring(unsigned int entries) noexcept -> expected<Uring>;
+};
+
+/**
+ * @brief Set up a ring for reading files in batches.
+ *
+ * @param entries The number of reads that can be submitted at once.
+ * @return expected<Uring> The ring, or the error code, e.g. ENOSYS if not
+ * supported by the Operating System, or EOPNOTSUPP if the ring can't read
+ * (Linux before 5.6).
+ */
+auto uring(unsigned int entries) noexcept -> expected<Uring>;
+
+}
+
+#endif
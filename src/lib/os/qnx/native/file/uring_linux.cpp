@@ -0,0 +1,246 @@
+#include "os/qnx/native/file/uring.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace rjcp::os::qnx::native::file {
+
+namespace {
+
+// The ring is shared with the kernel. The head of the submission queue and the
+// tail of the completion queue are written by the kernel.
+template<typename T>
+auto load_acquire(const T* p) noexcept -> T
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+template<typename T>
+void store_release(T* p, T value) noexcept
+{
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+auto io_uring_setup(unsigned int entries, io_uring_params* params) noexcept -> int
+{
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+auto io_uring_enter(int fd, unsigned int submit, unsigned int complete, unsigned int flags) noexcept -> int
+{
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, submit, complete, flags, nullptr, 0));
+}
+
+auto io_uring_register(int fd, unsigned int opcode, void* arg, unsigned int count) noexcept -> int
+{
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+/**
+ * @brief Check that the kernel supports reads on the ring.
+ *
+ * The ring exists since Linux 5.1, but IORING_OP_READ since 5.6, as does the
+ * probe. On older kernels the probe fails, and every read would fail.
+ */
+auto HasReadOp(int fd) noexcept -> bool
+{
+    constexpr unsigned int ops = 256;
+    alignas(io_uring_probe) std::array<std::uint8_t, sizeof(io_uring_probe) + ops * sizeof(io_uring_probe_op)> buffer{};
+    auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (io_uring_register(fd, IORING_REGISTER_PROBE, probe, ops) < 0) return false;
+    if (probe->last_op < IORING_OP_READ) return false;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index) - ops has space for all opcodes
+    return (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) != 0;
+}
+
+struct Mapping
+{
+    void* data{MAP_FAILED};
+    std::size_t size{};
+
+    Mapping() noexcept = default;
+    Mapping(const Mapping&) = delete;
+    auto operator=(const Mapping&) -> Mapping& = delete;
+    Mapping(Mapping&&) = delete;
+    auto operator=(Mapping&&) -> Mapping& = delete;
+
+    ~Mapping() noexcept
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast,performance-no-int-to-ptr) - Posix macro
+        if (data != MAP_FAILED) munmap(data, size);
+    }
+
+    auto map(int fd, std::size_t length, off_t offset) noexcept -> bool
+    {
+        size = length;
+        data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast,performance-no-int-to-ptr) - Posix macro
+        return data != MAP_FAILED;
+    }
+
+    template<typename T>
+    auto at(std::uint32_t offset) const noexcept -> T*
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic) - Offset given by the kernel
+        return reinterpret_cast<T*>(static_cast<std::uint8_t*>(data) + offset);
+    }
+};
+
+}
+
+struct Uring::Rings
+{
+    FileHandle fd{};
+    Mapping sq{};
+    Mapping cq{};
+    Mapping sqes{};
+    bool broken{};
+
+    unsigned int entries{};
+    std::uint32_t* sqTail{};
+    std::uint32_t sqMask{};
+    std::uint32_t* sqArray{};
+    io_uring_sqe* sqe{};
+
+    std::uint32_t* cqHead{};
+    std::uint32_t* cqTail{};
+    std::uint32_t cqMask{};
+    io_uring_cqe* cqe{};
+};
+
+Uring::Uring() noexcept = default;
+
+Uring::Uring(std::unique_ptr<Rings> rings) noexcept
+    : m_rings{std::move(rings)}
+{ }
+
+Uring::Uring(Uring&& other) noexcept = default;
+
+auto Uring::operator=(Uring&& other) noexcept -> Uring& = default;
+
+Uring::~Uring() noexcept = default;
+
+auto Uring::pread(ReadRequest* requests, std::size_t count) noexcept -> expected<void>
+{
+    if (!m_rings)
+        return stdext::make_unexpected(EINVAL);
+
+    Rings& r = *m_rings;
+    if (r.broken)
+        return stdext::make_unexpected(EIO);
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic) - Caller provides count elements, ring indexes are masked
+    std::size_t offset = 0;
+    while (offset < count) {
+        auto batch = static_cast<unsigned int>(std::min<std::size_t>(count - offset, r.entries));
+
+        std::uint32_t tail = *r.sqTail;
+        for (unsigned int i = 0; i < batch; i++) {
+            ReadRequest& request = requests[offset + i];
+            std::uint32_t index = (tail + i) & r.sqMask;
+            io_uring_sqe& sqe = r.sqe[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READ;
+            sqe.fd = request.fd ? request.fd->Get() : -1;
+            sqe.addr = reinterpret_cast<std::uintptr_t>(request.buf);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            sqe.len = static_cast<std::uint32_t>(request.count);
+            sqe.off = request.seek;
+            sqe.user_data = offset + i;
+            r.sqArray[index] = index;
+        }
+        store_release(r.sqTail, tail + batch);
+
+        unsigned int submitted = 0;
+        unsigned int completed = 0;
+        while (completed < batch) {
+            int result = io_uring_enter(r.fd.Get(), batch - submitted, 1, IORING_ENTER_GETEVENTS);
+            if (result < 0) {
+                if (errno == EINTR) continue;
+
+                // Submissions may be left in the ring, so it can't be used again.
+                r.broken = true;
+                return stdext::make_unexpected(errno);
+            }
+            submitted += static_cast<unsigned int>(result);
+
+            std::uint32_t head = *r.cqHead;
+            std::uint32_t cqtail = load_acquire(r.cqTail);
+            while (head != cqtail) {
+                const io_uring_cqe& cqe = r.cqe[head & r.cqMask];
+                ReadRequest& request = requests[cqe.user_data];
+                if (cqe.res < 0) {
+                    request.result = stdext::make_unexpected(-cqe.res);
+                } else {
+                    request.result = static_cast<std::size_t>(cqe.res);
+                }
+                head++;
+                completed++;
+            }
+            store_release(r.cqHead, head);
+        }
+        offset += batch;
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    return {};
+}
+
+auto uring(unsigned int entries) noexcept -> expected<Uring>
+{
+    if (entries == 0)
+        return stdext::make_unexpected(EINVAL);
+
+    io_uring_params params{};
+    int fd = io_uring_setup(entries, &params);
+    if (fd < 0)
+        return stdext::make_unexpected(errno);
+
+    std::unique_ptr<Uring::Rings> rings{new (std::nothrow) Uring::Rings{}};
+    if (!rings) {
+        close(fd);
+        return stdext::make_unexpected(ENOMEM);
+    }
+    rings->fd = FileHandle{fd};
+    if (!HasReadOp(fd))
+        return stdext::make_unexpected(EOPNOTSUPP);
+
+    std::size_t sqsize = params.sq_off.array + params.sq_entries * sizeof(std::uint32_t);
+    std::size_t cqsize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single) sqsize = std::max(sqsize, cqsize);
+
+    if (!rings->sq.map(fd, sqsize, IORING_OFF_SQ_RING))
+        return stdext::make_unexpected(errno);
+    const Mapping* cq = &rings->sq;
+    if (!single) {
+        if (!rings->cq.map(fd, cqsize, IORING_OFF_CQ_RING))
+            return stdext::make_unexpected(errno);
+        cq = &rings->cq;
+    }
+    if (!rings->sqes.map(fd, params.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES))
+        return stdext::make_unexpected(errno);
+
+    rings->entries = params.sq_entries;
+    rings->sqTail = rings->sq.at<std::uint32_t>(params.sq_off.tail);
+    rings->sqMask = *rings->sq.at<std::uint32_t>(params.sq_off.ring_mask);
+    rings->sqArray = rings->sq.at<std::uint32_t>(params.sq_off.array);
+    rings->sqe = rings->sqes.at<io_uring_sqe>(0);
+    rings->cqHead = cq->at<std::uint32_t>(params.cq_off.head);
+    rings->cqTail = cq->at<std::uint32_t>(params.cq_off.tail);
+    rings->cqMask = *cq->at<std::uint32_t>(params.cq_off.ring_mask);
+    rings->cqe = cq->at<io_uring_cqe>(params.cq_off.cqes);
+
+    return Uring{std::move(rings)};
+}
+
+}
@@ -0,0 +1,33 @@
+#include "os/qnx/native/file/uring.h"
+
+#include <cerrno>
+#include <utility>
+
+namespace rjcp::os::qnx::native::file {
+
+struct Uring::Rings
+{ };
+
+Uring::Uring() noexcept = default;
+
+Uring::Uring(std::unique_ptr<Rings> rings) noexcept
+    : m_rings{std::move(rings)}
+{ }
+
+Uring::Uring(Uring&& other) noexcept = default;
+
+auto Uring::operator=(Uring&& other) noexcept -> Uring& = default;
+
+Uring::~Uring() noexcept = default;
+
+auto Uring::pread(ReadRequest*, std::size_t) noexcept -> expected<void>
+{
+    return stdext::make_unexpected(ENOSYS);
+}
+
+auto uring(unsigned int) noexcept -> expected<Uring>
+{
+    return stdext::make_unexpected(ENOSYS);
+}
+
+}
@@ -0,0 +1,63 @@
+#include "os/qnx/native/sched/sched.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <new>
+
+namespace rjcp::os::qnx::native::sched {
+
+namespace {
+
+auto parse_number(std::string_view list, std::size_t& pos, unsigned int& value) noexcept -> bool
+{
+    std::size_t start = pos;
+    value = 0;
+    while (pos < list.size() && list[pos] >= '0' && list[pos] <= '9') {
+        value = value * 10 + static_cast<unsigned int>(list[pos] - '0');
+        if (value > MaxCpu) return false;
+        pos++;
+    }
+    return pos != start;
+}
+
+}
+
+auto parse_cpu_list(std::string_view list) noexcept -> expected<std::vector<unsigned int>>
+{
+    while (!list.empty() && (list.back() == '\n' || list.back() == ' ')) {
+        list.remove_suffix(1);
+    }
+
+    std::vector<unsigned int> cpus{};
+    std::size_t pos = 0;
+    try {
+        while (pos < list.size()) {
+            unsigned int first = 0;
+            if (!parse_number(list, pos, first)) return stdext::make_unexpected(EINVAL);
+
+            unsigned int last = first;
+            if (pos < list.size() && list[pos] == '-') {
+                pos++;
+                if (!parse_number(list, pos, last) || last < first) return stdext::make_unexpected(EINVAL);
+            }
+
+            for (unsigned int cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(cpu);
+            }
+
+            if (pos < list.size()) {
+                if (list[pos] != ',') return stdext::make_unexpected(EINVAL);
+                pos++;
+                if (pos == list.size()) return stdext::make_unexpected(EINVAL);
+            }
+        }
+    } catch (const std::bad_alloc&) {
+        return stdext::make_unexpected(ENOMEM);
+    }
+
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+}
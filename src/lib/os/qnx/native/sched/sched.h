@@ -0,0 +1,93 @@
+#ifndef RJCP_LIB_OS_QNX_NATIVE_SCHED_H
+#define RJCP_LIB_OS_QNX_NATIVE_SCHED_H
+
+#include "stdext/expected.h"
+
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Methods that abstract the scheduling of threads on processors. The
+ * mechanism to set the affinity of a thread is specific to the Operating
+ * System, so the implementation is chosen at build time.
+ *
+ * The methods here only operate on the current thread.
+ */
+namespace rjcp::os::qnx::native::sched {
+
+// A return type, where T is the return value, and the int is the `errno`.
+template<typename T>
+using expected = stdext::expected<T, int>;
+
+/**
+ * @brief The largest CPU number accepted, so that a malformed list of CPUs
+ * can't allocate excessive memory.
+ */
+constexpr unsigned int MaxCpu = 65535;
+
+/**
+ * @brief Sets the affinity of the current thread to run only on the given CPU.
+ *
+ * If the thread is not currently running on the CPU, the Operating System
+ * migrates it before returning.
+ *
+ * @param cpu The CPU number to run on.
+ * @return expected<void> Nothing on success, or the error code.
+ */
+auto set_affinity(unsigned int cpu) noexcept -> expected<void>;
+
+/**
+ * @brief Gets the CPU that the current thread is running on.
+ *
+ * Unless the thread is pinned, the OS may move it to another CPU at any time
+ * after the result is returned.
+ *
+ * @return expected<unsigned int> The CPU number, or the error code, e.g.
+ * ENOSYS if the OS can't provide it cheaply.
+ */
+auto get_cpu() noexcept -> expected<unsigned int>;
+
+/**
+ * @brief Gets the CPUs that the current thread is allowed to run on.
+ *
+ * In a container or a restricted cpuset, this is usually fewer CPUs than the
+ * system has, and the CPU numbers may not be consecutive.
+ *
+ * @return expected<std::vector<unsigned int>> The CPU numbers in ascending
+ * order, or the error code.
+ */
+auto get_affinity() noexcept -> expected<std::vector<unsigned int>>;
+
+/**
+ * @brief Gets the CPUs that are online, independent of the affinity of the
+ * current thread.
+ *
+ * @return expected<std::vector<unsigned int>> The CPU numbers in ascending
+ * order, or the error code.
+ */
+auto get_online() noexcept -> expected<std::vector<unsigned int>>;
+
+/**
+ * @brief Gets the number of CPUs that a CPU set must hold on this system.
+ *
+ * On Linux, the kernel rejects CPU sets smaller than the number of possible
+ * CPUs, which may be more than the static `CPU_SETSIZE` of 1024 CPUs. The
+ * result is determined once and then cached.
+ *
+ * @return unsigned int The number of CPUs, at least `CPU_SETSIZE` on Linux.
+ */
+auto get_cpuset_cpus() noexcept -> unsigned int;
+
+/**
+ * @brief Parses a list of CPUs in the format used by Linux, such as
+ * `0-3,8,10-11`.
+ *
+ * @param list The list of CPUs. Trailing whitespace is ignored.
+ * @return expected<std::vector<unsigned int>> The CPU numbers in ascending
+ * order, or EINVAL if the list is malformed.
+ */
+auto parse_cpu_list(std::string_view list) noexcept -> expected<std::vector<unsigned int>>;
+
+}
+
+#endif
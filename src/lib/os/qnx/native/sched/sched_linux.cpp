@@ -0,0 +1,123 @@
+#include "os/qnx/native/sched/sched.h"
+#include "os/qnx/native/file/file.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string_view>
+
+namespace rjcp::os::qnx::native::sched {
+
+namespace {
+
+/**
+ * @brief A CPU set sized for the system, freed when out of scope.
+ */
+struct CpuSetDeleter {
+    void operator()(cpu_set_t* cpuset) const noexcept
+    {
+        CPU_FREE(cpuset);
+    }
+};
+
+using CpuSet = std::unique_ptr<cpu_set_t, CpuSetDeleter>;
+
+auto read_cpu_list(const char* fileName) noexcept -> expected<std::vector<unsigned int>>
+{
+    auto fd = file::open(fileName);
+    if (!fd) return stdext::make_unexpected(fd.error());
+
+    // The file is a short list of ranges, e.g. "0-63,128-191".
+    std::array<std::uint8_t, 4096> buffer{};
+    auto bytes = file::read(*fd, buffer.data(), buffer.size());
+    if (!bytes) return stdext::make_unexpected(bytes.error());
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast) - Text
+    return parse_cpu_list(std::string_view{reinterpret_cast<const char*>(buffer.data()), *bytes});
+}
+
+auto find_cpuset_cpus() noexcept -> unsigned int
+{
+    unsigned int cpus = CPU_SETSIZE;
+    auto possible = read_cpu_list("/sys/devices/system/cpu/possible");
+    if (possible && !possible->empty()) cpus = std::max(cpus, possible->back() + 1);
+
+    long configured = sysconf(_SC_NPROCESSORS_CONF);
+    if (configured > 0) cpus = std::max(cpus, static_cast<unsigned int>(configured));
+    return cpus;
+}
+
+}
+
+auto get_cpuset_cpus() noexcept -> unsigned int
+{
+    static const unsigned int cpus = find_cpuset_cpus();
+    return cpus;
+}
+
+auto set_affinity(unsigned int cpu) noexcept -> expected<void>
+{
+    unsigned int cpus = std::max(get_cpuset_cpus(), cpu + 1);
+    CpuSet cpuset{CPU_ALLOC(cpus)};
+    if (!cpuset)
+        return stdext::make_unexpected(ENOMEM);
+
+    std::size_t size = CPU_ALLOC_SIZE(cpus);
+    CPU_ZERO_S(size, cpuset.get());
+    CPU_SET_S(cpu, size, cpuset.get());
+
+    // The pthread functions return the error, they don't set errno.
+    int result = pthread_setaffinity_np(pthread_self(), size, cpuset.get());
+    if (result != 0)
+        return stdext::make_unexpected(result);
+
+    return {};
+}
+
+auto get_cpu() noexcept -> expected<unsigned int>
+{
+    // This is implemented in the vDSO, without a system call.
+    int cpu = sched_getcpu();
+    if (cpu < 0)
+        return stdext::make_unexpected(errno);
+
+    return static_cast<unsigned int>(cpu);
+}
+
+auto get_affinity() noexcept -> expected<std::vector<unsigned int>>
+{
+    unsigned int cpus = get_cpuset_cpus();
+    CpuSet cpuset{CPU_ALLOC(cpus)};
+    if (!cpuset)
+        return stdext::make_unexpected(ENOMEM);
+
+    std::size_t size = CPU_ALLOC_SIZE(cpus);
+    CPU_ZERO_S(size, cpuset.get());
+    if (sched_getaffinity(0, size, cpuset.get()) != 0)
+        return stdext::make_unexpected(errno);
+
+    std::vector<unsigned int> result{};
+    try {
+        result.reserve(static_cast<std::size_t>(CPU_COUNT_S(size, cpuset.get())));
+        for (unsigned int cpu = 0; cpu < size * 8; cpu++) {
+            if (CPU_ISSET_S(cpu, size, cpuset.get())) result.push_back(cpu);
+        }
+    } catch (const std::bad_alloc&) {
+        return stdext::make_unexpected(ENOMEM);
+    }
+    return result;
+}
+
+auto get_online() noexcept -> expected<std::vector<unsigned int>>
+{
+    return read_cpu_list("/sys/devices/system/cpu/online");
+}
+
+}
@@ -0,0 +1,74 @@
+#include "os/qnx/native/sched/sched.h"
+
+#ifdef __QNXNTO__
+
+#include <sys/neutrino.h>
+#include <sys/syspage.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <new>
+
+namespace rjcp::os::qnx::native::sched {
+
+auto set_affinity(unsigned int cpu) noexcept -> expected<void>
+{
+    constexpr unsigned int maxcpus = sizeof(unsigned int) * 8;
+    if (cpu >= maxcpus)
+        return stdext::make_unexpected(EINVAL);
+
+    unsigned int runmask = 1U << cpu;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast,performance-no-int-to-ptr) - Systems programming
+    if (ThreadCtl(_NTO_TCTL_RUNMASK, reinterpret_cast<void*>(static_cast<std::uintptr_t>(runmask))) == -1)
+        return stdext::make_unexpected(errno);
+
+    return {};
+}
+
+auto get_cpu() noexcept -> expected<unsigned int>
+{
+    return stdext::make_unexpected(ENOSYS);
+}
+
+auto get_cpuset_cpus() noexcept -> unsigned int
+{
+    // The runmask is a single integer.
+    return sizeof(unsigned int) * 8;
+}
+
+auto get_affinity() noexcept -> expected<std::vector<unsigned int>>
+{
+    // A runmask of zero only gets the current runmask, without changing it.
+    unsigned int runmask = 0;
+    if (ThreadCtl(_NTO_TCTL_RUNMASK_GET_AND_SET, &runmask) == -1)
+        return stdext::make_unexpected(errno);
+
+    constexpr unsigned int maxcpus = sizeof(unsigned int) * 8;
+    unsigned int numcpu = _syspage_ptr->num_cpu;
+    std::vector<unsigned int> cpus{};
+    try {
+        for (unsigned int cpu = 0; cpu < numcpu && cpu < maxcpus; cpu++) {
+            if (runmask & (1U << cpu)) cpus.push_back(cpu);
+        }
+    } catch (const std::bad_alloc&) {
+        return stdext::make_unexpected(ENOMEM);
+    }
+    return cpus;
+}
+
+auto get_online() noexcept -> expected<std::vector<unsigned int>>
+{
+    std::vector<unsigned int> cpus{};
+    try {
+        for (unsigned int cpu = 0; cpu < _syspage_ptr->num_cpu; cpu++) {
+            cpus.push_back(cpu);
+        }
+    } catch (const std::bad_alloc&) {
+        return stdext::make_unexpected(ENOMEM);
+    }
+    return cpus;
+}
+
+}
+
+#endif
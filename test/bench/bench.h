@@ -0,0 +1,85 @@
+#ifndef RJCP_TEST_BENCH_BENCH_H
+#define RJCP_TEST_BENCH_BENCH_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace rjcp::bench {
+
+/**
+ * @brief Register a benchmark to be run by the benchmark executable.
+ *
+ * Use the macro BENCHMARK instead of calling this directly.
+ *
+ * @param name The name of the benchmark.
+ * @param func The function to run.
+ * @return int A dummy value, so that it can be used as a static initialiser.
+ */
+auto Register(std::string name, std::function<void()> func) -> int;
+
+/**
+ * @brief Print the result of a measurement.
+ *
+ * @param name The name of the measurement.
+ * @param iterations The number of iterations measured.
+ * @param nsop The average time in nanoseconds per iteration.
+ */
+void Print(const std::string& name, std::size_t iterations, double nsop);
+
+/**
+ * @brief Prevent the compiler from optimising away a computed value.
+ *
+ * @tparam T The type of the value.
+ * @param value The value that must be kept.
+ */
+template<typename T>
+inline void DoNotOptimise(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Measure the time for a function and print the result.
+ *
+ * The function is run once to warm up, and then the given number of iterations
+ * is timed. The average time per iteration is printed.
+ *
+ * @tparam Func The type of the function to measure.
+ * @param name The name to print for the measurement.
+ * @param iterations The number of times to call the function.
+ * @param func The function to measure.
+ * @return double The average time in nanoseconds per iteration.
+ */
+template<typename Func>
+auto Measure(const std::string& name, std::size_t iterations, Func&& func) -> double
+{
+    func();
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; i++) {
+        func();
+    }
+    auto stop = std::chrono::steady_clock::now();
+
+    std::chrono::duration<double, std::nano> elapsed = stop - start;
+    double result = elapsed.count() / static_cast<double>(iterations);
+    Print(name, iterations, result);
+    return result;
+}
+
+}
+
+#define RJCP_BENCH_CONCAT2(a, b) a##b
+#define RJCP_BENCH_CONCAT(a, b) RJCP_BENCH_CONCAT2(a, b)
+
+/**
+ * @brief Define a benchmark, which is run by the benchmark executable.
+ */
+#define BENCHMARK(name) \
+    static void name(); \
+    static int RJCP_BENCH_CONCAT(name, _registered) = rjcp::bench::Register(#name, name); \
+    static void name()
+
+#endif
@@ -0,0 +1,39 @@
+#include "bench.h"
+
+#include "cpuid/cpuid_boot_cache.h"
+#include "cpuid/cpuid_boot_cache_config.h"
+#include "cpuid/cpuid_factory.h"
+#include "cpuid/cpuid_native_config.h"
+#include "cpuid/get_cpuid.h"
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+namespace rjcp::cpuid {
+
+BENCHMARK(CpuIdBootCacheLoad)
+{
+    std::string directory{"/tmp/cpuid_bench_XXXXXX"};
+    if (mkdtemp(&directory[0]) == nullptr) return;
+
+    std::shared_ptr<ICpuIdFactory> native = CreateCpuIdFactory(CpuIdNativeConfig{});
+    bench::Measure("GetCpuId(CpuIdNative)", 10, [&native]() {
+        bench::DoNotOptimise(GetCpuId(*native)->Size());
+    });
+
+    // The first factory writes the cache, all others read it.
+    CpuIdBootCacheConfig config{native, directory};
+    bench::DoNotOptimise(CreateCpuIdFactory(config)->threads());
+    bench::Measure("GetCpuId(CpuIdBootCache)", 10, [&config]() {
+        auto factory = CreateCpuIdFactory(config);
+        bench::DoNotOptimise(GetCpuId(*factory)->Size());
+    });
+
+    unlink((directory + "/cpuid.cache").c_str());
+    rmdir(directory.c_str());
+}
+
+}
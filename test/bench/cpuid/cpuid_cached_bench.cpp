@@ -0,0 +1,42 @@
+#include "bench.h"
+
+#include "cpuid/cpuid_cached_config.h"
+#include "cpuid/cpuid_factory.h"
+#include "cpuid/cpuid_native_config.h"
+#include "cpuid/get_cpuid.h"
+
+#include <memory>
+
+namespace rjcp::cpuid {
+
+namespace {
+
+constexpr std::size_t Iterations = 10000;
+
+}
+
+BENCHMARK(CpuIdCached)
+{
+    std::shared_ptr<ICpuIdFactory> native = CreateCpuIdFactory(CpuIdNativeConfig{});
+    auto nativeCpuId = native->create(0);
+    bench::Measure("CpuIdNative", Iterations, [&nativeCpuId]() {
+        bench::DoNotOptimise(nativeCpuId->GetCpuId(1, 0).Eax());
+    });
+
+    CpuIdCachedConfig config{native, true};
+    auto cached = CreateCpuIdFactory(config);
+    auto cachedCpuId = cached->create(0);
+    bench::Measure("CpuIdCached", Iterations, [&cachedCpuId]() {
+        bench::DoNotOptimise(cachedCpuId->GetCpuId(1, 0).Eax());
+    });
+
+    bench::Measure("GetCpuId(CpuIdNative)", 10, [&native]() {
+        bench::DoNotOptimise(GetCpuId(*native)->Size());
+    });
+
+    bench::Measure("GetCpuId(CpuIdCached)", 10, [&cached]() {
+        bench::DoNotOptimise(GetCpuId(*cached)->Size());
+    });
+}
+
+}
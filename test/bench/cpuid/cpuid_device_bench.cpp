@@ -0,0 +1,96 @@
+#include "bench.h"
+
+#include "cpuid/cpuid_device.h"
+#include "cpuid/cpuid_device_config.h"
+#include "cpuid/cpuid_factory.h"
+#include "cpuid/cpuid_native_config.h"
+#include "cpuid/get_cpuid.h"
+
+#include <string>
+#include <vector>
+
+namespace rjcp::cpuid {
+
+namespace {
+
+constexpr std::size_t Iterations = 20;
+
+void MeasureDevice(const std::string& name, DeviceAccessMethod method)
+{
+    auto factory = CreateCpuIdFactory(CpuIdDeviceConfig{method});
+    bench::Measure(name, Iterations, [&factory]() {
+        bench::DoNotOptimise(GetCpuId(*factory)->Size());
+    });
+}
+
+void MeasureBatch(const std::string& name, DeviceAccessMethod method, const std::vector<CpuIdQuery>& queries)
+{
+    CpuIdDevice cpuid{0, method};
+    std::vector<CpuIdRegister> registers(queries.size());
+    bench::Measure(name, Iterations, [&]() {
+        cpuid.GetCpuId(queries.data(), registers.data(), queries.size());
+        bench::DoNotOptimise(registers[0].Eax());
+    });
+}
+
+}
+
+BENCHMARK(CpuIdDeviceAccess)
+{
+    MeasureDevice("GetCpuId(seek)", DeviceAccessMethod::seek);
+    MeasureDevice("GetCpuId(pread)", DeviceAccessMethod::pread);
+    MeasureDevice("GetCpuId(uring)", DeviceAccessMethod::uring);
+    MeasureDevice("GetCpuId(preadv)", DeviceAccessMethod::preadv);
+
+    // The queries for all leaves of the first CPU, as made for every CPU
+    // after the first from the plan.
+    auto native = CreateCpuIdFactory(CpuIdNativeConfig{});
+    auto tree = GetCpuId(*native);
+    std::vector<CpuIdQuery> queries{};
+    for (auto& [cpu, processor] : *tree) {
+        for (const auto& [key, reg] : processor) {
+            queries.push_back({reg.InEax(), reg.InEcx()});
+        }
+        break;
+    }
+    MeasureBatch("Walk(seek)", DeviceAccessMethod::seek, queries);
+    MeasureBatch("Walk(pread)", DeviceAccessMethod::pread, queries);
+    MeasureBatch("Walk(uring)", DeviceAccessMethod::uring, queries);
+    MeasureBatch("Walk(preadv)", DeviceAccessMethod::preadv, queries);
+}
+
+BENCHMARK(CpuIdDevicePool)
+{
+    // A new configuration opens the devices for every snapshot.
+    bench::Measure("Snapshot(open)", Iterations, []() {
+        auto factory = CreateCpuIdFactory(CpuIdDeviceConfig{DeviceAccessMethod::pread});
+        bench::DoNotOptimise(GetCpuId(*factory)->Size());
+    });
+
+    CpuIdDeviceConfig config{DeviceAccessMethod::pread};
+    bench::Measure("Snapshot(pool)", Iterations, [&config]() {
+        auto factory = CreateCpuIdFactory(config);
+        bench::DoNotOptimise(GetCpuId(*factory)->Size());
+    });
+}
+
+BENCHMARK(CpuIdDeviceParallel)
+{
+    CpuIdDeviceConfig config{DeviceAccessMethod::pread};
+    auto factory = CreateCpuIdFactory(config);
+    bench::Measure("Sequential", Iterations, [&factory]() {
+        bench::DoNotOptimise(GetCpuId(*factory)->Size());
+    });
+
+    for (unsigned int workers : {2U, 4U, 8U}) {
+        std::string name = std::to_string(workers) + " workers";
+        bench::Measure(name + " (pinned)", Iterations, [&factory, workers]() {
+            bench::DoNotOptimise(GetCpuId(*factory, GetCpuIdOptions{workers, false, true})->Size());
+        });
+        bench::Measure(name + " (unpinned)", Iterations, [&factory, workers]() {
+            bench::DoNotOptimise(GetCpuId(*factory, GetCpuIdOptions{workers, false, false})->Size());
+        });
+    }
+}
+
+}
@@ -0,0 +1,87 @@
+#include "bench.h"
+
+#include "cpuid/cpuid_native.h"
+#include "os/qnx/native/sched/sched.h"
+
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace rjcp::cpuid {
+
+namespace {
+
+constexpr std::size_t Iterations = 10000;
+
+void PrintQueries(const std::string& name, double nsop)
+{
+    std::cout << "  " << name << ": " << static_cast<std::uint64_t>(1e9 / nsop) << " queries/s" << std::endl;
+}
+
+#if defined(__linux__)
+void FreeCpuSet(cpu_set_t* cpuset)
+{
+    CPU_FREE(cpuset);
+}
+#endif
+
+}
+
+BENCHMARK(CpuIdNativePinning)
+{
+    auto cpus = os::qnx::native::sched::get_affinity();
+    if (!cpus) return;
+    unsigned int cpu = cpus->front();
+
+#if defined(__linux__)
+    // The affinity is always changed and restored for each query, as the
+    // native reader did before checking the current CPU.
+    std::size_t cpusetcpus = os::qnx::native::sched::get_cpuset_cpus();
+    if (cpu >= cpusetcpus) cpusetcpus = cpu + 1;
+    std::size_t size = CPU_ALLOC_SIZE(cpusetcpus);
+    std::unique_ptr<cpu_set_t, void (*)(cpu_set_t*)> pinned{CPU_ALLOC(cpusetcpus), FreeCpuSet};
+    std::unique_ptr<cpu_set_t, void (*)(cpu_set_t*)> saved{CPU_ALLOC(cpusetcpus), FreeCpuSet};
+    if (!pinned || !saved) return;
+    CPU_ZERO_S(size, pinned.get());
+    CPU_SET_S(cpu, size, pinned.get());
+
+    double always = bench::Measure("Always pin", Iterations, [&]() {
+        pthread_t thread = pthread_self();
+        if (pthread_getaffinity_np(thread, size, saved.get()) != 0) return;
+        if (pthread_setaffinity_np(thread, size, pinned.get()) != 0) return;
+        bench::DoNotOptimise(CpuIdNative::GetCpuIdCurrentThread(1, 0).Eax());
+        pthread_setaffinity_np(thread, size, saved.get());
+    });
+    PrintQueries("Always pin", always);
+#endif
+
+    // The thread may run on any CPU, so the reader pins it for each query.
+    CpuIdNative native{cpu};
+    double reader = bench::Measure("CpuIdNative", Iterations, [&native]() {
+        bench::DoNotOptimise(native.GetCpuId(1, 0).Eax());
+    });
+    PrintQueries("CpuIdNative", reader);
+
+    // A thread already pinned to the CPU, as the workers of GetCpuId(), only
+    // reads the affinity.
+    std::thread worker{[&native, cpu]() {
+        if (!os::qnx::native::sched::set_affinity(cpu)) return;
+        double pinned = bench::Measure("CpuIdNative (pinned)", Iterations, [&native]() {
+            bench::DoNotOptimise(native.GetCpuId(1, 0).Eax());
+        });
+        PrintQueries("CpuIdNative (pinned)", pinned);
+    }};
+    worker.join();
+
+    double current = bench::Measure("CurrentThread", Iterations, []() {
+        bench::DoNotOptimise(CpuIdNative::GetCpuIdCurrentThread(1, 0).Eax());
+    });
+    PrintQueries("CurrentThread", current);
+}
+
+}
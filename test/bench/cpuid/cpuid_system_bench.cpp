@@ -0,0 +1,25 @@
+#include "bench.h"
+
+#include "cpuid/cpuid_factory.h"
+#include "cpuid/cpuid_native_config.h"
+#include "cpuid/cpuid_system.h"
+
+namespace rjcp::cpuid {
+
+BENCHMARK(CpuIdSystemGet)
+{
+    // The cost that each consumer pays if it enumerates the CPUs itself.
+    auto factory = CreateCpuIdFactory(CpuIdNativeConfig{});
+    bench::Measure("CpuIdSystem(CpuIdNative)", 10, [&factory]() {
+        CpuIdSystem system{*factory};
+        bench::DoNotOptimise(system.Size());
+    });
+
+    // The cost for consumers after the first.
+    bench::DoNotOptimise(CpuIdSystem::Get().Size());
+    bench::Measure("CpuIdSystem::Get().GetLeaf", 100000, []() {
+        bench::DoNotOptimise(CpuIdSystem::Get().GetLeaf(0, 1, 0));
+    });
+}
+
+}
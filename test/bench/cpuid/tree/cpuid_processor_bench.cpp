@@ -0,0 +1,167 @@
+#include "bench.h"
+
+#include "cpuid/cpuid_register.h"
+#include "cpuid/tree/cpuid_processor.h"
+
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace rjcp::cpuid::tree {
+
+namespace {
+
+/**
+ * @brief The leaves that a typical modern CPU reports, in enumeration order.
+ */
+auto GetLeaves() -> std::vector<CpuIdRegister>
+{
+    std::vector<CpuIdRegister> leaves{};
+    auto add = [&leaves](std::uint32_t eax, std::uint32_t ecx) {
+        leaves.emplace_back(eax, ecx, eax ^ 0x11111111, ecx ^ 0x22222222, eax, ecx);
+    };
+
+    for (std::uint32_t eax = 0; eax <= 0x20; eax++) {
+        switch (eax) {
+        case 0x04:
+            for (std::uint32_t ecx = 0; ecx < 5; ecx++) add(eax, ecx);
+            break;
+        case 0x07:
+        case 0x0B:
+        case 0x1F:
+            for (std::uint32_t ecx = 0; ecx < 3; ecx++) add(eax, ecx);
+            break;
+        case 0x0D:
+            for (std::uint32_t ecx = 0; ecx < 64; ecx++) add(eax, ecx);
+            break;
+        case 0x10:
+        case 0x12:
+            for (std::uint32_t ecx = 0; ecx < 4; ecx++) add(eax, ecx);
+            break;
+        default:
+            add(eax, 0);
+            break;
+        }
+    }
+    for (std::uint32_t eax = 0x80000000; eax <= 0x80000028; eax++) {
+        if (eax == 0x8000001D) {
+            for (std::uint32_t ecx = 0; ecx < 5; ecx++) add(eax, ecx);
+        } else {
+            add(eax, 0);
+        }
+    }
+    return leaves;
+}
+
+/**
+ * @brief The node based container previously used by CpuIdProcessor, as a
+ * baseline.
+ */
+using CpuIdMap = std::map<std::pair<std::uint32_t, std::uint32_t>, CpuIdRegister>;
+
+constexpr std::size_t BuildIterations = 20000;
+constexpr std::size_t LookupIterations = 20000;
+
+}
+
+BENCHMARK(CpuIdProcessorBuild)
+{
+    const auto leaves = GetLeaves();
+
+    bench::Measure("std::map", BuildIterations, [&leaves]() {
+        CpuIdMap map{};
+        for (const auto& leaf : leaves) {
+            map.emplace(std::make_pair(leaf.InEax(), leaf.InEcx()), leaf);
+        }
+        bench::DoNotOptimise(map.size());
+    });
+
+    bench::Measure("CpuIdProcessor", BuildIterations, [&leaves]() {
+        CpuIdProcessor processor{};
+        for (const auto& leaf : leaves) {
+            processor.AddLeaf(leaf);
+        }
+        bench::DoNotOptimise(processor.Size());
+    });
+
+    bench::Measure("CpuIdProcessor (reserved)", BuildIterations, [&leaves]() {
+        CpuIdProcessor processor{};
+        processor.Reserve(leaves.size());
+        for (const auto& leaf : leaves) {
+            processor.AddLeaf(leaf);
+        }
+        bench::DoNotOptimise(processor.Size());
+    });
+}
+
+BENCHMARK(CpuIdProcessorLookup)
+{
+    const auto leaves = GetLeaves();
+
+    CpuIdMap map{};
+    CpuIdProcessor processor{};
+    for (const auto& leaf : leaves) {
+        map.emplace(std::make_pair(leaf.InEax(), leaf.InEcx()), leaf);
+        processor.AddLeaf(leaf);
+    }
+
+    // Look up every leaf, and a missing subleaf for every leaf, which is what
+    // decoding the tree does.
+    bench::Measure("std::map", LookupIterations, [&leaves, &map]() {
+        std::uint32_t sum = 0;
+        for (const auto& leaf : leaves) {
+            auto found = map.find(std::make_pair(leaf.InEax(), leaf.InEcx()));
+            if (found != map.end()) sum += found->second.Eax();
+            auto missing = map.find(std::make_pair(leaf.InEax(), 0x100));
+            if (missing != map.end()) sum += missing->second.Eax();
+        }
+        bench::DoNotOptimise(sum);
+    });
+
+    bench::Measure("CpuIdProcessor", LookupIterations, [&leaves, &processor]() {
+        std::uint32_t sum = 0;
+        for (const auto& leaf : leaves) {
+            auto found = processor.FindLeaf(leaf.InEax(), leaf.InEcx());
+            if (found != nullptr) sum += found->Eax();
+            auto missing = processor.FindLeaf(leaf.InEax(), 0x100);
+            if (missing != nullptr) sum += missing->Eax();
+        }
+        bench::DoNotOptimise(sum);
+    });
+}
+
+BENCHMARK(CpuIdProcessorScan)
+{
+    const auto leaves = GetLeaves();
+
+    CpuIdMap map{};
+    CpuIdProcessor processor{};
+    for (const auto& leaf : leaves) {
+        map.emplace(std::make_pair(leaf.InEax(), leaf.InEcx()), leaf);
+        processor.AddLeaf(leaf);
+    }
+    CpuIdProcessor copy = processor;
+
+    bench::Measure("std::map iterate", LookupIterations, [&map]() {
+        std::uint32_t sum = 0;
+        for (const auto& leaf : map) {
+            sum += leaf.second.Eax() ^ leaf.second.Edx();
+        }
+        bench::DoNotOptimise(sum);
+    });
+
+    bench::Measure("CpuIdProcessor iterate", LookupIterations, [&processor]() {
+        std::uint32_t sum = 0;
+        for (const auto& leaf : processor) {
+            sum += leaf.second.Eax() ^ leaf.second.Edx();
+        }
+        bench::DoNotOptimise(sum);
+    });
+
+    bench::Measure("CpuIdProcessor compare", LookupIterations, [&processor, &copy]() {
+        bench::DoNotOptimise(processor == copy);
+    });
+}
+
+}
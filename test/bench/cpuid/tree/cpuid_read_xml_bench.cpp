@@ -0,0 +1,45 @@
+#include "bench.h"
+
+#include "cpuid/cpuid_register.h"
+#include "cpuid/tree/cpuid_read_xml.h"
+#include "cpuid/tree/cpuid_tree.h"
+#include "cpuid/tree/cpuid_tree_sink.h"
+#include "cpuid/tree/cpuid_write_xml.h"
+
+#include <sstream>
+#include <string>
+
+namespace rjcp::cpuid::tree {
+
+namespace {
+
+constexpr unsigned int Cpus = 500;
+constexpr unsigned int Leaves = 64;
+constexpr std::size_t Iterations = 20;
+
+}
+
+BENCHMARK(CpuIdXmlRead)
+{
+    CpuIdTree tree{};
+    for (unsigned int cpunum = 0; cpunum < Cpus; cpunum++) {
+        CpuIdProcessor processor{};
+        for (unsigned int leaf = 0; leaf < Leaves; leaf++) {
+            processor.AddLeaf(CpuIdRegister{leaf, 0, 0x000906A3 + leaf, cpunum << 24, 0x7FFAFBFF, 0xBFEBFBFF});
+        }
+        tree.SetProcessor(cpunum, std::move(processor));
+    }
+
+    std::stringstream stream{};
+    WriteCpuIdXml(tree, stream);
+    std::string xml = stream.str();
+
+    bench::Measure("ReadCpuIdXml 500 CPUs", Iterations, [&xml]() {
+        CpuIdTree result{};
+        CpuIdTreeSink sink{result};
+        bench::DoNotOptimise(ReadCpuIdXml(xml, sink));
+        bench::DoNotOptimise(result.Size());
+    });
+}
+
+}
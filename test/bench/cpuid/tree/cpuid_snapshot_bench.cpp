@@ -0,0 +1,57 @@
+#include "bench.h"
+
+#include "cpuid/cpuid_register.h"
+#include "cpuid/tree/cpuid_read_xml.h"
+#include "cpuid/tree/cpuid_snapshot.h"
+#include "cpuid/tree/cpuid_tree.h"
+#include "cpuid/tree/cpuid_tree_sink.h"
+#include "cpuid/tree/cpuid_write_snapshot.h"
+#include "cpuid/tree/cpuid_write_xml.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace rjcp::cpuid::tree {
+
+namespace {
+
+constexpr unsigned int Cpus = 500;
+constexpr unsigned int Leaves = 64;
+constexpr std::size_t Iterations = 20;
+
+}
+
+BENCHMARK(CpuIdSnapshotLoad)
+{
+    // Each CPU has a different APIC identifier, the same as real systems.
+    CpuIdTree tree{};
+    for (unsigned int cpunum = 0; cpunum < Cpus; cpunum++) {
+        CpuIdProcessor processor{};
+        for (unsigned int leaf = 0; leaf < Leaves; leaf++) {
+            std::uint32_t ebx = leaf == 1 ? cpunum << 24 : 0;
+            processor.AddLeaf(CpuIdRegister{leaf, 0, 0x000906A3 + leaf, ebx, 0x7FFAFBFF, 0xBFEBFBFF});
+        }
+        tree.SetProcessor(cpunum, std::move(processor));
+    }
+
+    std::stringstream stream{};
+    WriteCpuIdXml(tree, stream);
+    std::string xml = stream.str();
+    std::vector<std::uint8_t> snapshot = GetCpuIdSnapshot(tree);
+    std::cout << "  XML " << xml.size() << " bytes, snapshot " << snapshot.size() << " bytes" << std::endl;
+
+    bench::Measure("ReadCpuIdXml", Iterations, [&xml]() {
+        CpuIdTree result{};
+        CpuIdTreeSink sink{result};
+        bench::DoNotOptimise(ReadCpuIdXml(xml, sink));
+        bench::DoNotOptimise(result.GetProcessor(Cpus - 1)->FindLeaf(1, 0)->Ebx());
+    });
+
+    bench::Measure("CpuIdSnapshot::Open", Iterations, [&snapshot]() {
+        auto result = CpuIdSnapshot::Open(snapshot.data(), snapshot.size());
+        bench::DoNotOptimise(result->GetProcessor(Cpus - 1).GetLeaf(1, 0)->Ebx());
+    });
+}
+
+}
@@ -0,0 +1,86 @@
+#include "bench.h"
+
+#include "cpuid/cpuid_register.h"
+#include "cpuid/tree/cpuid_tree.h"
+
+#include <cstdint>
+#include <map>
+
+namespace rjcp::cpuid::tree {
+
+namespace {
+
+constexpr unsigned int Cpus = 384;
+constexpr std::size_t Iterations = 20000;
+
+/**
+ * @brief The node based container previously used by CpuIdTree, as a
+ * baseline.
+ */
+using CpuIdMap = std::map<unsigned int, CpuIdProcessor>;
+
+auto GetProcessor(unsigned int cpunum) -> CpuIdProcessor
+{
+    CpuIdProcessor processor{};
+    processor.AddLeaf(CpuIdRegister{0, 0, 0x20, 0x756E6547, 0x6C65746E, 0x49656E69});
+    processor.AddLeaf(CpuIdRegister{1, 0, 0x000906A3, cpunum << 24, 0x7FFAFBFF, 0xBFEBFBFF});
+    return processor;
+}
+
+}
+
+BENCHMARK(CpuIdTreeGetProcessor)
+{
+    CpuIdMap map{};
+    CpuIdTree tree{};
+    for (unsigned int cpunum = 0; cpunum < Cpus; cpunum++) {
+        map.emplace(cpunum, GetProcessor(cpunum));
+        tree.SetProcessor(cpunum, GetProcessor(cpunum));
+    }
+
+    bench::Measure("std::map", Iterations, [&map]() {
+        std::size_t sum = 0;
+        for (unsigned int cpunum = 0; cpunum < Cpus; cpunum++) {
+            auto found = map.find(cpunum);
+            if (found != map.end()) sum += found->second.Size();
+        }
+        bench::DoNotOptimise(sum);
+    });
+
+    bench::Measure("CpuIdTree", Iterations, [&tree]() {
+        std::size_t sum = 0;
+        for (unsigned int cpunum = 0; cpunum < Cpus; cpunum++) {
+            const auto* processor = tree.GetProcessor(cpunum);
+            if (processor != nullptr) sum += processor->Size();
+        }
+        bench::DoNotOptimise(sum);
+    });
+}
+
+BENCHMARK(CpuIdTreeIterate)
+{
+    CpuIdMap map{};
+    CpuIdTree tree{};
+    for (unsigned int cpunum = 0; cpunum < Cpus; cpunum++) {
+        map.emplace(cpunum, GetProcessor(cpunum));
+        tree.SetProcessor(cpunum, GetProcessor(cpunum));
+    }
+
+    bench::Measure("std::map", Iterations, [&map]() {
+        std::size_t sum = 0;
+        for (const auto& processor : map) {
+            sum += processor.first + processor.second.Size();
+        }
+        bench::DoNotOptimise(sum);
+    });
+
+    bench::Measure("CpuIdTree", Iterations, [&tree]() {
+        std::size_t sum = 0;
+        for (auto processor = tree.cbegin(); processor != tree.cend(); ++processor) {
+            sum += processor->first + processor->second.Size();
+        }
+        bench::DoNotOptimise(sum);
+    });
+}
+
+}
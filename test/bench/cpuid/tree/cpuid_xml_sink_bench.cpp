@@ -0,0 +1,85 @@
+#include "bench.h"
+
+#include "cpuid/cpuid_register.h"
+#include "cpuid/tree/cpuid_tree.h"
+#include "cpuid/tree/cpuid_write_xml.h"
+#include "os/qnx/native/file/file.h"
+
+#include <fcntl.h>
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+
+namespace rjcp::cpuid::tree {
+
+namespace {
+
+constexpr unsigned int Cpus = 64;
+constexpr unsigned int Leaves = 64;
+constexpr std::size_t Iterations = 20;
+
+/**
+ * @brief The formatting previously used by WriteCpuIdXml, as a baseline. Each
+ * line is flushed.
+ */
+void WriteBaseline(CpuIdTree& tree, std::ostream& stream)
+{
+    auto hex = [&stream](std::uint32_t value) {
+        stream << std::hex << std::uppercase << std::setw(8) << std::setfill('0') << value;
+    };
+
+    stream << R"(<?xml version="1.0" encoding="utf-8"?>)" << std::endl;
+    stream << R"(<cpuid type="x86">)" << std::endl;
+    for (auto& [cpunum, processor] : tree) {
+        stream << "  <processor>" << std::endl;
+        for (const auto& [key, reg] : processor) {
+            stream << "    <register eax=\"";
+            hex(reg.InEax());
+            stream << "\" ecx=\"";
+            hex(reg.InEcx());
+            stream << "\">";
+            hex(reg.Eax());
+            stream << ",";
+            hex(reg.Ebx());
+            stream << ",";
+            hex(reg.Ecx());
+            stream << ",";
+            hex(reg.Edx());
+            stream << "</register>" << std::endl;
+        }
+        stream << "  </processor>" << std::endl;
+    }
+    stream << "</cpuid>" << std::endl;
+}
+
+}
+
+BENCHMARK(CpuIdXmlWrite)
+{
+    CpuIdTree tree{};
+    for (unsigned int cpunum = 0; cpunum < Cpus; cpunum++) {
+        CpuIdProcessor processor{};
+        for (unsigned int leaf = 0; leaf < Leaves; leaf++) {
+            processor.AddLeaf(CpuIdRegister{leaf, 0, 0x000906A3 + leaf, cpunum << 24, 0x7FFAFBFF, 0xBFEBFBFF});
+        }
+        tree.SetProcessor(cpunum, std::move(processor));
+    }
+
+    std::ofstream null{"/dev/null"};
+    bench::Measure("flush per line", Iterations, [&tree, &null]() {
+        WriteBaseline(tree, null);
+    });
+
+    bench::Measure("CpuIdXmlSink stream", Iterations, [&tree, &null]() {
+        WriteCpuIdXml(tree, null);
+    });
+
+    auto file = os::qnx::native::file::open("/dev/null", O_WRONLY);
+    if (!file) return;
+    bench::Measure("CpuIdXmlSink file", Iterations, [&tree, &file]() {
+        bench::DoNotOptimise(WriteCpuIdXml(tree, *file));
+    });
+}
+
+}
@@ -0,0 +1,50 @@
+#include "bench.h"
+
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace rjcp::bench {
+
+namespace {
+
+auto Benchmarks() -> std::vector<std::pair<std::string, std::function<void()>>>&
+{
+    static std::vector<std::pair<std::string, std::function<void()>>> benchmarks{};
+    return benchmarks;
+}
+
+}
+
+auto Register(std::string name, std::function<void()> func) -> int
+{
+    Benchmarks().emplace_back(std::move(name), std::move(func));
+    return 0;
+}
+
+void Print(const std::string& name, std::size_t iterations, double nsop)
+{
+    std::cout << "  " << std::left << std::setw(48) << name
+              << std::right << std::setw(12) << std::fixed << std::setprecision(1) << nsop << " ns/op"
+              << "  (" << iterations << " iterations)" << std::endl;
+}
+
+}
+
+/**
+ * @brief Run all benchmarks, or only those whose name contains the first
+ * argument.
+ */
+auto main(int argc, char* argv[]) -> int
+{
+    const char* filter = argc > 1 ? argv[1] : nullptr;  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    for (const auto& benchmark : rjcp::bench::Benchmarks()) {
+        if (filter != nullptr && std::strstr(benchmark.first.c_str(), filter) == nullptr) continue;
+
+        std::cout << benchmark.first << std::endl;
+        benchmark.second();
+    }
+    return 0;
+}
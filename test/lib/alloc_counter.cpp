@@ -0,0 +1,85 @@
+#include "alloc_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local std::size_t allocations = 0;
+
+auto Allocate(std::size_t size) noexcept -> void*
+{
+    allocations++;
+    return std::malloc(size == 0 ? 1 : size);  // NOLINT(cppcoreguidelines-no-malloc)
+}
+
+}
+
+// NOLINTBEGIN(cppcoreguidelines-no-malloc)
+auto operator new(std::size_t size) -> void*
+{
+    void* p = Allocate(size);
+    if (!p) throw std::bad_alloc{};
+    return p;
+}
+
+auto operator new[](std::size_t size) -> void*
+{
+    void* p = Allocate(size);
+    if (!p) throw std::bad_alloc{};
+    return p;
+}
+
+auto operator new(std::size_t size, const std::nothrow_t&) noexcept -> void*
+{
+    return Allocate(size);
+}
+
+auto operator new[](std::size_t size, const std::nothrow_t&) noexcept -> void*
+{
+    return Allocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+// NOLINTEND(cppcoreguidelines-no-malloc)
+
+namespace rjcp {
+
+AllocCounter::AllocCounter() noexcept
+    : m_start{allocations}
+{ }
+
+auto AllocCounter::Count() const noexcept -> std::size_t
+{
+    return allocations - m_start;
+}
+
+}
@@ -0,0 +1,34 @@
+#ifndef RJCP_TEST_ALLOC_COUNTER_H
+#define RJCP_TEST_ALLOC_COUNTER_H
+
+#include <cstddef>
+
+namespace rjcp {
+
+/**
+ * @brief Counts the heap allocations made by the current thread.
+ *
+ * The global operator new is replaced in the test binary, so that every
+ * allocation through new is counted. Allocations on other threads are not
+ * counted. Create the counter before the code under test, and check the count
+ * afterwards, outside of any test assertions that might allocate.
+ */
+class AllocCounter
+{
+public:
+    AllocCounter() noexcept;
+
+    /**
+     * @brief The number of allocations made since the counter was created.
+     *
+     * @return std::size_t The number of allocations.
+     */
+    auto Count() const noexcept -> std::size_t;
+
+private:
+    std::size_t m_start;
+};
+
+}
+
+#endif
@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+
+#include "cpuid/cpuid_boot_cache.h"
+#include "cpuid/cpuid_boot_cache_config.h"
+#include "cpuid/cpuid_factory.h"
+#include "cpuid/cpuid_simulation_config.h"
+#include "cpuid/get_cpuid.h"
+#include "cpuid/tree/cpuid_tree.h"
+#include "cpuid/tree/cpuid_write_snapshot.h"
+#include "test_helper.h"
+
+#include <unistd.h>
+
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace rjcp::cpuid {
+
+namespace {
+
+auto GetKey() -> CpuIdBootKey
+{
+    CpuIdBootKey key{};
+    key.bootId = "feef591b-6947-4d6a-800e-ab90e09ffbee";
+    key.cpus = 4;
+    key.cpuset = 0x0123456789ABCDEF;
+    key.microcode = 0x2006E05;
+    return key;
+}
+
+/**
+ * @brief A temporary directory for the cache file, deleted when out of scope.
+ */
+class TempDir
+{
+public:
+    TempDir()
+    {
+        if (mkdtemp(&m_name[0]) == nullptr) m_name.clear();
+    }
+
+    TempDir(const TempDir&) = delete;
+    auto operator=(const TempDir&) -> TempDir& = delete;
+    TempDir(TempDir&&) = delete;
+    auto operator=(TempDir&&) -> TempDir& = delete;
+
+    auto Name() const -> const std::string& { return m_name; }
+
+    auto CacheFile() const -> std::string { return m_name + "/cpuid.cache"; }
+
+    ~TempDir()
+    {
+        unlink(CacheFile().c_str());
+        rmdir(m_name.c_str());
+    }
+
+private:
+    std::string m_name{"/tmp/cpuid_cache_XXXXXX"};
+};
+
+}
+
+TEST(CpuIdBootCache, GetKey)
+{
+    auto factory = CreateCpuIdFactory(CpuIdSimulationConfig{GetTestTree()});
+    auto key = GetCpuIdBootKey(*factory);
+    EXPECT_EQ(key.cpus, 4);
+    if (access("/proc/sys/kernel/random/boot_id", R_OK) == 0) {
+        // A UUID, without the newline.
+        EXPECT_EQ(key.bootId.size(), 36);
+        EXPECT_EQ(GetCpuIdBootKey(*factory).bootId, key.bootId);
+    }
+}
+
+TEST(CpuIdBootCache, SaveLoad)
+{
+    TempDir dir{};
+    ASSERT_FALSE(dir.Name().empty());
+    tree::CpuIdTree tree = GetTestTree();
+    ASSERT_TRUE(SaveCpuIdBootCache(dir.CacheFile(), GetKey(), tree::GetCpuIdSnapshot(tree)));
+
+    auto snapshot = LoadCpuIdBootCache(dir.CacheFile(), GetKey());
+    ASSERT_NE(snapshot, nullptr);
+    ASSERT_EQ(snapshot->Size(), 4);
+    auto leaf = snapshot->GetProcessor(3).GetLeaf(1, 0);
+    ASSERT_NE(leaf, nullptr);
+    EXPECT_EQ(leaf->Ebx(), 0x03100800);
+}
+
+TEST(CpuIdBootCache, LoadMissing)
+{
+    TempDir dir{};
+    EXPECT_EQ(LoadCpuIdBootCache(dir.CacheFile(), GetKey()), nullptr);
+}
+
+TEST(CpuIdBootCache, LoadKeyMismatch)
+{
+    TempDir dir{};
+    tree::CpuIdTree tree = GetTestTree();
+    ASSERT_TRUE(SaveCpuIdBootCache(dir.CacheFile(), GetKey(), tree::GetCpuIdSnapshot(tree)));
+
+    CpuIdBootKey key = GetKey();
+    key.bootId[0] = '0';
+    EXPECT_EQ(LoadCpuIdBootCache(dir.CacheFile(), key), nullptr);
+
+    key = GetKey();
+    key.cpus = 8;
+    EXPECT_EQ(LoadCpuIdBootCache(dir.CacheFile(), key), nullptr);
+
+    key = GetKey();
+    key.cpuset++;
+    EXPECT_EQ(LoadCpuIdBootCache(dir.CacheFile(), key), nullptr);
+
+    key = GetKey();
+    key.microcode++;
+    EXPECT_EQ(LoadCpuIdBootCache(dir.CacheFile(), key), nullptr);
+
+    key = GetKey();
+    key.bootId.clear();
+    EXPECT_EQ(LoadCpuIdBootCache(dir.CacheFile(), key), nullptr);
+}
+
+TEST(CpuIdBootCache, LoadTruncated)
+{
+    TempDir dir{};
+    tree::CpuIdTree tree = GetTestTree();
+    std::vector<std::uint8_t> snapshot = tree::GetCpuIdSnapshot(tree);
+    ASSERT_TRUE(SaveCpuIdBootCache(dir.CacheFile(), GetKey(), snapshot));
+    ASSERT_EQ(truncate(dir.CacheFile().c_str(), static_cast<off_t>(88 + snapshot.size() - 8)), 0);
+    EXPECT_EQ(LoadCpuIdBootCache(dir.CacheFile(), GetKey()), nullptr);
+}
+
+TEST(CpuIdBootCache, LoadVersion1)
+{
+    // The header of version 1, which has no hash of the CPU list.
+    struct BootCacheHeaderV1 {
+        std::array<char, 8> magic;
+        std::uint32_t version;
+        std::uint32_t cpus;
+        std::uint32_t microcode;
+        std::uint32_t bootIdLength;
+        std::array<char, 48> bootId;
+        std::uint64_t size;
+    };
+    static_assert(sizeof(BootCacheHeaderV1) == 80);
+
+    TempDir dir{};
+    tree::CpuIdTree tree = GetTestTree();
+    std::vector<std::uint8_t> snapshot = tree::GetCpuIdSnapshot(tree);
+    CpuIdBootKey key = GetKey();
+
+    BootCacheHeaderV1 header{};
+    header.magic = { 'C', 'P', 'U', 'I', 'D', 'B', 'C', 'H' };
+    header.version = 1;
+    header.cpus = key.cpus;
+    header.microcode = key.microcode;
+    header.bootIdLength = static_cast<std::uint32_t>(key.bootId.size());
+    std::memcpy(header.bootId.data(), key.bootId.data(), key.bootId.size());
+    header.size = snapshot.size();
+    {
+        std::ofstream file{dir.CacheFile(), std::ios::binary};
+        // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(snapshot.data()), static_cast<std::streamsize>(snapshot.size()));
+        // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    }
+
+    EXPECT_EQ(LoadCpuIdBootCache(dir.CacheFile(), key), nullptr);
+}
+
+TEST(CpuIdBootCache, SaveNoDirectory)
+{
+    tree::CpuIdTree tree = GetTestTree();
+    EXPECT_FALSE(SaveCpuIdBootCache("/nonexistent/cpuid.cache", GetKey(), tree::GetCpuIdSnapshot(tree)));
+}
+
+TEST(CpuIdBootCache, Factory)
+{
+    if (access("/proc/sys/kernel/random/boot_id", R_OK) != 0) GTEST_SKIP() << "No boot identifier";
+
+    TempDir dir{};
+    tree::CpuIdTree tree = GetTestTree();
+    std::shared_ptr<ICpuIdFactory> sim = CreateCpuIdFactory(CpuIdSimulationConfig{tree});
+    auto factory = CreateCpuIdFactory(CpuIdBootCacheConfig{sim, dir.Name()});
+    ASSERT_NE(factory, nullptr);
+    EXPECT_EQ(factory->threads(), 4);
+    EXPECT_EQ(GetXml(*GetCpuId(*factory)), GetXml(tree));
+    EXPECT_EQ(access(dir.CacheFile().c_str(), R_OK), 0);
+
+    // The second factory uses the cache, not the changed simulation.
+    tree::CpuIdTree changed = GetTestTree(4, 0x000906A3);
+    std::shared_ptr<ICpuIdFactory> sim2 = CreateCpuIdFactory(CpuIdSimulationConfig{changed});
+    auto cached = CreateCpuIdFactory(CpuIdBootCacheConfig{sim2, dir.Name()});
+    ASSERT_NE(cached, nullptr);
+    EXPECT_EQ(GetXml(*GetCpuId(*cached)), GetXml(tree));
+}
+
+TEST(CpuIdBootCache, FactoryCorrupt)
+{
+    if (access("/proc/sys/kernel/random/boot_id", R_OK) != 0) GTEST_SKIP() << "No boot identifier";
+
+    TempDir dir{};
+    {
+        std::ofstream stream{dir.CacheFile(), std::ios::binary};
+        stream << "garbage";
+    }
+
+    tree::CpuIdTree tree = GetTestTree();
+    std::shared_ptr<ICpuIdFactory> sim = CreateCpuIdFactory(CpuIdSimulationConfig{tree});
+    auto factory = CreateCpuIdFactory(CpuIdBootCacheConfig{sim, dir.Name()});
+    ASSERT_NE(factory, nullptr);
+    EXPECT_EQ(GetXml(*GetCpuId(*factory)), GetXml(tree));
+
+    // The cache is rewritten.
+    EXPECT_NE(LoadCpuIdBootCache(dir.CacheFile(), GetCpuIdBootKey(*sim)), nullptr);
+}
+
+TEST(CpuIdBootCache, FactoryNoDirectory)
+{
+    tree::CpuIdTree tree = GetTestTree();
+    std::shared_ptr<ICpuIdFactory> sim = CreateCpuIdFactory(CpuIdSimulationConfig{tree});
+    auto factory = CreateCpuIdFactory(CpuIdBootCacheConfig{sim, ""});
+    ASSERT_NE(factory, nullptr);
+    EXPECT_EQ(GetXml(*GetCpuId(*factory)), GetXml(tree));
+}
+
+TEST(CpuIdBootCache, FactoryNull)
+{
+    EXPECT_EQ(CreateCpuIdFactory(CpuIdBootCacheConfig{nullptr, "/tmp"}), nullptr);
+}
+
+}
@@ -0,0 +1,291 @@
+#include <gtest/gtest.h>
+
+#include "cpuid/cpuid_cache.h"
+#include "cpuid/cpuid_cached.h"
+#include "cpuid/cpuid_cached_config.h"
+#include "cpuid/cpuid_factory.h"
+#include "cpuid/cpuid_native_config.h"
+#include "cpuid/cpuid_simulation.h"
+#include "cpuid/cpuid_simulation_config.h"
+#include "cpuid/get_cpuid.h"
+#include "cpuid/tree/cpuid_tree.h"
+#include "test_helper.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace rjcp::cpuid {
+
+namespace {
+
+auto GetTree() -> std::shared_ptr<tree::CpuIdTree>
+{
+    return std::make_shared<tree::CpuIdTree>(GetTestTree());
+}
+
+/**
+ * @brief Counts the queries given to another reader.
+ */
+class CpuIdCounting final : public ICpuId
+{
+public:
+    CpuIdCounting(std::unique_ptr<ICpuId> cpuid, std::atomic<unsigned int>& count)
+    : m_cpuid{std::move(cpuid)}, m_count{count}
+    { }
+
+    auto GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister override
+    {
+        m_count++;
+        return m_cpuid->GetCpuId(eax, ecx);
+    }
+
+    void GetCpuId(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept override
+    {
+        m_count += static_cast<unsigned int>(count);
+        m_cpuid->GetCpuId(queries, registers, count);
+    }
+
+private:
+    std::unique_ptr<ICpuId> m_cpuid;
+    std::atomic<unsigned int>& m_count;
+};
+
+auto MakeCached(unsigned int cpunum, const std::shared_ptr<tree::CpuIdTree>& tree,
+    std::shared_ptr<CpuIdCache> cache, std::atomic<unsigned int>& count) -> CpuIdCached
+{
+    auto sim = std::make_unique<CpuIdSimulation>(cpunum, tree);
+    auto counting = std::make_unique<CpuIdCounting>(std::move(sim), count);
+    return CpuIdCached{cpunum, std::move(counting), std::move(cache)};
+}
+
+}
+
+TEST(CpuIdCache, Empty)
+{
+    CpuIdCache cache{4};
+    EXPECT_EQ(cache.Cpus(), 4);
+    EXPECT_FALSE(cache.Get(0, 0, 0).IsValid());
+    EXPECT_EQ(cache.Hits(), 0);
+    EXPECT_EQ(cache.Misses(), 1);
+}
+
+TEST(CpuIdCache, SetGet)
+{
+    CpuIdCache cache{4};
+    CpuIdRegister reg{0x00000001, 0x00000000, 0x000506E3, 0x00100800, 0x7FFAFBFF, 0xBFEBFBFF};
+    EXPECT_TRUE(cache.Set(1, reg));
+
+    auto result = cache.Get(1, 0x00000001, 0x00000000);
+    ASSERT_TRUE(result.IsValid());
+    EXPECT_EQ(result.InEax(), 0x00000001);
+    EXPECT_EQ(result.InEcx(), 0x00000000);
+    EXPECT_EQ(result.Value(), reg.Value());
+
+    // Results are per CPU.
+    EXPECT_FALSE(cache.Get(0, 0x00000001, 0x00000000).IsValid());
+    EXPECT_FALSE(cache.Get(1, 0x00000001, 0x00000001).IsValid());
+    EXPECT_EQ(cache.Hits(), 1);
+    EXPECT_EQ(cache.Misses(), 2);
+}
+
+TEST(CpuIdCache, SetInvalid)
+{
+    CpuIdCache cache{4};
+    EXPECT_FALSE(cache.Set(0, CpuIdRegister{}));
+    EXPECT_FALSE(cache.Get(0, 0, 0).IsValid());
+}
+
+TEST(CpuIdCache, CpuOutOfRange)
+{
+    CpuIdCache cache{4};
+    CpuIdRegister reg{0x00000000, 0x00000000, 0x00000001, 0x756E6547, 0x6C65746E, 0x49656E69};
+    EXPECT_FALSE(cache.Set(4, reg));
+    EXPECT_FALSE(cache.Get(4, 0, 0).IsValid());
+}
+
+TEST(CpuIdCache, Full)
+{
+    CpuIdCache cache{1, 4};
+    for (std::uint32_t ecx = 0; ecx < 4; ecx++) {
+        EXPECT_TRUE(cache.Set(0, CpuIdRegister{0x0000000D, ecx, ecx, ecx, ecx, ecx}));
+    }
+    EXPECT_FALSE(cache.Set(0, CpuIdRegister{0x0000000D, 4, 4, 4, 4, 4}));
+
+    for (std::uint32_t ecx = 0; ecx < 4; ecx++) {
+        auto result = cache.Get(0, 0x0000000D, ecx);
+        ASSERT_TRUE(result.IsValid());
+        EXPECT_EQ(result.Value().eax, ecx);
+    }
+    EXPECT_FALSE(cache.Get(0, 0x0000000D, 4).IsValid());
+}
+
+TEST(CpuIdCache, Prefill)
+{
+    auto tree = GetTree();
+    CpuIdCache cache{4};
+    cache.Prefill(*tree);
+
+    auto result = cache.Get(3, 0x00000001, 0x00000000);
+    ASSERT_TRUE(result.IsValid());
+    EXPECT_EQ(result.Value().ebx, 0x03100800);
+    EXPECT_EQ(cache.Misses(), 0);
+}
+
+TEST(CpuIdCache, ConcurrentReaders)
+{
+    auto tree = GetTree();
+    auto cache = std::make_shared<CpuIdCache>(4);
+    std::atomic<unsigned int> errors{0};
+
+    std::vector<std::thread> threads{};
+    for (unsigned int cpunum = 0; cpunum < 4; cpunum++) {
+        threads.emplace_back([&, cpunum]() {
+            for (unsigned int i = 0; i < 1000; i++) {
+                CpuIdRegister reg = cache->Get(cpunum, 0x00000001, 0x00000000);
+                if (!reg.IsValid()) {
+                    cache->Set(cpunum, CpuIdRegister{0x00000001, 0x00000000, 0x000506E3, 0x00100800 | (cpunum << 24), 0x7FFAFBFF, 0xBFEBFBFF});
+                } else if (reg.Value().ebx != (0x00100800 | (cpunum << 24))) {
+                    errors++;
+                }
+            }
+        });
+    }
+    for (auto& thread: threads) thread.join();
+
+    EXPECT_EQ(errors, 0);
+    EXPECT_EQ(cache->Hits() + cache->Misses(), 4000);
+}
+
+TEST(CpuIdCached, MissThenHit)
+{
+    auto tree = GetTree();
+    auto cache = std::make_shared<CpuIdCache>(4);
+    std::atomic<unsigned int> count{0};
+    auto cpuid = MakeCached(2, tree, cache, count);
+
+    auto first = cpuid.GetCpuId(0x00000001, 0x00000000);
+    auto second = cpuid.GetCpuId(0x00000001, 0x00000000);
+    ASSERT_TRUE(first.IsValid());
+    ASSERT_TRUE(second.IsValid());
+    EXPECT_EQ(first.Value().ebx, 0x02100800);
+    EXPECT_EQ(second.Value().ebx, 0x02100800);
+    EXPECT_EQ(count, 1);
+    EXPECT_EQ(cache->Hits(), 1);
+    EXPECT_EQ(cache->Misses(), 1);
+}
+
+TEST(CpuIdCached, MissingLeafNotCached)
+{
+    auto tree = GetTree();
+    auto cache = std::make_shared<CpuIdCache>(4);
+    std::atomic<unsigned int> count{0};
+    auto cpuid = MakeCached(0, tree, cache, count);
+
+    EXPECT_FALSE(cpuid.GetCpuId(0x00000002, 0x00000000).IsValid());
+    EXPECT_FALSE(cpuid.GetCpuId(0x00000002, 0x00000000).IsValid());
+    EXPECT_EQ(count, 2);
+}
+
+TEST(CpuIdCached, Batch)
+{
+    auto tree = GetTree();
+    auto cache = std::make_shared<CpuIdCache>(4);
+    std::atomic<unsigned int> count{0};
+    auto cpuid = MakeCached(1, tree, cache, count);
+    cpuid.GetCpuId(0x80000000, 0x00000000);
+    ASSERT_EQ(count, 1);
+
+    std::array<CpuIdQuery, 3> queries{{{0x00000000, 0}, {0x80000000, 0}, {0x80000001, 0}}};
+    std::array<CpuIdRegister, 3> registers{};
+    cpuid.GetCpuId(queries.data(), registers.data(), queries.size());
+    EXPECT_EQ(count, 3);
+    for (std::size_t i = 0; i < queries.size(); i++) {
+        ASSERT_TRUE(registers[i].IsValid());
+        EXPECT_EQ(registers[i].InEax(), queries[i].eax);
+        EXPECT_EQ(registers[i].Value(), tree->GetProcessor(1)->GetLeaf(queries[i].eax, 0)->Value());
+    }
+
+    // Now all queries hit.
+    cpuid.GetCpuId(queries.data(), registers.data(), queries.size());
+    EXPECT_EQ(count, 3);
+}
+
+TEST(CpuIdCached, SharedCache)
+{
+    auto tree = GetTree();
+    auto cache = std::make_shared<CpuIdCache>(4);
+    std::atomic<unsigned int> count{0};
+    auto cpuid0 = MakeCached(0, tree, cache, count);
+    auto cpuid0b = MakeCached(0, tree, cache, count);
+    auto cpuid1 = MakeCached(1, tree, cache, count);
+
+    cpuid0.GetCpuId(0x00000001, 0x00000000);
+    cpuid0b.GetCpuId(0x00000001, 0x00000000);
+    EXPECT_EQ(count, 1);
+
+    auto reg = cpuid1.GetCpuId(0x00000001, 0x00000000);
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(reg.Value().ebx, 0x01100800);
+}
+
+TEST(CpuIdCached, Factory)
+{
+    auto tree = GetTree();
+    std::shared_ptr<ICpuIdFactory> sim = CreateCpuIdFactory(CpuIdSimulationConfig{tree});
+    CpuIdCachedConfig config{sim};
+    auto factory = CreateCpuIdFactory(config);
+    ASSERT_TRUE(factory);
+    EXPECT_EQ(factory->threads(), sim->threads());
+
+    auto expected = GetCpuId(*sim);
+    auto first = GetCpuId(*factory);
+    EXPECT_EQ(GetXml(*first), GetXml(*expected));
+    EXPECT_EQ(config.GetCache()->Hits(), 0);
+
+    auto second = GetCpuId(*factory);
+    EXPECT_EQ(GetXml(*second), GetXml(*expected));
+    EXPECT_GT(config.GetCache()->Hits(), 0);
+}
+
+TEST(CpuIdCached, FactoryPrefill)
+{
+    auto tree = GetTree();
+    std::shared_ptr<ICpuIdFactory> sim = CreateCpuIdFactory(CpuIdSimulationConfig{tree});
+    CpuIdCachedConfig config{sim, true};
+    auto factory = CreateCpuIdFactory(config);
+    ASSERT_TRUE(factory);
+
+    auto cpuid = factory->create(3);
+    ASSERT_TRUE(cpuid);
+    auto reg = cpuid->GetCpuId(0x00000001, 0x00000000);
+    ASSERT_TRUE(reg.IsValid());
+    EXPECT_EQ(reg.Value().ebx, 0x03100800);
+    EXPECT_EQ(config.GetCache()->Misses(), 0);
+}
+
+TEST(CpuIdCached, FactoryNull)
+{
+    CpuIdCachedConfig config{nullptr};
+    EXPECT_FALSE(CreateCpuIdFactory(config));
+}
+
+TEST(CpuIdCached, NativeFactory)
+{
+    std::shared_ptr<ICpuIdFactory> native = CreateCpuIdFactory(CpuIdNativeConfig{});
+    CpuIdCachedConfig config{native};
+    auto factory = CreateCpuIdFactory(config);
+    ASSERT_TRUE(factory);
+
+    auto cpuid = factory->create(0);
+    ASSERT_TRUE(cpuid);
+    auto first = cpuid->GetCpuId(0, 0);
+    auto second = cpuid->GetCpuId(0, 0);
+    EXPECT_EQ(first.Value(), second.Value());
+    EXPECT_EQ(config.GetCache()->Hits(), 1);
+}
+
+}
@@ -2,6 +2,8 @@
 
 #include "cpuid/cpuid_default.h"
 
+#include <array>
+
 namespace rjcp::cpuid {
 
 TEST(CpuIdDefault, DefaultValue)
@@ -16,4 +18,17 @@ TEST(CpuIdDefault, DefaultValue)
     ASSERT_EQ(cpuidreg.Edx(), 0);
 }
 
+TEST(CpuIdDefault, BatchDefaultValue)
+{
+    CpuIdDefault cpuid = CpuIdDefault{0};
+    std::array<CpuIdQuery, 2> queries{{{0x00000000, 0}, {0x00000001, 0}}};
+    std::array<CpuIdRegister, 2> cpuidregs{};
+    cpuid.GetCpuId(queries.data(), cpuidregs.data(), queries.size());
+
+    for (auto& cpuidreg : cpuidregs) {
+        ASSERT_FALSE(cpuidreg.IsValid());
+        ASSERT_EQ(cpuidreg.Eax(), 0);
+    }
+}
+
 }
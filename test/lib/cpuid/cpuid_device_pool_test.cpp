@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include "cpuid/cpuid_device.h"
+#include "cpuid/cpuid_device_config.h"
+#include "cpuid/cpuid_device_pool.h"
+#include "cpuid/cpuid_factory.h"
+#include "cpuid/get_cpuid.h"
+
+#include <memory>
+
+namespace rjcp::cpuid {
+
+TEST(CpuIdDevicePool, Path)
+{
+    EXPECT_EQ(GetCpuIdDevicePath(0), "/dev/cpu/0/cpuid");
+    EXPECT_EQ(GetCpuIdDevicePath(1023), "/dev/cpu/1023/cpuid");
+}
+
+TEST(CpuIdDevicePool, BorrowReturn)
+{
+    CpuIdDevicePool pool{};
+    auto handle = pool.Borrow(0);
+    ASSERT_TRUE(handle) << "Ensure that the cpuid driver is loaded and has readable permissions";
+    EXPECT_EQ(pool.Size(), 0);
+
+    int fd = handle.Get();
+    pool.Return(0, std::move(handle));
+    EXPECT_EQ(pool.Size(), 1);
+
+    // The same device is borrowed again, and not opened.
+    auto again = pool.Borrow(0);
+    ASSERT_TRUE(again);
+    EXPECT_EQ(again.Get(), fd);
+    EXPECT_EQ(pool.Size(), 0);
+}
+
+TEST(CpuIdDevicePool, BorrowTwice)
+{
+    // Each borrower has its own device, so they can seek independently.
+    CpuIdDevicePool pool{};
+    auto handle1 = pool.Borrow(0);
+    auto handle2 = pool.Borrow(0);
+    ASSERT_TRUE(handle1) << "Ensure that the cpuid driver is loaded and has readable permissions";
+    ASSERT_TRUE(handle2);
+    EXPECT_NE(handle1.Get(), handle2.Get());
+
+    pool.Return(0, std::move(handle1));
+    pool.Return(0, std::move(handle2));
+    EXPECT_EQ(pool.Size(), 2);
+}
+
+TEST(CpuIdDevicePool, InvalidCpu)
+{
+    CpuIdDevicePool pool{};
+    auto handle = pool.Borrow(256);
+    EXPECT_FALSE(handle);
+
+    pool.Return(256, std::move(handle));
+    EXPECT_EQ(pool.Size(), 0);
+}
+
+TEST(CpuIdDevicePool, Reader)
+{
+    auto pool = std::make_shared<CpuIdDevicePool>();
+    {
+        CpuIdDevice cpuid{0, pool, DeviceAccessMethod::seek};
+        EXPECT_TRUE(cpuid.GetCpuId(0, 0).IsValid()) << "Ensure that the cpuid driver is loaded and has readable permissions";
+        EXPECT_EQ(pool->Size(), 0);
+    }
+    EXPECT_EQ(pool->Size(), 1);
+
+    CpuIdDevice cpuid{0, pool, DeviceAccessMethod::pread};
+    EXPECT_EQ(pool->Size(), 0);
+    EXPECT_TRUE(cpuid.GetCpuId(0, 0).IsValid());
+}
+
+TEST(CpuIdDevicePool, Factory)
+{
+    // Factories from the same configuration share the devices.
+    CpuIdDeviceConfig config{};
+    auto tree1 = GetCpuId(*CreateCpuIdFactory(config));
+    std::size_t open = config.pool->Size();
+    EXPECT_GT(open, 0) << "Ensure that the cpuid driver is loaded and has readable permissions";
+
+    auto tree2 = GetCpuId(*CreateCpuIdFactory(config));
+    EXPECT_EQ(config.pool->Size(), open);
+    EXPECT_EQ(tree1->Size(), tree2->Size());
+}
+
+}
@@ -1,8 +1,12 @@
 #include <gtest/gtest.h>
 
+#include "alloc_counter.h"
 #include "cpuid/cpuid_device.h"
 #include "cpuid/cpuid_native.h"
 
+#include <array>
+#include <vector>
+
 namespace rjcp::cpuid {
 
 static void CpuIdDeviceTestValue(CpuIdDevice& cpuid)
@@ -46,6 +50,18 @@ TEST(CpuIdDevice, ValueLseek)
     CpuIdDeviceTestValue(cpuid);
 }
 
+TEST(CpuIdDevice, ValueUring)
+{
+    CpuIdDevice cpuid = CpuIdDevice{0, DeviceAccessMethod::uring};
+    CpuIdDeviceTestValue(cpuid);
+}
+
+TEST(CpuIdDevice, ValuePreadv)
+{
+    CpuIdDevice cpuid = CpuIdDevice{0, DeviceAccessMethod::preadv};
+    CpuIdDeviceTestValue(cpuid);
+}
+
 TEST(CpuIdDevice, InvalidCpu)
 {
     CpuIdDevice cpuid = CpuIdDevice{256};
@@ -54,4 +70,121 @@ TEST(CpuIdDevice, InvalidCpu)
     ASSERT_FALSE(cpuidreg.IsValid());
 }
 
+TEST(CpuIdDevice, BatchValue)
+{
+    CpuIdDevice cpuid = CpuIdDevice{0, DeviceAccessMethod::pread};
+    std::array<CpuIdQuery, 2> queries{{{0x00000000, 0}, {0x00000001, 0}}};
+    std::array<CpuIdRegister, 2> cpuidregs{};
+    cpuid.GetCpuId(queries.data(), cpuidregs.data(), queries.size());
+
+    CpuIdNative ncpuid = CpuIdNative{0};
+    for (std::size_t i = 0; i < queries.size(); i++) {
+        CpuIdRegister ncpuidreg = ncpuid.GetCpuId(queries.at(i).eax, queries.at(i).ecx);
+        ASSERT_TRUE(cpuidregs.at(i).IsValid()) << "Ensure that the cpuid driver is loaded and has readable permissions";
+        EXPECT_EQ(cpuidregs.at(i).InEax(), queries.at(i).eax);
+        EXPECT_EQ(cpuidregs.at(i).Eax(), ncpuidreg.Eax());
+        EXPECT_EQ(cpuidregs.at(i).Ecx(), ncpuidreg.Ecx());
+        EXPECT_EQ(cpuidregs.at(i).Edx(), ncpuidreg.Edx());
+    }
+}
+
+TEST(CpuIdDevice, BatchValueUring)
+{
+    // More queries than are submitted in a single batch.
+    std::vector<CpuIdQuery> queries{};
+    for (std::uint32_t ecx = 0; ecx < 100; ecx++) {
+        queries.push_back({0x00000000, 0});
+        queries.push_back({0x00000004, ecx % 4});
+    }
+    std::vector<CpuIdRegister> cpuidregs(queries.size());
+    std::vector<CpuIdRegister> preadregs(queries.size());
+
+    CpuIdDevice cpuid = CpuIdDevice{0, DeviceAccessMethod::uring};
+    cpuid.GetCpuId(queries.data(), cpuidregs.data(), queries.size());
+    CpuIdDevice pcpuid = CpuIdDevice{0, DeviceAccessMethod::pread};
+    pcpuid.GetCpuId(queries.data(), preadregs.data(), queries.size());
+
+    for (std::size_t i = 0; i < queries.size(); i++) {
+        ASSERT_TRUE(cpuidregs[i].IsValid()) << "Ensure that the cpuid driver is loaded and has readable permissions";
+        EXPECT_EQ(cpuidregs[i].InEax(), queries[i].eax);
+        EXPECT_EQ(cpuidregs[i].InEcx(), queries[i].ecx);
+        EXPECT_EQ(cpuidregs[i].Eax(), preadregs[i].Eax());
+        EXPECT_EQ(cpuidregs[i].Ebx(), preadregs[i].Ebx());
+        EXPECT_EQ(cpuidregs[i].Ecx(), preadregs[i].Ecx());
+        EXPECT_EQ(cpuidregs[i].Edx(), preadregs[i].Edx());
+    }
+}
+
+TEST(CpuIdDevice, BatchInvalidCpuUring)
+{
+    CpuIdDevice cpuid = CpuIdDevice{256, DeviceAccessMethod::uring};
+    std::array<CpuIdQuery, 2> queries{{{0x00000000, 0}, {0x00000001, 0}}};
+    std::array<CpuIdRegister, 2> cpuidregs{};
+    cpuid.GetCpuId(queries.data(), cpuidregs.data(), queries.size());
+    EXPECT_FALSE(cpuidregs[0].IsValid());
+    EXPECT_FALSE(cpuidregs[1].IsValid());
+}
+
+TEST(CpuIdDevice, BatchValuePreadv)
+{
+    // Runs of consecutive leaves, a different ECX, and EAX that would wrap.
+    std::vector<CpuIdQuery> queries{
+        {0x00000000, 0}, {0x00000001, 0}, {0x00000002, 0}, {0x00000004, 0},
+        {0x00000004, 1}, {0x00000005, 1}, {0x00000006, 0}, {0xFFFFFFFF, 0},
+        {0x00000000, 1}, {0x80000000, 0}, {0x80000001, 0}};
+    for (std::uint32_t eax = 0; eax < 100; eax++) {
+        queries.push_back({eax, 0});
+    }
+    std::vector<CpuIdRegister> cpuidregs(queries.size());
+    std::vector<CpuIdRegister> preadregs(queries.size());
+
+    CpuIdDevice cpuid = CpuIdDevice{0, DeviceAccessMethod::preadv};
+    cpuid.GetCpuId(queries.data(), cpuidregs.data(), queries.size());
+    CpuIdDevice pcpuid = CpuIdDevice{0, DeviceAccessMethod::pread};
+    pcpuid.GetCpuId(queries.data(), preadregs.data(), queries.size());
+
+    for (std::size_t i = 0; i < queries.size(); i++) {
+        ASSERT_TRUE(cpuidregs[i].IsValid()) << "Ensure that the cpuid driver is loaded and has readable permissions";
+        EXPECT_EQ(cpuidregs[i].InEax(), queries[i].eax);
+        EXPECT_EQ(cpuidregs[i].InEcx(), queries[i].ecx);
+        EXPECT_EQ(cpuidregs[i].Eax(), preadregs[i].Eax()) << "Query " << i;
+        EXPECT_EQ(cpuidregs[i].Ebx(), preadregs[i].Ebx()) << "Query " << i;
+        EXPECT_EQ(cpuidregs[i].Ecx(), preadregs[i].Ecx()) << "Query " << i;
+        EXPECT_EQ(cpuidregs[i].Edx(), preadregs[i].Edx()) << "Query " << i;
+    }
+}
+
+TEST(CpuIdDevice, BatchInvalidCpuPreadv)
+{
+    CpuIdDevice cpuid = CpuIdDevice{256, DeviceAccessMethod::preadv};
+    std::array<CpuIdQuery, 2> queries{{{0x00000000, 0}, {0x00000001, 0}}};
+    std::array<CpuIdRegister, 2> cpuidregs{};
+    cpuid.GetCpuId(queries.data(), cpuidregs.data(), queries.size());
+    EXPECT_FALSE(cpuidregs[0].IsValid());
+    EXPECT_FALSE(cpuidregs[1].IsValid());
+}
+
+TEST(CpuIdDevice, NoAllocations)
+{
+    // Querying the device must not allocate, so that reading all leaves of
+    // many CPUs doesn't touch the heap in the reader.
+    for (DeviceAccessMethod method : {DeviceAccessMethod::seek, DeviceAccessMethod::pread, DeviceAccessMethod::uring, DeviceAccessMethod::preadv}) {
+        CpuIdDevice cpuid = CpuIdDevice{0, method};
+        std::array<CpuIdQuery, 4> queries{{{0x00000000, 0}, {0x00000001, 0}, {0x00000004, 1}, {0x80000000, 0}}};
+        std::array<CpuIdRegister, 4> cpuidregs{};
+
+        // The first batch sets up the ring for the uring method.
+        cpuid.GetCpuId(queries.data(), cpuidregs.data(), queries.size());
+
+        AllocCounter counter{};
+        CpuIdRegister cpuidreg = cpuid.GetCpuId(0x00000000, 0x00000000);
+        cpuid.GetCpuId(queries.data(), cpuidregs.data(), queries.size());
+        std::size_t allocations = counter.Count();
+
+        ASSERT_TRUE(cpuidreg.IsValid()) << "Ensure that the cpuid driver is loaded and has readable permissions";
+        ASSERT_TRUE(cpuidregs[1].IsValid());
+        EXPECT_EQ(allocations, 0);
+    }
+}
+
 }
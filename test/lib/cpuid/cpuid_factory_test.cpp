@@ -4,11 +4,40 @@
 #include "cpuid/cpuid_default_config.h"
 #include "cpuid/cpuid_device_config.h"
 #include "cpuid/cpuid_native_config.h"
+#include "cpuid/cpuid_native_engine_config.h"
+#include "os/qnx/native/sched/sched.h"
 
 #include <thread>
+#include <vector>
 
 namespace rjcp::cpuid {
 
+static auto AffinityCpus() -> std::vector<unsigned int>
+{
+    auto cpus = os::qnx::native::sched::get_affinity();
+    if (!cpus) return {};
+    return *cpus;
+}
+
+static auto OnlineCpus() -> std::vector<unsigned int>
+{
+    auto cpus = os::qnx::native::sched::get_online();
+    if (!cpus) return {};
+    return *cpus;
+}
+
+static auto CheckCpus(ICpuIdFactory& factory, const std::vector<unsigned int>& expected)
+{
+    // The CPUs are those that the OS reports, and the number of threads covers
+    // the largest CPU number.
+    auto cpus = factory.cpus();
+    ASSERT_FALSE(cpus.empty());
+    if (!expected.empty()) {
+        EXPECT_EQ(cpus, expected);
+    }
+    EXPECT_EQ(factory.threads(), cpus.back() + 1);
+}
+
 static auto DumpRegisters(ICpuIdFactory& factory, bool isValid)
 {
     // Effectively tests that the factories all implement the same base class
@@ -41,14 +70,21 @@ TEST(CpuIdFactory, CpuIdDefault)
 TEST(CpuIdFactory, CpuIdNative)
 {
     auto factory = CreateCpuIdFactory(CpuIdNativeConfig{});
-    ASSERT_EQ(factory->threads(), std::thread::hardware_concurrency());
+    CheckCpus(*factory, AffinityCpus());
+    DumpRegisters(*factory, true);
+}
+
+TEST(CpuIdFactory, CpuIdNativeEngine)
+{
+    auto factory = CreateCpuIdFactory(CpuIdNativeEngineConfig{});
+    CheckCpus(*factory, AffinityCpus());
     DumpRegisters(*factory, true);
 }
 
 TEST(CpuIdFactory, CpuIdDeviceDefault)
 {
     auto factory = CreateCpuIdFactory(CpuIdDeviceConfig{});
-    ASSERT_EQ(factory->threads(), std::thread::hardware_concurrency());
+    CheckCpus(*factory, OnlineCpus());
     DumpRegisters(*factory, true);
 }
 
@@ -57,14 +93,14 @@ TEST(CpuIdFactory, CpuIdDeviceSeek)
     CpuIdDeviceConfig config{DeviceAccessMethod::seek};
     auto factory = CreateCpuIdFactory(config);
     DumpRegisters(*factory, true);
-    ASSERT_EQ(factory->threads(), std::thread::hardware_concurrency());
+    CheckCpus(*factory, OnlineCpus());
 }
 
 TEST(CpuIdFactory, CpuIdDevicePread)
 {
     CpuIdDeviceConfig config{DeviceAccessMethod::pread};
     auto factory = CreateCpuIdFactory(config);
-    ASSERT_EQ(factory->threads(), std::thread::hardware_concurrency());
+    CheckCpus(*factory, OnlineCpus());
     DumpRegisters(*factory, true);
 }
 
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include "cpuid/cpuid_factory.h"
+#include "cpuid/cpuid_file.h"
+#include "cpuid/cpuid_file_config.h"
+#include "cpuid/get_cpuid.h"
+#include "cpuid/tree/cpuid_tree.h"
+#include "cpuid/tree/cpuid_write_snapshot.h"
+#include "cpuid/tree/cpuid_write_xml.h"
+#include "test_helper.h"
+
+#include <array>
+#include <fstream>
+#include <string>
+
+namespace rjcp::cpuid {
+
+TEST(CpuIdFile, FactoryXml)
+{
+    tree::CpuIdTree tree = GetTestTree();
+    TempFile file{};
+    {
+        std::ofstream stream{file.Name()};
+        tree::WriteCpuIdXml(tree, stream);
+    }
+
+    auto factory = CreateCpuIdFactory(CpuIdFileConfig{file.Name()});
+    ASSERT_NE(factory, nullptr);
+    ASSERT_EQ(factory->threads(), 4);
+
+    auto cpuid = factory->create(2);
+    ASSERT_NE(cpuid, nullptr);
+    auto reg = cpuid->GetCpuId(1, 0);
+    ASSERT_TRUE(reg.IsValid());
+    EXPECT_EQ(reg.Ebx() >> 24, 2);
+    EXPECT_FALSE(cpuid->GetCpuId(2, 0).IsValid());
+
+    auto result = GetCpuId(*factory);
+    ASSERT_EQ(GetXml(*result), GetXml(tree));
+}
+
+TEST(CpuIdFile, FactorySnapshot)
+{
+    tree::CpuIdTree tree = GetTestTree();
+    TempFile file{};
+    {
+        std::ofstream stream{file.Name(), std::ios::binary};
+        tree::WriteCpuIdSnapshot(tree, stream);
+    }
+
+    auto factory = CreateCpuIdFactory(CpuIdFileConfig{file.Name()});
+    ASSERT_NE(factory, nullptr);
+    ASSERT_EQ(factory->threads(), 4);
+
+    auto result = GetCpuId(*factory, GetCpuIdOptions{2});
+    ASSERT_EQ(GetXml(*result), GetXml(tree));
+}
+
+TEST(CpuIdFile, FactoryMissingCpu)
+{
+    tree::CpuIdTree tree = GetTestTree();
+    tree::CpuIdProcessor cpu{};
+    cpu.AddLeaf(CpuIdRegister{0, 0, 0, 0x756E6547, 0x6C65746E, 0x49656E69});
+    tree.SetProcessor(7, cpu);
+
+    TempFile file{};
+    {
+        std::ofstream stream{file.Name(), std::ios::binary};
+        tree::WriteCpuIdSnapshot(tree, stream);
+    }
+
+    auto factory = CreateCpuIdFactory(CpuIdFileConfig{file.Name()});
+    ASSERT_NE(factory, nullptr);
+    ASSERT_EQ(factory->threads(), 8);
+
+    auto cpuid = factory->create(5);
+    ASSERT_NE(cpuid, nullptr);
+    EXPECT_FALSE(cpuid->GetCpuId(0, 0).IsValid());
+
+    cpuid = factory->create(7);
+    ASSERT_NE(cpuid, nullptr);
+    EXPECT_TRUE(cpuid->GetCpuId(0, 0).IsValid());
+}
+
+TEST(CpuIdFile, FactoryNonExistentFile)
+{
+    auto factory = CreateCpuIdFactory(CpuIdFileConfig{"/dev/nonexistant"});
+    ASSERT_EQ(factory, nullptr);
+}
+
+TEST(CpuIdFile, FactoryMalformedFile)
+{
+    TempFile file{};
+    {
+        std::ofstream stream{file.Name()};
+        stream << "<cpuid><processor>";
+    }
+
+    auto factory = CreateCpuIdFactory(CpuIdFileConfig{file.Name()});
+    ASSERT_EQ(factory, nullptr);
+}
+
+TEST(CpuIdFile, BatchQuery)
+{
+    tree::CpuIdTree tree = GetTestTree();
+    auto snapshot = tree::CpuIdSnapshot::Open(tree::GetCpuIdSnapshot(tree));
+    ASSERT_NE(snapshot, nullptr);
+
+    CpuIdFile cpuid{1, std::move(snapshot)};
+    std::array<CpuIdQuery, 3> queries = {{ {0, 0}, {1, 0}, {2, 0} }};
+    std::array<CpuIdRegister, 3> registers{};
+    cpuid.GetCpuId(queries.data(), registers.data(), queries.size());
+    EXPECT_TRUE(registers[0].IsValid());
+    EXPECT_TRUE(registers[1].IsValid());
+    EXPECT_EQ(registers[1].Ebx() >> 24, 1);
+    EXPECT_FALSE(registers[2].IsValid());
+}
+
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include "cpuid/cpuid_native.h"
+#include "cpuid/cpuid_native_engine_reader.h"
+
+#include <array>
+#include <memory>
+
+namespace rjcp::cpuid {
+
+TEST(CpuIdNativeEngineReader, Value)
+{
+    auto engine = std::make_shared<const CpuIdNativeEngine>(1);
+    CpuIdNativeEngineReader cpuid{0, engine};
+    CpuIdRegister cpuidreg = cpuid.GetCpuId(0x00000000, 0x00000000);
+
+    ASSERT_TRUE(cpuidreg.IsValid());
+    EXPECT_EQ(cpuidreg.InEax(), 0);
+    EXPECT_EQ(cpuidreg.InEcx(), 0);
+    ASSERT_NE(cpuidreg.Eax(), 0);
+    ASSERT_NE(cpuidreg.Ebx(), 0);
+    ASSERT_NE(cpuidreg.Ecx(), 0);
+    ASSERT_NE(cpuidreg.Edx(), 0);
+}
+
+TEST(CpuIdNativeEngineReader, BatchValue)
+{
+    auto engine = std::make_shared<const CpuIdNativeEngine>(1);
+    CpuIdNativeEngineReader cpuid{0, engine};
+    CpuIdNative ncpuid{0};
+
+    std::array<CpuIdQuery, 2> queries{{{0x00000000, 0}, {0x80000000, 0}}};
+    std::array<CpuIdRegister, 2> cpuidregs{};
+    cpuid.GetCpuId(queries.data(), cpuidregs.data(), queries.size());
+
+    for (std::size_t i = 0; i < queries.size(); i++) {
+        CpuIdRegister ncpuidreg = ncpuid.GetCpuId(queries.at(i).eax, queries.at(i).ecx);
+        ASSERT_TRUE(cpuidregs.at(i).IsValid());
+        EXPECT_EQ(cpuidregs.at(i).InEax(), queries.at(i).eax);
+        EXPECT_EQ(cpuidregs.at(i).Eax(), ncpuidreg.Eax());
+        EXPECT_EQ(cpuidregs.at(i).Ebx(), ncpuidreg.Ebx());
+    }
+}
+
+TEST(CpuIdNativeEngineReader, InvalidCpu)
+{
+    auto engine = std::make_shared<const CpuIdNativeEngine>(1);
+    CpuIdNativeEngineReader cpuid{256, engine};
+    CpuIdRegister cpuidreg = cpuid.GetCpuId(0x00000000, 0x00000000);
+
+    ASSERT_FALSE(cpuidreg.IsValid());
+}
+
+}
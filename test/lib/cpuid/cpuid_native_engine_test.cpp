@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include "cpuid/cpuid_native.h"
+#include "cpuid/cpuid_native_engine.h"
+
+#include <array>
+#include <thread>
+#include <vector>
+
+namespace rjcp::cpuid {
+
+TEST(CpuIdNativeEngine, Value)
+{
+    CpuIdNativeEngine engine{1};
+    ASSERT_EQ(engine.Cpus(), 1);
+
+    CpuIdQuery query{0x00000000, 0x00000000};
+    CpuIdRegister cpuidreg{};
+    engine.GetCpuId(0, &query, &cpuidreg, 1);
+    ASSERT_TRUE(cpuidreg.IsValid());
+
+    // Compare against the native reader on the same CPU.
+    CpuIdRegister ncpuidreg = CpuIdNative{0}.GetCpuId(0x00000000, 0x00000000);
+    EXPECT_EQ(cpuidreg.Eax(), ncpuidreg.Eax());
+    EXPECT_EQ(cpuidreg.Ebx(), ncpuidreg.Ebx());
+    EXPECT_EQ(cpuidreg.Ecx(), ncpuidreg.Ecx());
+    EXPECT_EQ(cpuidreg.Edx(), ncpuidreg.Edx());
+}
+
+TEST(CpuIdNativeEngine, InvalidCpu)
+{
+    CpuIdNativeEngine engine{1};
+
+    CpuIdQuery query{0x00000000, 0x00000000};
+    CpuIdRegister cpuidreg{};
+    engine.GetCpuId(1, &query, &cpuidreg, 1);
+    ASSERT_FALSE(cpuidreg.IsValid());
+}
+
+TEST(CpuIdNativeEngine, NotStarted)
+{
+    // Destroying an engine that was never queried doesn't start any threads.
+    CpuIdNativeEngine engine{64};
+    ASSERT_EQ(engine.Cpus(), 64);
+}
+
+TEST(CpuIdNativeEngine, ConcurrentQueries)
+{
+    CpuIdNativeEngine engine{1};
+    CpuIdRegister expected = CpuIdNative{0}.GetCpuId(0x00000000, 0x00000000);
+
+    constexpr unsigned int producers = 4;
+    constexpr unsigned int iterations = 1000;
+    std::array<unsigned int, producers> errors{};
+    std::vector<std::thread> threads{};
+    for (unsigned int p = 0; p < producers; p++) {
+        threads.emplace_back([&engine, &expected, &errors, p]() {
+            std::array<CpuIdQuery, 2> queries{{{0x00000000, 0}, {0x00000000, 0}}};
+            for (unsigned int i = 0; i < iterations; i++) {
+                std::array<CpuIdRegister, 2> cpuidregs{};
+                engine.GetCpuId(0, queries.data(), cpuidregs.data(), cpuidregs.size());
+                for (auto& cpuidreg : cpuidregs) {
+                    if (!cpuidreg.IsValid() || cpuidreg.Ebx() != expected.Ebx()) errors.at(p)++;
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (auto error : errors) {
+        EXPECT_EQ(error, 0);
+    }
+}
+
+}
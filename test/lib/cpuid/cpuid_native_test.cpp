@@ -1,6 +1,11 @@
 #include <gtest/gtest.h>
 
 #include "cpuid/cpuid_native.h"
+#include "os/qnx/native/sched/sched.h"
+
+#include <array>
+#include <thread>
+#include <vector>
 
 namespace rjcp::cpuid {
 
@@ -16,4 +21,80 @@ TEST(CpuIdNative, Value)
     ASSERT_NE(cpuidreg.Edx(), 0);
 }
 
+TEST(CpuIdNative, BatchValue)
+{
+    CpuIdNative cpuid = CpuIdNative{0};
+    std::array<CpuIdQuery, 3> queries{{{0x00000000, 0}, {0x00000001, 0}, {0x80000000, 0}}};
+    std::array<CpuIdRegister, 3> cpuidregs{};
+    cpuid.GetCpuId(queries.data(), cpuidregs.data(), queries.size());
+
+    // The batch must return the same values as individual queries.
+    for (std::size_t i = 0; i < queries.size(); i++) {
+        CpuIdRegister cpuidreg = cpuid.GetCpuId(queries.at(i).eax, queries.at(i).ecx);
+        ASSERT_TRUE(cpuidregs.at(i).IsValid());
+        EXPECT_EQ(cpuidregs.at(i).InEax(), queries.at(i).eax);
+        EXPECT_EQ(cpuidregs.at(i).InEcx(), queries.at(i).ecx);
+        EXPECT_EQ(cpuidregs.at(i).Eax(), cpuidreg.Eax());
+        EXPECT_EQ(cpuidregs.at(i).Ecx(), cpuidreg.Ecx());
+        EXPECT_EQ(cpuidregs.at(i).Edx(), cpuidreg.Edx());
+    }
+}
+
+TEST(CpuIdNative, BatchEmpty)
+{
+    CpuIdNative cpuid = CpuIdNative{0};
+    cpuid.GetCpuId(nullptr, nullptr, 0);
+}
+
+TEST(CpuIdNative, RestoresAffinity)
+{
+    auto before = os::qnx::native::sched::get_affinity();
+    ASSERT_TRUE(before);
+
+    CpuIdNative cpuid{before->front()};
+    ASSERT_TRUE(cpuid.GetCpuId(0x00000000, 0x00000000).IsValid());
+
+    auto after = os::qnx::native::sched::get_affinity();
+    ASSERT_TRUE(after);
+    EXPECT_EQ(*after, *before);
+}
+
+TEST(CpuIdNative, PinnedThread)
+{
+    // When the thread is already on the CPU, the affinity is left as it is.
+    auto cpus = os::qnx::native::sched::get_affinity();
+    ASSERT_TRUE(cpus);
+    unsigned int last = cpus->back();
+
+    CpuIdRegister reg{};
+    os::qnx::native::sched::expected<std::vector<unsigned int>> after{};
+    std::thread thread{[&reg, &after, last]() {
+        if (!os::qnx::native::sched::set_affinity(last)) return;
+        CpuIdNative cpuid{last};
+        reg = cpuid.GetCpuId(0x00000000, 0x00000000);
+        after = os::qnx::native::sched::get_affinity();
+    }};
+    thread.join();
+    ASSERT_TRUE(reg.IsValid());
+    EXPECT_NE(reg.Ebx(), 0);
+    ASSERT_TRUE(after);
+    EXPECT_EQ(*after, std::vector<unsigned int>{last});
+}
+
+TEST(CpuIdNative, CpuLargerThanSystem)
+{
+    // The set is large enough for the CPU, but the CPU doesn't exist, so the
+    // thread can't be pinned.
+    unsigned int cpu = os::qnx::native::sched::get_cpuset_cpus() + 1000;
+    auto before = os::qnx::native::sched::get_affinity();
+    ASSERT_TRUE(before);
+
+    CpuIdNative cpuid{cpu};
+    EXPECT_FALSE(cpuid.GetCpuId(0x00000000, 0x00000000).IsValid());
+
+    auto after = os::qnx::native::sched::get_affinity();
+    ASSERT_TRUE(after);
+    EXPECT_EQ(*after, *before);
+}
+
 }
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include "cpuid/cpuid_plan_reader.h"
+#include "cpuid/cpuid_simulation.h"
+
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace rjcp::cpuid {
+
+/**
+ * @brief Count the calls made to a CPUID object.
+ */
+class CpuIdCounter final : public ICpuId
+{
+public:
+    CpuIdCounter(const ICpuId& cpuid)
+    : m_cpuid{cpuid} { }
+
+    auto GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister override
+    {
+        calls++;
+        queries++;
+        return m_cpuid.GetCpuId(eax, ecx);
+    }
+
+    void GetCpuId(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept override
+    {
+        calls++;
+        this->queries += count;
+        m_cpuid.GetCpuId(queries, registers, count);
+    }
+
+    mutable unsigned int calls{0};
+    mutable std::size_t queries{0};
+
+private:
+    const ICpuId& m_cpuid;
+};
+
+static auto GetTree() -> std::shared_ptr<tree::CpuIdTree>
+{
+    auto tree = std::make_shared<tree::CpuIdTree>();
+    tree::CpuIdProcessor cpu{};
+    cpu.AddLeaf(CpuIdRegister{0, 0, 1, 2, 3, 4});
+    cpu.AddLeaf(CpuIdRegister{1, 0, 5, 6, 7, 8});
+    cpu.AddLeaf(CpuIdRegister{4, 0, 9, 10, 11, 12});
+    tree->SetProcessor(0, std::move(cpu));
+    return tree;
+}
+
+TEST(CpuIdPlanReader, NoPlan)
+{
+    CpuIdSimulation simulation{0, GetTree()};
+    CpuIdCounter counter{simulation};
+    CpuIdPlanReader reader{counter, {}};
+    ASSERT_EQ(counter.calls, 0);
+
+    auto reg = reader.GetCpuId(1, 0);
+    ASSERT_TRUE(reg.IsValid());
+    ASSERT_EQ(reg.Eax(), 5);
+
+    std::array<CpuIdQuery, 2> queries{{{0, 0}, {4, 0}}};
+    std::array<CpuIdRegister, 2> cpuregs{};
+    reader.GetCpuId(queries.data(), cpuregs.data(), queries.size());
+    ASSERT_EQ(cpuregs[0].Eax(), 1);
+    ASSERT_EQ(cpuregs[1].Eax(), 9);
+
+    // Everything was queried directly and recorded.
+    ASSERT_EQ(counter.calls, 2);
+    ASSERT_EQ(reader.Misses(), 3);
+    ASSERT_EQ(reader.Queries().size(), 3);
+    ASSERT_EQ(reader.Queries()[0].eax, 1);
+    ASSERT_EQ(reader.Queries()[1].eax, 0);
+    ASSERT_EQ(reader.Queries()[2].eax, 4);
+}
+
+TEST(CpuIdPlanReader, Plan)
+{
+    CpuIdSimulation simulation{0, GetTree()};
+    CpuIdCounter counter{simulation};
+    std::vector<CpuIdQuery> plan{{0, 0}, {1, 0}, {4, 0}};
+    CpuIdPlanReader reader{counter, plan};
+
+    // The plan is made as one batch on construction.
+    ASSERT_EQ(counter.calls, 1);
+    ASSERT_EQ(counter.queries, 3);
+
+    ASSERT_EQ(reader.GetCpuId(0, 0).Eax(), 1);
+    std::array<CpuIdQuery, 2> queries{{{4, 0}, {1, 0}}};
+    std::array<CpuIdRegister, 2> cpuregs{};
+    reader.GetCpuId(queries.data(), cpuregs.data(), queries.size());
+    ASSERT_EQ(cpuregs[0].Eax(), 9);
+    ASSERT_EQ(cpuregs[1].Eax(), 5);
+
+    ASSERT_EQ(counter.calls, 1);
+    ASSERT_EQ(reader.Misses(), 0);
+    ASSERT_EQ(reader.Queries().size(), 3);
+}
+
+TEST(CpuIdPlanReader, PlanMiss)
+{
+    CpuIdSimulation simulation{0, GetTree()};
+    CpuIdCounter counter{simulation};
+    std::vector<CpuIdQuery> plan{{0, 0}, {2, 0}};
+    CpuIdPlanReader reader{counter, plan};
+    ASSERT_EQ(counter.calls, 1);
+
+    // Leaf 2 doesn't exist, so it is invalid and queried again.
+    ASSERT_FALSE(reader.GetCpuId(2, 0).IsValid());
+
+    std::array<CpuIdQuery, 3> queries{{{0, 0}, {1, 0}, {4, 0}}};
+    std::array<CpuIdRegister, 3> cpuregs{};
+    reader.GetCpuId(queries.data(), cpuregs.data(), queries.size());
+    ASSERT_EQ(cpuregs[0].Eax(), 1);
+    ASSERT_EQ(cpuregs[1].Eax(), 5);
+    ASSERT_EQ(cpuregs[2].Eax(), 9);
+
+    // The misses in the batch are queried as one batch.
+    ASSERT_EQ(counter.calls, 3);
+    ASSERT_EQ(reader.Misses(), 3);
+    ASSERT_EQ(reader.Queries().size(), 4);
+}
+
+}
@@ -40,6 +40,20 @@ TEST(CpuIdRegister, Value2)
     ASSERT_EQ(cpuidreg.Edx(), 0x49656E69);
 }
 
+TEST(CpuIdRegister, CompactValue)
+{
+    CpuIdValue value{0x00000014, 0x756E6547, 0x6C65746E, 0x49656E69};
+    CpuIdRegister cpuidreg{0, 1, value};
+    ASSERT_TRUE(cpuidreg.IsValid());
+    ASSERT_EQ(cpuidreg.InEax(), 0);
+    ASSERT_EQ(cpuidreg.InEcx(), 1);
+    ASSERT_EQ(cpuidreg.Eax(), 0x00000014);
+    ASSERT_EQ(cpuidreg.Ebx(), 0x756E6547);
+    ASSERT_EQ(cpuidreg.Ecx(), 0x6C65746E);
+    ASSERT_EQ(cpuidreg.Edx(), 0x49656E69);
+    ASSERT_TRUE(cpuidreg.Value() == value);
+}
+
 TEST(CpuIdRegister, CopyConstructor)
 {
     CpuIdRegister cpuidreg{0, 0, 0x00000014, 0x756E6547, 0x6C65746E, 0x49656E69};
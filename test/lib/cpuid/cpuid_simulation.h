@@ -23,6 +23,8 @@ public:
 
     auto GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister override;
 
+    using ICpuId::GetCpuId;
+
 private:
     unsigned int m_cpunum;
     std::shared_ptr<tree::CpuIdTree> m_tree;
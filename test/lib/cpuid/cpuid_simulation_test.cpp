@@ -4,6 +4,7 @@
 #include "cpuid/cpuid_simulation_config.h"
 #include "cpuid/tree/cpuid_tree.h"
 
+#include <array>
 #include <iostream>
 #include <memory>
 #include <utility>
@@ -66,4 +67,29 @@ TEST(CpuIdFactory, CpuIdSimulation)
     EXPECT_EQ(cpureg11.Edx(), 9);
 }
 
+TEST(CpuIdFactory, CpuIdSimulationBatch)
+{
+    tree::CpuIdTree tree{};
+    tree::CpuIdProcessor cpu0{};
+    cpu0.AddLeaf(CpuIdRegister{0, 0, 1, 2, 3, 4});
+    cpu0.AddLeaf(CpuIdRegister{1, 0, 5, 6, 7, 8});
+    tree.SetProcessor(0, std::move(cpu0));
+
+    CpuIdSimulationConfig config{tree};
+    auto factory = CreateCpuIdFactory(config);
+    auto cpuid0 = factory->create(0);
+
+    std::array<CpuIdQuery, 3> queries{{{1, 0}, {2, 0}, {0, 0}}};
+    std::array<CpuIdRegister, 3> cpuregs{};
+    cpuid0->GetCpuId(queries.data(), cpuregs.data(), queries.size());
+
+    EXPECT_TRUE(cpuregs[0].IsValid());
+    EXPECT_EQ(cpuregs[0].InEax(), 1);
+    EXPECT_EQ(cpuregs[0].Eax(), 5);
+    EXPECT_FALSE(cpuregs[1].IsValid());
+    EXPECT_TRUE(cpuregs[2].IsValid());
+    EXPECT_EQ(cpuregs[2].InEax(), 0);
+    EXPECT_EQ(cpuregs[2].Eax(), 1);
+}
+
 }
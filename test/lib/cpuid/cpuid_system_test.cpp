@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include "cpuid/cpuid_default_config.h"
+#include "cpuid/cpuid_factory.h"
+#include "cpuid/cpuid_simulation_config.h"
+#include "cpuid/cpuid_system.h"
+#include "cpuid/tree/cpuid_tree.h"
+#include "test_helper.h"
+
+#include <array>
+#include <memory>
+#include <thread>
+
+namespace rjcp::cpuid {
+
+TEST(CpuIdSystem, FromFactory)
+{
+    auto factory = CreateCpuIdFactory(CpuIdSimulationConfig{GetTestTree()});
+    CpuIdSystem system{*factory};
+    ASSERT_EQ(system.Size(), 4);
+
+    auto cpu = system.GetProcessor(2);
+    ASSERT_TRUE(cpu);
+    EXPECT_EQ(cpu.Cpu(), 2);
+    EXPECT_EQ(cpu.Size(), 4);
+
+    auto leaf = system.GetLeaf(3, 0x00000001, 0x00000000);
+    ASSERT_NE(leaf, nullptr);
+    EXPECT_EQ(leaf->Ebx(), 0x03100800);
+
+    EXPECT_FALSE(system.GetProcessor(4));
+    EXPECT_EQ(system.GetLeaf(4, 0x00000001, 0x00000000), nullptr);
+    EXPECT_EQ(system.GetLeaf(0, 0x00000002, 0x00000000), nullptr);
+}
+
+TEST(CpuIdSystem, HasResults)
+{
+    auto factory = CreateCpuIdFactory(CpuIdSimulationConfig{GetTestTree()});
+    CpuIdSystem system{*factory};
+    EXPECT_TRUE(system.HasResults());
+}
+
+TEST(CpuIdSystem, NoResults)
+{
+    // Every query is invalid, as when the device driver isn't loaded. Each CPU
+    // is still in the snapshot, so the size doesn't show that nothing was read.
+    auto factory = CreateCpuIdFactory(CpuIdDefaultConfig{});
+    CpuIdSystem system{*factory};
+    EXPECT_EQ(system.Size(), factory->cpus().back() + 1);
+    EXPECT_FALSE(system.HasResults());
+}
+
+TEST(CpuIdSystem, FromFactoryParallel)
+{
+    auto factory = CreateCpuIdFactory(CpuIdSimulationConfig{GetTestTree()});
+    CpuIdSystem system{*factory, GetCpuIdOptions{4}};
+    ASSERT_EQ(system.Size(), 4);
+    for (unsigned int cpunum = 0; cpunum < 4; cpunum++) {
+        auto leaf = system.GetLeaf(cpunum, 0x00000001, 0x00000000);
+        ASSERT_NE(leaf, nullptr);
+        EXPECT_EQ(leaf->Ebx(), 0x00100800 | (cpunum << 24));
+    }
+}
+
+TEST(CpuIdSystem, FromEmptyFactory)
+{
+    auto factory = CreateCpuIdFactory(CpuIdSimulationConfig{});
+    CpuIdSystem system{*factory};
+    ASSERT_NE(system.GetSnapshot(), nullptr);
+    EXPECT_EQ(system.Size(), 0);
+    EXPECT_EQ(system.GetLeaf(0, 0, 0), nullptr);
+}
+
+TEST(CpuIdSystem, Get)
+{
+    std::array<const CpuIdSystem*, 4> systems{};
+    std::array<std::thread, 4> threads{};
+    for (std::size_t i = 0; i < threads.size(); i++) {
+        threads[i] = std::thread([&systems, i]() { systems[i] = &CpuIdSystem::Get(); });
+    }
+    for (auto& thread: threads) thread.join();
+
+    const CpuIdSystem& system = CpuIdSystem::Get();
+    for (const auto* result: systems) EXPECT_EQ(result, &system);
+
+    // Every x86 CPU supports leaf 0.
+    ASSERT_GT(system.Size(), 0);
+    auto cpu = system.GetSnapshot()->GetProcessorAt(0);
+    EXPECT_NE(system.GetLeaf(cpu.Cpu(), 0, 0), nullptr);
+
+    // Too late to change how the system is enumerated.
+    EXPECT_FALSE(CpuIdSystem::Configure(CpuIdSystemOptions{CpuIdSystemReader::device}));
+}
+
+}
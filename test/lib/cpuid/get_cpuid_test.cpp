@@ -5,16 +5,134 @@
 #include "cpuid/cpuid_default_config.h"
 #include "cpuid/cpuid_device_config.h"
 #include "cpuid/cpuid_native_config.h"
+#include "cpuid/cpuid_native_engine_config.h"
 #include "cpuid/cpuid_simulation_config.h"
 #include "cpuid/get_cpuid.h"
 #include "cpuid/tree/cpuid_tree.h"
 #include "cpuid/tree/cpuid_write_xml.h"
+#include "cpuid/tree/cpuid_xml_sink.h"
+#include "os/qnx/native/sched/sched.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <sstream>
 #include <utility>
+#include <vector>
 
 namespace rjcp::cpuid {
 
+namespace {
+
+/**
+ * @brief A factory that may only query some of the CPUs of another factory,
+ * as for a process in a restricted cpuset.
+ */
+class CpuIdRestrictedFactory : public ICpuIdFactory
+{
+public:
+    CpuIdRestrictedFactory(std::unique_ptr<ICpuIdFactory> factory, std::vector<unsigned int> cpus)
+    : m_factory{std::move(factory)}, m_cpus{std::move(cpus)}
+    { }
+
+    auto create(unsigned int cpunum) noexcept -> std::unique_ptr<ICpuId> override
+    {
+        if (std::find(m_cpus.begin(), m_cpus.end(), cpunum) == m_cpus.end()) m_disallowed++;
+        return m_factory->create(cpunum);
+    }
+
+    auto threads() const -> unsigned int override
+    {
+        return m_factory->threads();
+    }
+
+    auto cpus() const -> std::vector<unsigned int> override
+    {
+        return m_cpus;
+    }
+
+    auto Disallowed() const -> unsigned int
+    {
+        return m_disallowed;
+    }
+
+private:
+    std::unique_ptr<ICpuIdFactory> m_factory;
+    std::vector<unsigned int> m_cpus;
+    std::atomic<unsigned int> m_disallowed{0};
+};
+
+// Checks the affinity of the thread when each CPU is queried.
+class CpuIdAffinityFactory : public ICpuIdFactory
+{
+public:
+    CpuIdAffinityFactory(std::unique_ptr<ICpuIdFactory> factory)
+    : m_factory{std::move(factory)}
+    {
+        auto affinity = os::qnx::native::sched::get_affinity();
+        if (affinity) m_affinity = std::move(*affinity);
+    }
+
+    auto create(unsigned int cpunum) noexcept -> std::unique_ptr<ICpuId> override
+    {
+        auto cpuid = m_factory->create(cpunum);
+        if (!cpuid) return nullptr;
+        return std::make_unique<Reader>(std::move(cpuid), *this);
+    }
+
+    auto threads() const -> unsigned int override
+    {
+        return m_factory->threads();
+    }
+
+    auto cpus() const -> std::vector<unsigned int> override
+    {
+        return m_factory->cpus();
+    }
+
+    auto Moved() const -> unsigned int
+    {
+        return m_moved;
+    }
+
+private:
+    class Reader final : public ICpuId
+    {
+    public:
+        Reader(std::unique_ptr<ICpuId> cpuid, CpuIdAffinityFactory& factory)
+        : m_cpuid{std::move(cpuid)}, m_factory{factory}
+        { }
+
+        auto GetCpuId(std::uint32_t eax, std::uint32_t ecx) const noexcept -> const CpuIdRegister override
+        {
+            m_factory.Check();
+            return m_cpuid->GetCpuId(eax, ecx);
+        }
+
+        void GetCpuId(const CpuIdQuery* queries, CpuIdRegister* registers, std::size_t count) const noexcept override
+        {
+            m_factory.Check();
+            m_cpuid->GetCpuId(queries, registers, count);
+        }
+
+    private:
+        std::unique_ptr<ICpuId> m_cpuid;
+        CpuIdAffinityFactory& m_factory;
+    };
+
+    void Check() noexcept
+    {
+        auto affinity = os::qnx::native::sched::get_affinity();
+        if (!affinity || *affinity != m_affinity) m_moved++;
+    }
+
+    std::unique_ptr<ICpuIdFactory> m_factory;
+    std::vector<unsigned int> m_affinity{};
+    std::atomic<unsigned int> m_moved{0};
+};
+
+}
+
 TEST(GetCpuId, NativeFactory)
 {
     auto factory = CreateCpuIdFactory(CpuIdNativeConfig{});
@@ -22,6 +140,13 @@ TEST(GetCpuId, NativeFactory)
     ASSERT_EQ(cpu->Size(), factory->threads());
 }
 
+TEST(GetCpuId, NativeEngineFactory)
+{
+    auto factory = CreateCpuIdFactory(CpuIdNativeEngineConfig{});
+    auto cpu = GetCpuId(*factory);
+    ASSERT_EQ(cpu->Size(), factory->threads());
+}
+
 TEST(GetCpuId, DeviceFactory)
 {
     auto factory = CreateCpuIdFactory(CpuIdDeviceConfig{});
@@ -36,6 +161,247 @@ TEST(GetCpuId, DefaultFactory)
     ASSERT_EQ(cpu->Size(), factory->threads());
 }
 
+TEST(GetCpuId, NativeFactoryParallel)
+{
+    auto factory = CreateCpuIdFactory(CpuIdNativeConfig{});
+    auto cpu = GetCpuId(*factory, GetCpuIdOptions{4});
+    ASSERT_EQ(cpu->Size(), factory->threads());
+
+    std::stringstream parallel{};
+    tree::WriteCpuIdXml(*cpu, parallel);
+
+    std::stringstream sequential{};
+    tree::WriteCpuIdXml(*GetCpuId(*factory), sequential);
+    ASSERT_EQ(parallel.str(), sequential.str());
+}
+
+TEST(GetCpuId, DeviceFactoryParallelUnpinned)
+{
+    // The device is read concurrently by workers that aren't moved to the CPU.
+    CpuIdAffinityFactory factory{CreateCpuIdFactory(CpuIdDeviceConfig{DeviceAccessMethod::pread})};
+    auto cpu = GetCpuId(factory, GetCpuIdOptions{4, false, false});
+    ASSERT_EQ(cpu->Size(), factory.threads());
+    EXPECT_EQ(factory.Moved(), 0);
+
+    std::stringstream parallel{};
+    tree::WriteCpuIdXml(*cpu, parallel);
+
+    std::stringstream sequential{};
+    tree::WriteCpuIdXml(*GetCpuId(factory), sequential);
+    ASSERT_EQ(parallel.str(), sequential.str());
+}
+
+TEST(GetCpuId, SimulationFactoryParallelUnpinned)
+{
+    std::shared_ptr<tree::CpuIdTree> tree = std::make_shared<tree::CpuIdTree>();
+    for (unsigned int cpunum = 0; cpunum < 6; cpunum++) {
+        tree::CpuIdProcessor cpu{};
+        cpu.AddLeaf(CpuIdRegister{0x00000000, 0x00000000, 0x00000001, 0x756E6547, 0x6C65746E, 0x49656E69});
+        cpu.AddLeaf(CpuIdRegister{0x00000001, 0x00000000, 0x000506E3, 0x00100800 | (cpunum << 24), 0x7FFAFBFF, 0xBFEBFBFF});
+        tree->SetProcessor(cpunum, std::move(cpu));
+    }
+
+    for (unsigned int workers = 2; workers <= 4; workers++) {
+        CpuIdAffinityFactory factory{CreateCpuIdFactory(CpuIdSimulationConfig{tree})};
+        auto cpus = GetCpuId(factory, GetCpuIdOptions{workers, false, false});
+        EXPECT_EQ(factory.Moved(), 0);
+
+        ASSERT_EQ(cpus->Size(), 6);
+        for (unsigned int cpunum = 0; cpunum < 6; cpunum++) {
+            EXPECT_TRUE(*cpus->GetProcessor(cpunum) == *tree->GetProcessor(cpunum)) << "CPU " << cpunum;
+        }
+    }
+}
+
+TEST(GetCpuId, SimulationFactoryParallel)
+{
+    // Each CPU has a different APIC identifier in leaf 1, so a mix up of the
+    // CPUs would be seen in the output.
+    std::shared_ptr<tree::CpuIdTree> tree = std::make_shared<tree::CpuIdTree>();
+    for (unsigned int cpunum = 0; cpunum < 16; cpunum++) {
+        tree::CpuIdProcessor cpu{};
+        cpu.AddLeaf(CpuIdRegister{0x00000000, 0x00000000, 0x00000001, 0x756E6547, 0x6C65746E, 0x49656E69});
+        cpu.AddLeaf(CpuIdRegister{0x00000001, 0x00000000, 0x000506E3, 0x00100800 | (cpunum << 24), 0x7FFAFBFF, 0xBFEBFBFF});
+        cpu.AddLeaf(CpuIdRegister{0x80000000, 0x00000000, 0x80000001, 0x00000000, 0x00000000, 0x00000000});
+        cpu.AddLeaf(CpuIdRegister{0x80000001, 0x00000000, 0x00000000, 0x00000000, 0x00000121, 0x2C100800});
+        tree->SetProcessor(cpunum, std::move(cpu));
+    }
+
+    auto factory = CreateCpuIdFactory(CpuIdSimulationConfig{tree});
+    auto sequential = GetCpuId(*factory);
+    auto parallel = GetCpuId(*factory, GetCpuIdOptions{3});
+    ASSERT_EQ(parallel->Size(), 16);
+
+    std::stringstream sequentialxml{};
+    tree::WriteCpuIdXml(*sequential, sequentialxml);
+    std::stringstream parallelxml{};
+    tree::WriteCpuIdXml(*parallel, parallelxml);
+    ASSERT_EQ(parallelxml.str(), sequentialxml.str());
+
+    for (unsigned int cpunum = 0; cpunum < 16; cpunum++) {
+        auto processor = parallel->GetProcessor(cpunum);
+        ASSERT_NE(processor, nullptr);
+        ASSERT_EQ(processor->Size(), 4);
+        EXPECT_EQ(processor->GetLeaf(1, 0)->Ebx() >> 24, cpunum);
+    }
+}
+
+TEST(GetCpuId, SimulationFactorySink)
+{
+    std::shared_ptr<tree::CpuIdTree> tree = std::make_shared<tree::CpuIdTree>();
+    for (unsigned int cpunum = 0; cpunum < 8; cpunum++) {
+        tree::CpuIdProcessor cpu{};
+        cpu.AddLeaf(CpuIdRegister{0x00000000, 0x00000000, 0x00000001, 0x756E6547, 0x6C65746E, 0x49656E69});
+        cpu.AddLeaf(CpuIdRegister{0x00000001, 0x00000000, 0x000506E3, 0x00100800 | (cpunum << 24), 0x7FFAFBFF, 0xBFEBFBFF});
+        tree->SetProcessor(cpunum, std::move(cpu));
+    }
+
+    auto factory = CreateCpuIdFactory(CpuIdSimulationConfig{tree});
+    std::stringstream treexml{};
+    tree::WriteCpuIdXml(*GetCpuId(*factory), treexml);
+
+    std::stringstream sequentialxml{};
+    tree::CpuIdXmlSink sequential{sequentialxml};
+    GetCpuId(*factory, sequential);
+    ASSERT_EQ(sequentialxml.str(), treexml.str());
+
+    std::stringstream parallelxml{};
+    tree::CpuIdXmlSink parallel{parallelxml};
+    GetCpuId(*factory, GetCpuIdOptions{3}, parallel);
+    ASSERT_EQ(parallelxml.str(), treexml.str());
+}
+
+TEST(GetCpuId, SimulationFactoryRestricted)
+{
+    std::shared_ptr<tree::CpuIdTree> tree = std::make_shared<tree::CpuIdTree>();
+    for (unsigned int cpunum = 0; cpunum < 6; cpunum++) {
+        tree::CpuIdProcessor cpu{};
+        cpu.AddLeaf(CpuIdRegister{0x00000000, 0x00000000, 0x00000001, 0x756E6547, 0x6C65746E, 0x49656E69});
+        cpu.AddLeaf(CpuIdRegister{0x00000001, 0x00000000, 0x000506E3, 0x00100800 | (cpunum << 24), 0x7FFAFBFF, 0xBFEBFBFF});
+        tree->SetProcessor(cpunum, std::move(cpu));
+    }
+
+    for (unsigned int workers = 1; workers <= 3; workers++) {
+        CpuIdRestrictedFactory factory{CreateCpuIdFactory(CpuIdSimulationConfig{tree}), {1, 3, 4}};
+        auto cpus = GetCpuId(factory, GetCpuIdOptions{workers});
+        EXPECT_EQ(factory.Disallowed(), 0);
+
+        // CPUs that can't be queried are recorded as disallowed up to the
+        // number of threads, so that the CPU numbers are kept. CPU 5 is after
+        // the last allowed CPU.
+        ASSERT_EQ(cpus->Size(), 6);
+        for (unsigned int cpunum = 0; cpunum < 6; cpunum++) {
+            auto processor = cpus->GetProcessor(cpunum);
+            ASSERT_NE(processor, nullptr);
+            if (cpunum == 1 || cpunum == 3 || cpunum == 4) {
+                ASSERT_EQ(processor->Size(), 2);
+                EXPECT_FALSE(processor->IsDisallowed());
+                EXPECT_EQ(processor->GetLeaf(1, 0)->Ebx() >> 24, cpunum);
+            } else {
+                EXPECT_TRUE(processor->IsEmpty());
+                EXPECT_TRUE(processor->IsDisallowed());
+            }
+        }
+    }
+}
+
+TEST(GetCpuId, SimulationFactoryMissingLeaf)
+{
+    // Leaf 2 can't be read, so it isn't in the tree, but the leaves after it
+    // are. The vendor is unknown, so only the standard region is read.
+    std::shared_ptr<tree::CpuIdTree> tree = std::make_shared<tree::CpuIdTree>();
+    tree::CpuIdProcessor cpu{};
+    cpu.AddLeaf(CpuIdRegister{0x00000000, 0x00000000, 0x00000003, 0x00000000, 0x00000000, 0x00000000});
+    cpu.AddLeaf(CpuIdRegister{0x00000001, 0x00000000, 0x000506E3, 0x00100800, 0x7FFAFBFF, 0xBFEBFBFF});
+    cpu.AddLeaf(CpuIdRegister{0x00000003, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000});
+    tree->SetProcessor(0, std::move(cpu));
+
+    auto factory = CreateCpuIdFactory(CpuIdSimulationConfig{tree});
+    for (unsigned int workers = 1; workers <= 2; workers++) {
+        auto cpus = GetCpuId(*factory, GetCpuIdOptions{workers});
+        ASSERT_EQ(cpus->Size(), 1);
+
+        auto processor = cpus->GetProcessor(0);
+        ASSERT_NE(processor, nullptr);
+        EXPECT_EQ(processor->Size(), 3);
+        EXPECT_EQ(processor->GetLeaf(2, 0), nullptr);
+        EXPECT_NE(processor->GetLeaf(3, 0), nullptr);
+    }
+}
+
+TEST(GetCpuId, SimulationFactoryHybrid)
+{
+    // CPUs 2 and 3 have a different structure to the others, so the plan from
+    // CPU 0 doesn't apply. The results must be the same as for a single CPU.
+    std::shared_ptr<tree::CpuIdTree> tree = std::make_shared<tree::CpuIdTree>();
+    for (unsigned int cpunum = 0; cpunum < 6; cpunum++) {
+        bool ecore = cpunum == 2 || cpunum == 3;
+        tree::CpuIdProcessor cpu{};
+        cpu.AddLeaf(CpuIdRegister{0x00000000, 0x00000000, ecore ? 0x00000004U : 0x00000001U, 0x756E6547, 0x6C65746E, 0x49656E69});
+        cpu.AddLeaf(CpuIdRegister{0x00000001, 0x00000000, 0x000506E3, 0x00100800 | (cpunum << 24), 0x7FFAFBFF, 0xBFEBFBFF});
+        if (ecore) {
+            cpu.AddLeaf(CpuIdRegister{0x00000004, 0x00000000, 0x00000121, 0x01C0003F, 0x0000003F, 0x00000000});
+            cpu.AddLeaf(CpuIdRegister{0x00000004, 0x00000001, 0x00000122, 0x01C0003F, 0x0000003F, 0x00000000});
+        }
+        cpu.AddLeaf(CpuIdRegister{0x80000000, 0x00000000, 0x80000001, 0x00000000, 0x00000000, 0x00000000});
+        cpu.AddLeaf(CpuIdRegister{0x80000001, 0x00000000, 0x00000000, 0x00000000, 0x00000121, 0x2C100800});
+        tree->SetProcessor(cpunum, std::move(cpu));
+    }
+
+    auto factory = CreateCpuIdFactory(CpuIdSimulationConfig{tree});
+    for (unsigned int workers = 1; workers <= 3; workers++) {
+        auto cpus = GetCpuId(*factory, GetCpuIdOptions{workers});
+        ASSERT_EQ(cpus->Size(), 6);
+
+        for (unsigned int cpunum = 0; cpunum < 6; cpunum++) {
+            std::shared_ptr<tree::CpuIdTree> single = std::make_shared<tree::CpuIdTree>();
+            single->SetProcessor(0, *tree->GetProcessor(cpunum));
+            auto singlefactory = CreateCpuIdFactory(CpuIdSimulationConfig{single});
+            auto expected = GetCpuId(*singlefactory);
+
+            ASSERT_NE(expected->GetProcessor(0), nullptr);
+            EXPECT_TRUE(*cpus->GetProcessor(cpunum) == *expected->GetProcessor(0)) << "CPU " << cpunum;
+        }
+    }
+}
+
+TEST(GetCpuId, SimulationFactoryIntern)
+{
+    std::shared_ptr<tree::CpuIdTree> tree = std::make_shared<tree::CpuIdTree>();
+    for (unsigned int cpunum = 0; cpunum < 16; cpunum++) {
+        tree::CpuIdProcessor cpu{};
+        cpu.AddLeaf(CpuIdRegister{0x00000000, 0x00000000, 0x00000001, 0x756E6547, 0x6C65746E, 0x49656E69});
+        cpu.AddLeaf(CpuIdRegister{0x00000001, 0x00000000, 0x000506E3, 0x00100800 | (cpunum << 24), 0x7FFAFBFF, 0xBFEBFBFF});
+        cpu.AddLeaf(CpuIdRegister{0x80000000, 0x00000000, 0x80000001, 0x00000000, 0x00000000, 0x00000000});
+        cpu.AddLeaf(CpuIdRegister{0x80000001, 0x00000000, 0x00000000, 0x00000000, 0x00000121, 0x2C100800});
+        tree->SetProcessor(cpunum, std::move(cpu));
+    }
+
+    auto factory = CreateCpuIdFactory(CpuIdSimulationConfig{tree});
+    auto sequential = GetCpuId(*factory);
+    auto interned = GetCpuId(*factory, GetCpuIdOptions{1, true});
+    ASSERT_EQ(interned->Size(), 16);
+
+    // One processor with 4 leaves, and one difference for the 15 others.
+    auto stats = interned->Stats();
+    EXPECT_EQ(stats.Leaves(), 64);
+    EXPECT_EQ(stats.Stored(), 4 + 15);
+    EXPECT_EQ(sequential->Stats().Stored(), 64);
+
+    std::stringstream sequentialxml{};
+    tree::WriteCpuIdXml(*sequential, sequentialxml);
+    std::stringstream internedxml{};
+    tree::WriteCpuIdXml(*interned, internedxml);
+    ASSERT_EQ(internedxml.str(), sequentialxml.str());
+
+    for (unsigned int cpunum = 0; cpunum < 16; cpunum++) {
+        auto processor = interned->GetProcessor(cpunum);
+        ASSERT_NE(processor, nullptr);
+        EXPECT_EQ(processor->GetLeaf(1, 0)->Ebx() >> 24, cpunum);
+        EXPECT_TRUE(*processor == *sequential->GetProcessor(cpunum));
+    }
+}
+
 TEST(GetCpuId, GenuineIntel_i7_6700T_SGX)
 {
     // The following data is taken from an i7-6700T CPU.
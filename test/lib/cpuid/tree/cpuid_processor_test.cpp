@@ -2,6 +2,10 @@
 
 #include "cpuid/tree/cpuid_processor.h"
 
+#include <iterator>
+#include <utility>
+#include <vector>
+
 namespace rjcp::cpuid::tree {
 
 TEST(CpuIdProcessor, DefaultConstructor)
@@ -28,6 +32,11 @@ static void CheckRegister(const CpuIdRegister* reg, std::uint32_t eax, std::uint
     ASSERT_EQ(reg->Edx(), 0x44444444 + ecx);
 }
 
+static void CheckRegister(const CpuIdRegisterPtr& reg, std::uint32_t eax, std::uint32_t ecx)
+{
+    CheckRegister(reg.get(), eax, ecx);
+}
+
 TEST(CpuIdProcessor, GetLeafNonExistent)
 {
     CpuIdProcessor processor{};
@@ -101,6 +110,214 @@ TEST(CpuIdProcessor, AddLeafMoveMultiple)
     ASSERT_EQ(processor.GetLeaf(0x80000000, 0), nullptr);
 }
 
+TEST(CpuIdProcessor, AddLeafExistsOutOfOrder)
+{
+    CpuIdProcessor processor{};
+    ASSERT_TRUE(processor.AddLeaf(GetReg(13, 1)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(1, 0)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(13, 0)));
+
+    // Existing leaves not at the end are not added a second time.
+    ASSERT_FALSE(processor.AddLeaf(GetReg(1, 0)));
+    ASSERT_FALSE(processor.AddLeaf(GetReg(13, 0)));
+    ASSERT_EQ(processor.Size(), 3);
+
+    CheckRegister(processor.GetLeaf(1, 0), 1, 0);
+    CheckRegister(processor.GetLeaf(13, 0), 13, 0);
+    CheckRegister(processor.GetLeaf(13, 1), 13, 1);
+    ASSERT_EQ(processor.GetLeaf(0, 0), nullptr);
+    ASSERT_EQ(processor.GetLeaf(13, 2), nullptr);
+}
+
+TEST(CpuIdProcessor, AddLeafSubleafOrder)
+{
+    // The subleaf must not be interpreted as signed, and the leaf sorts first.
+    CpuIdProcessor processor{};
+    ASSERT_TRUE(processor.AddLeaf(GetReg(0x80000000, 0)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(1, 0xFFFFFFFF)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(1, 0)));
+
+    auto reg = processor.cbegin();
+    CheckRegister(&reg->second, 1, 0);
+    reg++;
+    CheckRegister(&reg->second, 1, 0xFFFFFFFF);
+    reg++;
+    CheckRegister(&reg->second, 0x80000000, 0);
+    reg++;
+    ASSERT_EQ(reg, processor.cend());
+}
+
+TEST(CpuIdProcessor, FindLeaf)
+{
+    CpuIdProcessor processor{};
+    ASSERT_EQ(processor.FindLeaf(0, 0), nullptr);
+    ASSERT_TRUE(processor.AddLeaf(GetReg(13, 1)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(0x80000000, 0)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(1, 0)));
+
+    CheckRegister(processor.FindLeaf(1, 0), 1, 0);
+    CheckRegister(processor.FindLeaf(13, 1), 13, 1);
+    CheckRegister(processor.FindLeaf(0x80000000, 0), 0x80000000, 0);
+    ASSERT_EQ(processor.FindLeaf(13, 0), nullptr);
+    ASSERT_EQ(processor.FindLeaf(0x80000001, 0), nullptr);
+}
+
+TEST(CpuIdProcessor, Leaves)
+{
+    CpuIdProcessor processor{};
+    ASSERT_TRUE(processor.AddLeaf(GetReg(13, 1)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(1, 0)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(0, 0)));
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> leaves{};
+    for (const auto& leaf : processor.Leaves()) {
+        CheckRegister(&leaf.second, leaf.second.InEax(), leaf.second.InEcx());
+        leaves.emplace_back(leaf.second.InEax(), leaf.second.InEcx());
+    }
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> expected{{0, 0}, {1, 0}, {13, 1}};
+    ASSERT_EQ(leaves, expected);
+
+    CpuIdProcessor empty{};
+    ASSERT_EQ(empty.Leaves().begin(), empty.Leaves().end());
+}
+
+TEST(CpuIdProcessor, GetLeafPointerAfterAddLeaf)
+{
+    // As for a map, the pointer is still valid when more leaves are added.
+    CpuIdProcessor processor{};
+    ASSERT_TRUE(processor.AddLeaf(GetReg(1, 0)));
+    const CpuIdRegister* reg = processor.GetLeaf(1, 0);
+    CheckRegister(reg, 1, 0);
+
+    ASSERT_TRUE(processor.AddLeaf(GetReg(0, 0)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(2, 0)));
+    ASSERT_EQ(processor.GetLeaf(1, 0), reg);
+    CheckRegister(reg, 1, 0);
+    CheckRegister(processor.GetLeaf(0, 0), 0, 0);
+    CheckRegister(processor.GetLeaf(2, 0), 2, 0);
+    ASSERT_EQ(processor.Size(), 3);
+}
+
+TEST(CpuIdProcessor, IterateModify)
+{
+    CpuIdProcessor processor{};
+    ASSERT_TRUE(processor.AddLeaf(GetReg(0, 0)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(1, 0)));
+    CpuIdProcessor copy = processor;
+    CpuIdProcessor base = processor;
+    ASSERT_TRUE(copy.Intern(base));
+
+    // The change is seen by all accessors, but not by other processors.
+    for (auto& reg : copy) {
+        if (reg.first.eax == 1) reg.second = CpuIdRegister{1, 0, 1, 2, 3, 4};
+    }
+    ASSERT_EQ(copy.GetLeaf(1, 0)->Ebx(), 2);
+    ASSERT_EQ(copy.FindLeaf(1, 0)->Ebx(), 2);
+    ASSERT_EQ((++copy.Leaves().begin())->second.Ebx(), 2);
+    ASSERT_TRUE(copy != processor);
+    CheckRegister(base.FindLeaf(1, 0), 1, 0);
+    CheckRegister(processor.FindLeaf(1, 0), 1, 0);
+
+    // The processor is no longer shared, a copy of it is independent.
+    ASSERT_FALSE(copy.Intern(base));
+    ASSERT_FALSE(base.Intern(copy));
+    CpuIdProcessor copy2 = copy;
+    copy.begin()->second = CpuIdRegister{0, 0, 5, 6, 7, 8};
+    ASSERT_EQ(copy.FindLeaf(0, 0)->Eax(), 5);
+    CheckRegister(copy2.FindLeaf(0, 0), 0, 0);
+    ASSERT_EQ(copy2.FindLeaf(1, 0)->Ebx(), 2);
+
+    // Leaves added later are still at the right position.
+    ASSERT_TRUE(copy.AddLeaf(GetReg(0, 1)));
+    std::next(copy.begin(), 2)->second = CpuIdRegister{1, 0, 9, 9, 9, 9};
+    CheckRegister(copy.FindLeaf(0, 1), 0, 1);
+    ASSERT_EQ(copy.FindLeaf(1, 0)->Eax(), 9);
+}
+
+TEST(CpuIdProcessor, GetLeafRegions)
+{
+    // Leaves in the standard, hypervisor and extended regions are indexed,
+    // others are not. They should all be found.
+    CpuIdProcessor processor{};
+    ASSERT_TRUE(processor.AddLeaf(GetReg(0x80000001, 0)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(0x40000000, 0)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(0xC0000000, 0)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(0x00000100, 0)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(0x000000FF, 0)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(0x00000000, 0)));
+
+    CheckRegister(processor.GetLeaf(0x00000000, 0), 0x00000000, 0);
+    CheckRegister(processor.GetLeaf(0x000000FF, 0), 0x000000FF, 0);
+    CheckRegister(processor.GetLeaf(0x00000100, 0), 0x00000100, 0);
+    CheckRegister(processor.GetLeaf(0x40000000, 0), 0x40000000, 0);
+    CheckRegister(processor.GetLeaf(0x80000001, 0), 0x80000001, 0);
+    CheckRegister(processor.GetLeaf(0xC0000000, 0), 0xC0000000, 0);
+    ASSERT_EQ(processor.GetLeaf(0x00000001, 0), nullptr);
+    ASSERT_EQ(processor.GetLeaf(0x40000001, 0), nullptr);
+    ASSERT_EQ(processor.GetLeaf(0x80000000, 0), nullptr);
+    ASSERT_EQ(processor.GetLeaf(0xC0000001, 0), nullptr);
+}
+
+TEST(CpuIdProcessor, GetLeafSubleafs)
+{
+    // Subleafs may be added before subleaf 0, or without subleaf 0.
+    CpuIdProcessor processor{};
+    ASSERT_TRUE(processor.AddLeaf(GetReg(7, 1)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(4, 2)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(7, 0)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(1, 0)));
+    ASSERT_TRUE(processor.AddLeaf(GetReg(7, 2)));
+
+    CheckRegister(processor.GetLeaf(1, 0), 1, 0);
+    CheckRegister(processor.GetLeaf(4, 2), 4, 2);
+    CheckRegister(processor.GetLeaf(7, 0), 7, 0);
+    CheckRegister(processor.GetLeaf(7, 1), 7, 1);
+    CheckRegister(processor.GetLeaf(7, 2), 7, 2);
+    ASSERT_EQ(processor.GetLeaf(4, 0), nullptr);
+    ASSERT_EQ(processor.GetLeaf(4, 1), nullptr);
+    ASSERT_EQ(processor.GetLeaf(7, 3), nullptr);
+}
+
+TEST(CpuIdProcessor, AddLeafInvalid)
+{
+    CpuIdProcessor processor{};
+    ASSERT_FALSE(processor.AddLeaf(CpuIdRegister{}));
+    ASSERT_TRUE(processor.IsEmpty());
+}
+
+TEST(CpuIdProcessor, Compare)
+{
+    CpuIdProcessor processor1{};
+    CpuIdProcessor processor2{};
+    ASSERT_TRUE(processor1 == processor2);
+
+    ASSERT_TRUE(processor1.AddLeaf(GetReg(0, 0)));
+    ASSERT_TRUE(processor1.AddLeaf(GetReg(1, 0)));
+    ASSERT_TRUE(processor1 != processor2);
+
+    // Order of adding doesn't matter.
+    ASSERT_TRUE(processor2.AddLeaf(GetReg(1, 0)));
+    ASSERT_TRUE(processor2.AddLeaf(GetReg(0, 0)));
+    ASSERT_TRUE(processor1 == processor2);
+
+    // Same leaf, different result.
+    CpuIdProcessor processor3{};
+    ASSERT_TRUE(processor3.AddLeaf(GetReg(0, 0)));
+    ASSERT_TRUE(processor3.AddLeaf(CpuIdRegister{1, 0, 0, 0, 0, 0}));
+    ASSERT_TRUE(processor1 != processor3);
+}
+
+TEST(CpuIdProcessor, Reserve)
+{
+    CpuIdProcessor processor{};
+    processor.Reserve(16);
+    ASSERT_TRUE(processor.IsEmpty());
+
+    ASSERT_TRUE(processor.AddLeaf(GetReg(0, 0)));
+    ASSERT_EQ(processor.Size(), 1);
+    CheckRegister(processor.GetLeaf(0, 0), 0, 0);
+}
+
 TEST(CpuIdProcessor, IterateEmpty)
 {
     CpuIdProcessor processor{};
@@ -302,4 +519,117 @@ TEST(CpuIdProcessor, MoveAssignment)
     ASSERT_EQ(reg, move_processor.cend());
 }
 
+TEST(CpuIdProcessor, MoveConstructorGetLeaf)
+{
+    CpuIdProcessor processor{};
+    ASSERT_TRUE(processor.AddLeaf(GetReg(0, 0)));
+
+    CpuIdProcessor move_processor{std::move(processor)};
+    CheckRegister(move_processor.GetLeaf(0, 0), 0, 0);
+
+    // The object moved from must not find leaves from the index.
+    // NOLINTNEXTLINE(bugprone-use-after-move)
+    ASSERT_EQ(processor.GetLeaf(0, 0), nullptr);
+    ASSERT_TRUE(processor.AddLeaf(GetReg(1, 0)));
+    CheckRegister(processor.GetLeaf(1, 0), 1, 0);
+    ASSERT_EQ(processor.GetLeaf(0, 0), nullptr);
+}
+
+TEST(CpuIdProcessor, InternIdentical)
+{
+    CpuIdProcessor base{};
+    CpuIdProcessor processor{};
+    for (std::uint32_t leaf = 0; leaf < 8; leaf++) {
+        ASSERT_TRUE(base.AddLeaf(GetReg(leaf, 0)));
+        ASSERT_TRUE(processor.AddLeaf(GetReg(leaf, 0)));
+    }
+
+    ASSERT_TRUE(processor.Intern(base));
+    ASSERT_TRUE(processor == base);
+    ASSERT_EQ(processor.Size(), 8);
+    CheckRegister(processor.GetLeaf(7, 0), 7, 0);
+}
+
+TEST(CpuIdProcessor, InternDelta)
+{
+    CpuIdProcessor base{};
+    CpuIdProcessor processor{};
+    for (std::uint32_t leaf = 0; leaf < 8; leaf++) {
+        ASSERT_TRUE(base.AddLeaf(GetReg(leaf, 0)));
+        if (leaf == 1) {
+            ASSERT_TRUE(processor.AddLeaf(CpuIdRegister{1, 0, 1, 2, 3, 4}));
+        } else {
+            ASSERT_TRUE(processor.AddLeaf(GetReg(leaf, 0)));
+        }
+    }
+    CpuIdProcessor copy = processor;
+
+    ASSERT_TRUE(processor.Intern(base));
+    ASSERT_TRUE(processor != base);
+    ASSERT_TRUE(processor == copy);
+
+    // The result that is different is still seen through GetLeaf and
+    // iteration.
+    auto reg1 = processor.GetLeaf(1, 0);
+    ASSERT_NE(reg1, nullptr);
+    ASSERT_EQ(reg1->Ebx(), 2);
+    CheckRegister(processor.GetLeaf(2, 0), 2, 0);
+
+    auto reg = processor.cbegin();
+    reg++;
+    ASSERT_EQ(reg->second.InEax(), 1);
+    ASSERT_EQ(reg->second.Edx(), 4);
+    reg++;
+    CheckRegister(&reg->second, 2, 0);
+}
+
+TEST(CpuIdProcessor, InternCopyOnWrite)
+{
+    CpuIdProcessor base{};
+    CpuIdProcessor processor{};
+    for (std::uint32_t leaf = 0; leaf < 8; leaf++) {
+        ASSERT_TRUE(base.AddLeaf(GetReg(leaf, 0)));
+        if (leaf == 1) {
+            ASSERT_TRUE(processor.AddLeaf(CpuIdRegister{1, 0, 1, 2, 3, 4}));
+        } else {
+            ASSERT_TRUE(processor.AddLeaf(GetReg(leaf, 0)));
+        }
+    }
+    ASSERT_TRUE(processor.Intern(base));
+
+    // Modifying either processor doesn't modify the other.
+    ASSERT_TRUE(processor.AddLeaf(GetReg(3, 1)));
+    ASSERT_TRUE(base.AddLeaf(GetReg(0x80000000, 0)));
+    ASSERT_EQ(processor.Size(), 9);
+    ASSERT_EQ(base.Size(), 9);
+    ASSERT_EQ(processor.GetLeaf(0x80000000, 0), nullptr);
+    ASSERT_EQ(base.GetLeaf(3, 1), nullptr);
+    ASSERT_EQ(processor.GetLeaf(1, 0)->Ebx(), 2);
+    CheckRegister(base.GetLeaf(1, 0), 1, 0);
+}
+
+TEST(CpuIdProcessor, InternDifferent)
+{
+    CpuIdProcessor base{};
+    ASSERT_TRUE(base.AddLeaf(GetReg(0, 0)));
+    ASSERT_TRUE(base.AddLeaf(GetReg(1, 0)));
+
+    // Different leaves.
+    CpuIdProcessor processor1{};
+    ASSERT_TRUE(processor1.AddLeaf(GetReg(0, 0)));
+    ASSERT_TRUE(processor1.AddLeaf(GetReg(2, 0)));
+    ASSERT_FALSE(processor1.Intern(base));
+
+    // Same leaves, too many differences.
+    CpuIdProcessor processor2{};
+    ASSERT_TRUE(processor2.AddLeaf(CpuIdRegister{0, 0, 0, 0, 0, 0}));
+    ASSERT_TRUE(processor2.AddLeaf(GetReg(1, 0)));
+    ASSERT_FALSE(processor2.Intern(base));
+    ASSERT_EQ(processor2.GetLeaf(0, 0)->Eax(), 0);
+
+    // Empty.
+    CpuIdProcessor processor3{};
+    ASSERT_FALSE(processor3.Intern(base));
+}
+
 }
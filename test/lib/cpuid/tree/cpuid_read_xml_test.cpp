@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include "cpuid/tree/cpuid_read_xml.h"
+#include "cpuid/tree/cpuid_tree_sink.h"
+#include "cpuid/tree/cpuid_write_xml.h"
+#include "test_helper.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace rjcp::cpuid::tree {
+
+namespace {
+
+auto Read(const std::string& xml) -> std::unique_ptr<CpuIdTree>
+{
+    auto tree = std::make_unique<CpuIdTree>();
+    CpuIdTreeSink sink{*tree};
+    if (!ReadCpuIdXml(xml, sink)) return nullptr;
+    return tree;
+}
+
+}
+
+TEST(CpuIdReadXml, RoundTrip)
+{
+    CpuIdTree tree = GetTestTree();
+    std::stringstream xml{};
+    WriteCpuIdXml(tree, xml);
+
+    auto result = Read(xml.str());
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(result->Size(), 4);
+    for (unsigned int cpunum = 0; cpunum < 4; cpunum++) {
+        auto processor = result->GetProcessor(cpunum);
+        ASSERT_NE(processor, nullptr);
+        ASSERT_EQ(*processor, *tree.GetProcessor(cpunum));
+    }
+
+    std::stringstream rewritten{};
+    WriteCpuIdXml(*result, rewritten);
+    ASSERT_EQ(rewritten.str(), xml.str());
+}
+
+TEST(CpuIdReadXml, RoundTripEmptyProcessor)
+{
+    // A CPU that couldn't be queried is kept, so the CPUs after it have the
+    // same numbers when read.
+    CpuIdTree full = GetTestTree();
+    CpuIdTree tree{};
+    for (unsigned int cpunum = 0; cpunum < 4; cpunum++) {
+        tree.SetProcessor(cpunum, cpunum == 1 ? CpuIdProcessor{} : *full.GetProcessor(cpunum));
+    }
+    std::stringstream xml{};
+    WriteCpuIdXml(tree, xml);
+
+    auto result = Read(xml.str());
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(result->Size(), 4);
+    EXPECT_TRUE(result->GetProcessor(1)->IsEmpty());
+    ASSERT_EQ(*result->GetProcessor(3), *tree.GetProcessor(3));
+}
+
+TEST(CpuIdReadXml, RoundTripDisallowedProcessor)
+{
+    CpuIdTree full = GetTestTree();
+    CpuIdTree tree{};
+    for (unsigned int cpunum = 0; cpunum < 4; cpunum++) {
+        CpuIdProcessor processor{};
+        if (cpunum == 1) {
+            processor.SetDisallowed(true);
+        } else {
+            processor = *full.GetProcessor(cpunum);
+        }
+        tree.SetProcessor(cpunum, std::move(processor));
+    }
+    std::stringstream xml{};
+    WriteCpuIdXml(tree, xml);
+    EXPECT_NE(xml.str().find("  <processor disallowed=\"true\" />\n"), std::string::npos);
+
+    auto result = Read(xml.str());
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(result->Size(), 4);
+    EXPECT_TRUE(result->GetProcessor(1)->IsDisallowed());
+    EXPECT_FALSE(result->GetProcessor(2)->IsDisallowed());
+    ASSERT_EQ(*result->GetProcessor(3), *tree.GetProcessor(3));
+
+    // The attribute is also accepted on a processor with a closing tag.
+    result = Read("<cpuid><processor disallowed='true'></processor></cpuid>");
+    ASSERT_NE(result, nullptr);
+    EXPECT_TRUE(result->GetProcessor(0)->IsDisallowed());
+    ASSERT_EQ(Read("<cpuid><processor disallowed='true'><register eax='0' ecx='0'>0,0,0,0</register></processor></cpuid>"), nullptr);
+}
+
+TEST(CpuIdReadXml, Empty)
+{
+    auto result = Read(R"(<?xml version="1.0" encoding="utf-8"?><cpuid type="x86"></cpuid>)");
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(result->Size(), 0);
+
+    result = Read(R"(<cpuid type="x86"/>)");
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(result->Size(), 0);
+}
+
+TEST(CpuIdReadXml, Tolerant)
+{
+    // Different whitespace, quoting, comments, and short and lower case hex.
+    auto result = Read(
+        "<?xml version='1.0'?>\r\n"
+        "<!-- A comment -->\r\n"
+        "<cpuid type='x86'>\r\n"
+        "\t<processor>\r\n"
+        "\t\t<register ecx='0' eax = 'a'> 16 ,756e6547,6c65746e, 49656E69 </register>\r\n"
+        "\t</processor>\r\n"
+        "\t<processor />\r\n"
+        "</cpuid>\r\n");
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(result->Size(), 2);
+    auto processor = result->GetProcessor(0);
+    ASSERT_NE(processor, nullptr);
+    auto reg = processor->GetLeaf(10, 0);
+    ASSERT_NE(reg, nullptr);
+    EXPECT_EQ(reg->Eax(), 0x16);
+    EXPECT_EQ(reg->Ebx(), 0x756E6547);
+    EXPECT_EQ(reg->Ecx(), 0x6C65746E);
+    EXPECT_EQ(reg->Edx(), 0x49656E69);
+    processor = result->GetProcessor(1);
+    ASSERT_NE(processor, nullptr);
+    ASSERT_EQ(processor->Size(), 0);
+}
+
+TEST(CpuIdReadXml, Malformed)
+{
+    EXPECT_EQ(Read(""), nullptr);
+    EXPECT_EQ(Read("<cpuid>"), nullptr);
+    EXPECT_EQ(Read("<processor></processor>"), nullptr);
+    EXPECT_EQ(Read("<cpuid><processor></cpuid>"), nullptr);
+    EXPECT_EQ(Read("<cpuid></cpuid><cpuid></cpuid>"), nullptr);
+    EXPECT_EQ(Read("<cpuid><processor><register eax=\"0\">0,0,0,0</register></processor></cpuid>"), nullptr);
+    EXPECT_EQ(Read("<cpuid><processor><register eax=\"0\" ecx=\"0\">0,0,0</register></processor></cpuid>"), nullptr);
+    EXPECT_EQ(Read("<cpuid><processor><register eax=\"0\" ecx=\"0\">0,0,0,0,0</register></processor></cpuid>"), nullptr);
+    EXPECT_EQ(Read("<cpuid><processor><register eax=\"0\" ecx=\"0\">0,0,0,X</register></processor></cpuid>"), nullptr);
+    EXPECT_EQ(Read("<cpuid><processor><register eax=\"100000000\" ecx=\"0\">0,0,0,0</register></processor></cpuid>"), nullptr);
+    EXPECT_EQ(Read("<cpuid><processor><register eax=\"0\" ecx=\"0\">0,0,0,0</processor></cpuid>"), nullptr);
+    EXPECT_EQ(Read("<cpuid><processor><register eax=\"0\" ecx=\"0\">0,0,0,0</register></processor>"), nullptr);
+}
+
+TEST(CpuIdReadXml, ReadFile)
+{
+    CpuIdTree tree = GetTestTree();
+    TempFile file{};
+    ASSERT_TRUE(file.Valid());
+    {
+        std::ofstream stream{file.Name()};
+        WriteCpuIdXml(tree, stream);
+    }
+
+    auto result = ReadCpuIdXml(file.Name());
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(result->Size(), 4);
+    ASSERT_EQ(*result->GetProcessor(3), *tree.GetProcessor(3));
+}
+
+TEST(CpuIdReadXml, ReadNonExistentFile)
+{
+    ASSERT_EQ(ReadCpuIdXml(std::string{"/dev/nonexistant"}), nullptr);
+}
+
+}
@@ -0,0 +1,242 @@
+#include <gtest/gtest.h>
+
+#include "cpuid/tree/cpuid_snapshot.h"
+#include "cpuid/tree/cpuid_snapshot_format.h"
+#include "cpuid/tree/cpuid_tree_sink.h"
+#include "cpuid/tree/cpuid_write_snapshot.h"
+#include "cpuid/tree/cpuid_write_xml.h"
+#include "test_helper.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace rjcp::cpuid::tree {
+
+namespace {
+
+auto GetProcessor(unsigned int cpunum) -> CpuIdProcessor
+{
+    // Subleafs, and leaves in every region of the index and outside of it.
+    CpuIdProcessor processor = GetTestProcessor(cpunum);
+    for (std::uint32_t leaf = 2; leaf < 16; leaf++) {
+        processor.AddLeaf(CpuIdRegister{leaf, 0, leaf, 0, 0, 0});
+    }
+    processor.AddLeaf(CpuIdRegister{4, 1, 0x1C004122, 0x00C0003F, 0x0000003F, 0x00000000});
+    processor.AddLeaf(CpuIdRegister{4, 2, 0x1C004143, 0x00C0003F, 0x000003FF, 0x00000000});
+    processor.AddLeaf(CpuIdRegister{0xB, 1, 4, 8, 0x201, cpunum});
+    processor.AddLeaf(CpuIdRegister{0x40000000, 0, 0x40000001, 0x4B4D564B, 0x564B4D56, 0x0000004D});
+    processor.AddLeaf(CpuIdRegister{0x8FFFFFFF, 0, 1, 2, 3, 4});
+    return processor;
+}
+
+auto GetTree() -> CpuIdTree
+{
+    CpuIdTree tree{};
+    for (unsigned int cpunum = 0; cpunum < 32; cpunum++) {
+        tree.SetProcessor(cpunum, GetProcessor(cpunum));
+    }
+
+    // A different CPU, and a gap in the CPU numbers.
+    CpuIdProcessor hybrid{};
+    hybrid.AddLeaf(CpuIdRegister{0, 0, 0x00000020, 0x756E6547, 0x6C65746E, 0x49656E69});
+    hybrid.AddLeaf(CpuIdRegister{0x1A, 0, 0x20000000, 0, 0, 0});
+    tree.SetProcessor(40, hybrid);
+    return tree;
+}
+
+void CheckSnapshot(const CpuIdSnapshot& snapshot, const CpuIdTree& tree)
+{
+    ASSERT_EQ(snapshot.Size(), tree.Size());
+    for (auto cpu = tree.cbegin(); cpu != tree.cend(); ++cpu) {
+        auto processor = snapshot.GetProcessor(cpu->first);
+        ASSERT_TRUE(processor);
+        ASSERT_EQ(processor.Cpu(), cpu->first);
+        ASSERT_EQ(processor.Size(), cpu->second.Size());
+        for (auto reg = cpu->second.cbegin(); reg != cpu->second.cend(); ++reg) {
+            auto leaf = processor.GetLeaf(reg->second.InEax(), reg->second.InEcx());
+            ASSERT_NE(leaf, nullptr);
+            EXPECT_EQ(leaf->Value(), reg->second.Value());
+        }
+        EXPECT_EQ(processor.ToProcessor(), cpu->second);
+    }
+}
+
+}
+
+TEST(CpuIdSnapshot, RoundTrip)
+{
+    CpuIdTree tree = GetTree();
+    std::vector<std::uint8_t> data = GetCpuIdSnapshot(tree);
+
+    auto snapshot = CpuIdSnapshot::Open(data.data(), data.size());
+    ASSERT_NE(snapshot, nullptr);
+    CheckSnapshot(*snapshot, tree);
+}
+
+TEST(CpuIdSnapshot, Missing)
+{
+    CpuIdTree tree = GetTree();
+    std::vector<std::uint8_t> data = GetCpuIdSnapshot(tree);
+    auto snapshot = CpuIdSnapshot::Open(data.data(), data.size());
+    ASSERT_NE(snapshot, nullptr);
+
+    ASSERT_FALSE(snapshot->GetProcessor(32));
+    ASSERT_FALSE(snapshot->GetProcessor(41));
+    ASSERT_EQ(snapshot->GetProcessor(32).GetLeaf(0, 0), nullptr);
+    ASSERT_TRUE(snapshot->GetProcessor(40));
+
+    auto processor = snapshot->GetProcessor(1);
+    ASSERT_TRUE(processor);
+    EXPECT_EQ(processor.GetLeaf(0x10, 0), nullptr);
+    EXPECT_EQ(processor.GetLeaf(4, 3), nullptr);
+    EXPECT_EQ(processor.GetLeaf(0x1A, 0), nullptr);
+    EXPECT_EQ(processor.GetLeaf(0x80000002, 0), nullptr);
+    EXPECT_EQ(processor.GetLeaf(0xFFFFFFFF, 0), nullptr);
+}
+
+TEST(CpuIdSnapshot, Empty)
+{
+    CpuIdTree tree{};
+    std::vector<std::uint8_t> data = GetCpuIdSnapshot(tree);
+    auto snapshot = CpuIdSnapshot::Open(data.data(), data.size());
+    ASSERT_NE(snapshot, nullptr);
+    ASSERT_EQ(snapshot->Size(), 0);
+    ASSERT_FALSE(snapshot->GetProcessor(0));
+}
+
+TEST(CpuIdSnapshot, Emit)
+{
+    CpuIdTree tree = GetTree();
+    std::vector<std::uint8_t> data = GetCpuIdSnapshot(tree);
+    auto snapshot = CpuIdSnapshot::Open(data.data(), data.size());
+    ASSERT_NE(snapshot, nullptr);
+
+    CpuIdTree result{};
+    CpuIdTreeSink sink{result};
+    snapshot->Emit(sink);
+
+    std::stringstream expected{};
+    WriteCpuIdXml(tree, expected);
+    std::stringstream xml{};
+    WriteCpuIdXml(result, xml);
+    ASSERT_EQ(xml.str(), expected.str());
+}
+
+TEST(CpuIdSnapshot, Disallowed)
+{
+    CpuIdTree tree = GetTree();
+    CpuIdProcessor disallowed{};
+    disallowed.SetDisallowed(true);
+    tree.SetProcessor(36, disallowed);
+    std::vector<std::uint8_t> data = GetCpuIdSnapshot(tree);
+
+    auto snapshot = CpuIdSnapshot::Open(data.data(), data.size());
+    ASSERT_NE(snapshot, nullptr);
+    CheckSnapshot(*snapshot, tree);
+    EXPECT_TRUE(snapshot->GetProcessor(36).IsDisallowed());
+    EXPECT_FALSE(snapshot->GetProcessor(35).IsDisallowed());
+    EXPECT_FALSE(snapshot->GetProcessor(40).IsDisallowed());
+
+    CpuIdTree result{};
+    CpuIdTreeSink sink{result};
+    snapshot->Emit(sink);
+    ASSERT_NE(result.GetProcessor(36), nullptr);
+    EXPECT_TRUE(result.GetProcessor(36)->IsDisallowed());
+}
+
+TEST(CpuIdSnapshot, SmallerThanXml)
+{
+    CpuIdTree tree = GetTree();
+    std::vector<std::uint8_t> data = GetCpuIdSnapshot(tree);
+    std::stringstream xml{};
+    WriteCpuIdXml(tree, xml);
+    ASSERT_LT(data.size() * 10, xml.str().size());
+}
+
+TEST(CpuIdSnapshot, Invalid)
+{
+    CpuIdTree tree = GetTree();
+    std::vector<std::uint8_t> data = GetCpuIdSnapshot(tree);
+
+    ASSERT_EQ(CpuIdSnapshot::Open(nullptr, 0), nullptr);
+    ASSERT_EQ(CpuIdSnapshot::Open(data.data(), sizeof(snapshot::SnapshotHeader) - 1), nullptr);
+    ASSERT_EQ(CpuIdSnapshot::Open(data.data(), data.size() - 8), nullptr);
+
+    std::vector<std::uint8_t> corrupt = data;
+    corrupt[0] = 'X';
+    ASSERT_EQ(CpuIdSnapshot::Open(corrupt.data(), corrupt.size()), nullptr);
+
+    corrupt = data;
+    snapshot::SnapshotHeader header{};
+    std::memcpy(&header, corrupt.data(), sizeof(header));
+    header.version++;
+    std::memcpy(corrupt.data(), &header, sizeof(header));
+    ASSERT_EQ(CpuIdSnapshot::Open(corrupt.data(), corrupt.size()), nullptr);
+
+    // A CPU that refers to registers outside of the snapshot.
+    corrupt = data;
+    snapshot::SnapshotCpu cpu{};
+    std::memcpy(&cpu, &corrupt[sizeof(header)], sizeof(cpu));
+    cpu.count = 0x10000;
+    std::memcpy(&corrupt[sizeof(header)], &cpu, sizeof(cpu));
+    ASSERT_EQ(CpuIdSnapshot::Open(corrupt.data(), corrupt.size()), nullptr);
+
+    // A disallowed CPU with registers, and unknown flags.
+    corrupt = data;
+    std::memcpy(&cpu, &corrupt[sizeof(header)], sizeof(cpu));
+    cpu.flags = snapshot::CpuDisallowed;
+    std::memcpy(&corrupt[sizeof(header)], &cpu, sizeof(cpu));
+    ASSERT_EQ(CpuIdSnapshot::Open(corrupt.data(), corrupt.size()), nullptr);
+    cpu.flags = 0x80000000;
+    std::memcpy(&corrupt[sizeof(header)], &cpu, sizeof(cpu));
+    ASSERT_EQ(CpuIdSnapshot::Open(corrupt.data(), corrupt.size()), nullptr);
+}
+
+TEST(CpuIdSnapshot, MaxCpu)
+{
+    CpuIdTree tree = GetTree();
+    std::vector<std::uint8_t> data = GetCpuIdSnapshot(tree);
+
+    // The last CPU can be renumbered without changing the order.
+    snapshot::SnapshotHeader header{};
+    std::memcpy(&header, data.data(), sizeof(header));
+    std::size_t offset = sizeof(header) + (header.cpus - 1) * sizeof(snapshot::SnapshotCpu);
+    snapshot::SnapshotCpu cpu{};
+    std::memcpy(&cpu, &data[offset], sizeof(cpu));
+
+    cpu.cpu = snapshot::MaxCpu;
+    std::memcpy(&data[offset], &cpu, sizeof(cpu));
+    auto snapshot = CpuIdSnapshot::Open(data.data(), data.size());
+    ASSERT_NE(snapshot, nullptr);
+    EXPECT_TRUE(snapshot->GetProcessor(snapshot::MaxCpu));
+
+    cpu.cpu = snapshot::MaxCpu + 1;
+    std::memcpy(&data[offset], &cpu, sizeof(cpu));
+    ASSERT_EQ(CpuIdSnapshot::Open(data.data(), data.size()), nullptr);
+
+    cpu.cpu = 0xFFFFFFFF;
+    std::memcpy(&data[offset], &cpu, sizeof(cpu));
+    ASSERT_EQ(CpuIdSnapshot::Open(data.data(), data.size()), nullptr);
+}
+
+TEST(CpuIdSnapshot, OpenFile)
+{
+    CpuIdTree tree = GetTree();
+    TempFile file{};
+    ASSERT_TRUE(file.Valid());
+    ASSERT_TRUE(WriteCpuIdSnapshot(tree, file.File()));
+
+    auto snapshot = CpuIdSnapshot::Open(file.Name());
+    ASSERT_NE(snapshot, nullptr);
+    CheckSnapshot(*snapshot, tree);
+}
+
+TEST(CpuIdSnapshot, OpenNonExistentFile)
+{
+    ASSERT_EQ(CpuIdSnapshot::Open(std::string{"/dev/nonexistant"}), nullptr);
+}
+
+}
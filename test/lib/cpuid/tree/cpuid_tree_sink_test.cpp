@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include "cpuid/tree/cpuid_tree_sink.h"
+#include "cpuid/tree/cpuid_tree.h"
+
+namespace rjcp::cpuid::tree {
+
+TEST(CpuIdTreeSink, Empty)
+{
+    CpuIdTree tree{};
+    CpuIdTreeSink sink{tree};
+    sink.Begin();
+    sink.End();
+    ASSERT_EQ(tree.Size(), 0);
+}
+
+TEST(CpuIdTreeSink, Registers)
+{
+    CpuIdTree tree{};
+    CpuIdTreeSink sink{tree};
+    sink.Begin();
+    sink.BeginProcessor(1);
+    sink.Register(CpuIdRegister{0, 0, 0x00000016, 0x756E6547, 0x6C65746E, 0x49656E69});
+    sink.Register(CpuIdRegister{1, 0, 0x000506E3, 0x00100800, 0x7FFAFBFF, 0xBFEBFBFF});
+    sink.EndProcessor(1);
+    sink.BeginProcessor(3);
+    sink.Register(CpuIdRegister{0, 0, 0x00000016, 0x756E6547, 0x6C65746E, 0x49656E69});
+    sink.EndProcessor(3);
+    sink.End();
+
+    ASSERT_EQ(tree.Size(), 2);
+    ASSERT_EQ(tree.GetProcessor(0), nullptr);
+    auto processor = tree.GetProcessor(1);
+    ASSERT_NE(processor, nullptr);
+    ASSERT_EQ(processor->Size(), 2);
+    auto reg = processor->GetLeaf(1, 0);
+    ASSERT_NE(reg, nullptr);
+    EXPECT_EQ(reg->Ebx(), 0x00100800);
+    processor = tree.GetProcessor(3);
+    ASSERT_NE(processor, nullptr);
+    ASSERT_EQ(processor->Size(), 1);
+}
+
+TEST(CpuIdTreeSink, Processor)
+{
+    CpuIdProcessor processor{};
+    processor.AddLeaf(CpuIdRegister{0, 0, 0x00000016, 0x756E6547, 0x6C65746E, 0x49656E69});
+
+    CpuIdTree tree{};
+    CpuIdTreeSink sink{tree};
+    sink.Begin();
+    sink.Processor(0, processor);
+    sink.End();
+
+    ASSERT_EQ(tree.Size(), 1);
+    auto result = tree.GetProcessor(0);
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(*result, processor);
+}
+
+}
@@ -2,6 +2,8 @@
 
 #include "cpuid/tree/cpuid_tree.h"
 
+#include <type_traits>
+
 namespace rjcp::cpuid::tree {
 
 TEST(CpuIdTree, DefaultConstructor)
@@ -150,6 +152,42 @@ TEST(CpuIdTree, Iterate)
     ASSERT_EQ(processor, tree.end());
 }
 
+TEST(CpuIdTree, IterateCpuIsConstant)
+{
+    // The CPU number is the index of the processor, so it can't be changed
+    // through an iterator. The processor can be.
+    static_assert(std::is_const_v<std::remove_reference_t<decltype(CpuIdTree::iterator{}->first)>>);
+    static_assert(!std::is_const_v<std::remove_reference_t<decltype(CpuIdTree::iterator{}->second)>>);
+    static_assert(std::is_const_v<std::remove_reference_t<decltype((*CpuIdTree::iterator{}).first)>>);
+
+    CpuIdTree tree{};
+    ASSERT_TRUE(tree.SetProcessor(3, CpuIdProcessor{}));
+    for (auto& [cpu, processor] : tree) {
+        ASSERT_EQ(cpu, 3);
+        ASSERT_TRUE(processor.AddLeaf(GetReg(0, 0)));
+    }
+    ASSERT_EQ(tree.GetProcessor(3)->Size(), 1);
+}
+
+TEST(CpuIdTree, CopyAssignment)
+{
+    CpuIdProcessor processor{};
+    ASSERT_TRUE(processor.AddLeaf(GetReg(0, 0)));
+
+    CpuIdTree tree{};
+    ASSERT_TRUE(tree.SetProcessor(1, processor));
+
+    CpuIdTree other{};
+    ASSERT_TRUE(other.SetProcessor(0, processor));
+    ASSERT_TRUE(other.SetProcessor(4, processor));
+    other = tree;
+    ASSERT_EQ(other.Size(), 1);
+    ASSERT_EQ(other.GetProcessor(0), nullptr);
+    ASSERT_NE(other.GetProcessor(1), nullptr);
+    ASSERT_EQ(other.GetProcessor(4), nullptr);
+    ASSERT_EQ(other.begin()->first, 1);
+}
+
 TEST(CpuIdTree, IterateConstant)
 {
     CpuIdTree tree{};
@@ -176,4 +214,124 @@ TEST(CpuIdTree, IterateConstant)
     ASSERT_EQ(processor, tree.cend());
 }
 
+TEST(CpuIdTree, SetProcessorExists)
+{
+    CpuIdTree tree{};
+    CpuIdProcessor processor{};
+    ASSERT_TRUE(processor.AddLeaf(GetReg(0, 0)));
+
+    ASSERT_TRUE(tree.SetProcessor(0, processor));
+    ASSERT_FALSE(tree.SetProcessor(0, CpuIdProcessor{}));
+    ASSERT_EQ(tree.Size(), 1);
+    ASSERT_EQ(tree.GetProcessor(0)->Size(), 1);
+}
+
+TEST(CpuIdTree, SetProcessorMaxCpu)
+{
+    CpuIdTree tree{};
+    ASSERT_FALSE(tree.SetProcessor(-1, CpuIdProcessor{}));
+    ASSERT_FALSE(tree.SetProcessor(CpuIdTree::MaxCpu + 1, CpuIdProcessor{}));
+    ASSERT_EQ(tree.Size(), 0);
+    ASSERT_EQ(tree.GetProcessor(CpuIdTree::MaxCpu + 1), nullptr);
+
+    ASSERT_TRUE(tree.SetProcessor(CpuIdTree::MaxCpu, CpuIdProcessor{}));
+    ASSERT_EQ(tree.Size(), 1);
+    ASSERT_NE(tree.GetProcessor(CpuIdTree::MaxCpu), nullptr);
+}
+
+TEST(CpuIdTree, IterateSparse)
+{
+    // CPUs that are missing (e.g. offline) are skipped.
+    CpuIdTree tree{};
+
+    CpuIdProcessor processor1{};
+    ASSERT_TRUE(processor1.AddLeaf(GetReg(0, 0)));
+
+    CpuIdProcessor processor3{};
+    ASSERT_TRUE(processor3.AddLeaf(GetReg(0, 0)));
+    ASSERT_TRUE(processor3.AddLeaf(GetReg(1, 0)));
+
+    ASSERT_TRUE(tree.SetProcessor(3, processor3));
+    ASSERT_TRUE(tree.SetProcessor(1, processor1));
+    ASSERT_EQ(tree.Size(), 2);
+    ASSERT_FALSE(tree.IsEmpty());
+
+    ASSERT_EQ(tree.GetProcessor(0), nullptr);
+    ASSERT_NE(tree.GetProcessor(1), nullptr);
+    ASSERT_EQ(tree.GetProcessor(2), nullptr);
+    ASSERT_NE(tree.GetProcessor(3), nullptr);
+    ASSERT_EQ(tree.GetProcessor(4), nullptr);
+
+    auto processor = tree.cbegin();
+    ASSERT_NE(processor, tree.cend());
+    ASSERT_EQ(processor->first, 1);
+    ASSERT_EQ(processor->second.Size(), 1);
+
+    processor++;
+    ASSERT_NE(processor, tree.cend());
+    ASSERT_EQ(processor->first, 3);
+    ASSERT_EQ(processor->second.Size(), 2);
+
+    processor++;
+    ASSERT_EQ(processor, tree.cend());
+}
+
+TEST(CpuIdTree, MoveConstructorEmpties)
+{
+    CpuIdTree tree{};
+    ASSERT_TRUE(tree.SetProcessor(2, CpuIdProcessor{}));
+
+    CpuIdTree move_tree{std::move(tree)};
+    ASSERT_EQ(move_tree.Size(), 1);
+    ASSERT_NE(move_tree.GetProcessor(2), nullptr);
+
+    // NOLINTNEXTLINE(bugprone-use-after-move)
+    ASSERT_TRUE(tree.IsEmpty());
+    ASSERT_EQ(tree.GetProcessor(2), nullptr);
+    ASSERT_EQ(tree.cbegin(), tree.cend());
+}
+
+TEST(CpuIdTree, Intern)
+{
+    CpuIdTree tree{};
+    for (unsigned int cpu = 0; cpu < 4; cpu++) {
+        CpuIdProcessor processor{};
+        for (std::uint32_t leaf = 0; leaf < 8; leaf++) {
+            ASSERT_TRUE(processor.AddLeaf(GetReg(leaf, 0)));
+        }
+        ASSERT_TRUE(processor.AddLeaf(CpuIdRegister{0x0B, 0, 0, 0, 0, cpu}));
+        ASSERT_TRUE(tree.SetProcessor(cpu, std::move(processor)));
+    }
+
+    // A processor with different leaves isn't shared.
+    CpuIdProcessor processor{};
+    ASSERT_TRUE(processor.AddLeaf(GetReg(0x80000000, 0)));
+    ASSERT_TRUE(tree.SetProcessor(5, std::move(processor)));
+
+    auto before = tree.Stats();
+    ASSERT_EQ(before.Leaves(), 37);
+    ASSERT_EQ(before.Stored(), 37);
+    ASSERT_DOUBLE_EQ(before.Ratio(), 1.0);
+
+    auto stats = tree.Intern();
+    ASSERT_EQ(stats.Leaves(), 37);
+    ASSERT_EQ(stats.Stored(), 9 + 3 + 1);
+    ASSERT_GT(stats.Ratio(), 2.0);
+
+    for (unsigned int cpu = 0; cpu < 4; cpu++) {
+        ASSERT_EQ(tree.GetProcessor(cpu)->GetLeaf(0x0B, 0)->Edx(), cpu);
+        ASSERT_EQ(tree.GetProcessor(cpu)->GetLeaf(0x07, 0)->InEax(), 7);
+    }
+    ASSERT_EQ(tree.GetProcessor(5)->Size(), 1);
+}
+
+TEST(CpuIdTree, StatsEmpty)
+{
+    CpuIdTree tree{};
+    auto stats = tree.Intern();
+    ASSERT_EQ(stats.Leaves(), 0);
+    ASSERT_EQ(stats.Stored(), 0);
+    ASSERT_DOUBLE_EQ(stats.Ratio(), 1.0);
+}
+
 }
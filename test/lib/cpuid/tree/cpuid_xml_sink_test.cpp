@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+
+#include "cpuid/tree/cpuid_xml_sink.h"
+#include "cpuid/tree/cpuid_write_xml.h"
+#include "os/qnx/native/file/file.h"
+#include "test_helper.h"
+
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace rjcp::cpuid::tree {
+
+TEST(CpuIdXmlSink, Empty)
+{
+    std::stringstream genxml{};
+    CpuIdXmlSink sink{genxml};
+    sink.Begin();
+    sink.End();
+
+    std::stringstream expected{};
+    expected << R"(<?xml version="1.0" encoding="utf-8"?>)" << std::endl;
+    expected << R"(<cpuid type="x86">)" << std::endl;
+    expected << "</cpuid>" << std::endl;
+    ASSERT_EQ(genxml.str(), expected.str());
+}
+
+TEST(CpuIdXmlSink, TwoProcessors)
+{
+    std::stringstream genxml{};
+    CpuIdXmlSink sink{genxml};
+    sink.Begin();
+    sink.BeginProcessor(0);
+    sink.Register(CpuIdRegister{0, 0, 0x00000016, 0x756E6547, 0x6C65746E, 0x49656E69});
+    sink.EndProcessor(0);
+
+    CpuIdProcessor processor{};
+    processor.AddLeaf(CpuIdRegister{0x80000000, 0, 0x80000008, 0, 0, 0});
+    sink.Processor(1, processor);
+    sink.End();
+
+    std::stringstream expected{};
+    expected << R"(<?xml version="1.0" encoding="utf-8"?>)" << std::endl;
+    expected << R"(<cpuid type="x86">)" << std::endl;
+    expected << "  <processor>" << std::endl;
+    expected << "    " R"(<register eax="00000000" ecx="00000000">00000016,756E6547,6C65746E,49656E69</register>)" << std::endl;
+    expected << "  </processor>" << std::endl;
+    expected << "  <processor>" << std::endl;
+    expected << "    " R"(<register eax="80000000" ecx="00000000">80000008,00000000,00000000,00000000</register>)" << std::endl;
+    expected << "  </processor>" << std::endl;
+    expected << "</cpuid>" << std::endl;
+    ASSERT_EQ(genxml.str(), expected.str());
+}
+
+namespace {
+
+auto GetLargeTree() -> CpuIdTree
+{
+    // Enough registers that the output is larger than the buffer.
+    CpuIdTree tree{};
+    for (unsigned int cpunum = 0; cpunum < 16; cpunum++) {
+        CpuIdProcessor processor{};
+        for (unsigned int leaf = 0; leaf < 100; leaf++) {
+            processor.AddLeaf(CpuIdRegister{leaf, 0, 0xDEADBEEF, cpunum << 24, leaf, 0x0123ABCD});
+        }
+        tree.SetProcessor(cpunum, std::move(processor));
+    }
+    return tree;
+}
+
+auto GetExpectedXml(CpuIdTree& tree) -> std::string
+{
+    std::stringstream expected{};
+    expected << std::hex << std::uppercase << std::setfill('0');
+    expected << R"(<?xml version="1.0" encoding="utf-8"?>)" << std::endl;
+    expected << R"(<cpuid type="x86">)" << std::endl;
+    for (auto& [cpunum, processor] : tree) {
+        expected << "  <processor>" << std::endl;
+        for (const auto& [key, reg] : processor) {
+            expected << "    <register eax=\"" << std::setw(8) << reg.InEax() << "\" ecx=\"" << std::setw(8) << reg.InEcx() << "\">";
+            expected << std::setw(8) << reg.Eax() << "," << std::setw(8) << reg.Ebx() << ",";
+            expected << std::setw(8) << reg.Ecx() << "," << std::setw(8) << reg.Edx() << "</register>" << std::endl;
+        }
+        expected << "  </processor>" << std::endl;
+    }
+    expected << "</cpuid>" << std::endl;
+    return expected.str();
+}
+
+}
+
+TEST(CpuIdXmlSink, LargeStream)
+{
+    CpuIdTree tree = GetLargeTree();
+    std::stringstream genxml{};
+    WriteCpuIdXml(tree, genxml);
+    ASSERT_GT(genxml.str().size(), 65536);
+    ASSERT_EQ(genxml.str(), GetExpectedXml(tree));
+}
+
+TEST(CpuIdXmlSink, LargeFile)
+{
+    TempFile temp{};
+    ASSERT_TRUE(temp.Valid());
+    const os::qnx::native::file::FileHandle& file = temp.File();
+
+    CpuIdTree tree = GetLargeTree();
+    ASSERT_TRUE(WriteCpuIdXml(tree, file));
+
+    std::string expected = GetExpectedXml(tree);
+    std::vector<std::uint8_t> buffer(expected.size() + 1);
+    std::size_t length = 0;
+    while (length < buffer.size()) {
+        auto bytes = os::qnx::native::file::pread(file, buffer, length, buffer.size() - length, length);
+        ASSERT_TRUE(bytes);
+        if (*bytes == 0) break;
+        length += *bytes;
+    }
+    ASSERT_EQ(std::string(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(length)), expected);
+}
+
+TEST(CpuIdXmlSink, FileError)
+{
+    auto file = os::qnx::native::file::open("/dev/null");
+    ASSERT_TRUE(file && *file);
+
+    CpuIdTree tree = GetLargeTree();
+    ASSERT_FALSE(WriteCpuIdXml(tree, *file));
+}
+
+TEST(CpuIdXmlSink, WriteEachProcessor)
+{
+    // Each processor is written when it ends, before the next is received.
+    std::stringstream genxml{};
+    CpuIdXmlSink sink{genxml};
+    sink.Begin();
+    sink.BeginProcessor(0);
+    sink.Register(CpuIdRegister{0, 0, 0x00000016, 0x756E6547, 0x6C65746E, 0x49656E69});
+    ASSERT_EQ(genxml.str().size(), 0);
+    sink.EndProcessor(0);
+
+    std::string first = genxml.str();
+    ASSERT_NE(first.find("</processor>"), std::string::npos);
+
+    sink.BeginProcessor(1);
+    sink.Register(CpuIdRegister{0, 0, 0x00000016, 0x756E6547, 0x6C65746E, 0x49656E69});
+    ASSERT_EQ(genxml.str(), first);
+    sink.EndProcessor(1);
+    ASSERT_GT(genxml.str().size(), first.size());
+    sink.End();
+}
+
+TEST(CpuIdXmlSink, FlushOnDestroy)
+{
+    std::stringstream genxml{};
+    {
+        CpuIdXmlSink sink{genxml};
+        sink.Begin();
+        ASSERT_EQ(genxml.str().size(), 0);
+    }
+    ASSERT_EQ(genxml.str(), "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<cpuid type=\"x86\">\n");
+}
+
+}
@@ -2,6 +2,10 @@
 
 #include "os/qnx/native/file/file.h"
 
+#include <fcntl.h>
+
+#include <array>
+#include <climits>
 #include <iostream>
 #include <vector>
 
@@ -134,6 +138,116 @@ TEST(File, ReadRandomBufferInvalidHandle)
     ASSERT_EQ(bytes.error(), EINVAL);
 }
 
+TEST(File, ReadRandomArrayConstrained)
+{
+    auto h = open("/dev/random");
+    ASSERT_TRUE(h && *h);
+
+    std::array<uint8_t, 8> buffer{};
+    auto bytes = read(*h, buffer, 256);
+    ASSERT_TRUE(bytes);
+    ASSERT_EQ(*bytes, 8);
+}
+
+TEST(File, ReadRandomArrayInvalidHandle)
+{
+    FileHandle h{};
+    ASSERT_FALSE(h);
+
+    std::array<uint8_t, 8> buffer{};
+    auto bytes = read(h, buffer, 8);
+    ASSERT_FALSE(bytes);
+    ASSERT_EQ(bytes.error(), EINVAL);
+}
+
+TEST(File, WriteNull)
+{
+    auto h = open("/dev/null", O_WRONLY);
+    ASSERT_TRUE(h && *h);
+
+    std::vector<uint8_t> buffer(256);
+    auto bytes = write(*h, &buffer[0], 256);
+    ASSERT_TRUE(bytes);
+    ASSERT_EQ(*bytes, 256);
+}
+
+TEST(File, WriteInvalidHandle)
+{
+    FileHandle h{};
+    ASSERT_FALSE(h);
+
+    std::vector<uint8_t> buffer(256);
+    auto bytes = write(h, &buffer[0], 8);
+    ASSERT_FALSE(bytes);
+    ASSERT_EQ(bytes.error(), EINVAL);
+}
+
+TEST(File, WriteReadOnly)
+{
+    auto h = open("/dev/null");
+    ASSERT_TRUE(h && *h);
+
+    std::vector<uint8_t> buffer(256);
+    auto bytes = write(*h, &buffer[0], 8);
+    ASSERT_FALSE(bytes);
+    ASSERT_EQ(bytes.error(), EBADF);
+}
+
+TEST(File, WriteAllNull)
+{
+    auto h = open("/dev/null", O_WRONLY);
+    ASSERT_TRUE(h && *h);
+
+    std::vector<uint8_t> buffer(65536);
+    auto bytes = write_all(*h, &buffer[0], buffer.size());
+    ASSERT_TRUE(bytes);
+    ASSERT_EQ(*bytes, buffer.size());
+}
+
+TEST(File, WriteAllReadOnly)
+{
+    auto h = open("/dev/null");
+    ASSERT_TRUE(h && *h);
+
+    std::vector<uint8_t> buffer(256);
+    auto bytes = write_all(*h, &buffer[0], 8);
+    ASSERT_FALSE(bytes);
+    ASSERT_EQ(bytes.error(), EBADF);
+}
+
+TEST(File, ReadAllRandom)
+{
+    auto h = open("/dev/urandom");
+    ASSERT_TRUE(h && *h);
+
+    std::vector<uint8_t> buffer(65536);
+    auto bytes = read_all(*h, &buffer[0], buffer.size());
+    ASSERT_TRUE(bytes);
+    ASSERT_EQ(*bytes, buffer.size());
+}
+
+TEST(File, ReadAllEndOfFile)
+{
+    auto h = open("/dev/null");
+    ASSERT_TRUE(h && *h);
+
+    std::vector<uint8_t> buffer(256);
+    auto bytes = read_all(*h, &buffer[0], buffer.size());
+    ASSERT_TRUE(bytes);
+    ASSERT_EQ(*bytes, 0);
+}
+
+TEST(File, ReadAllInvalidHandle)
+{
+    FileHandle h{};
+    ASSERT_FALSE(h);
+
+    std::vector<uint8_t> buffer(256);
+    auto bytes = read_all(h, &buffer[0], 8);
+    ASSERT_FALSE(bytes);
+    ASSERT_EQ(bytes.error(), EINVAL);
+}
+
 TEST(File, SeekInvalidHandle)
 {
     FileHandle h{};
@@ -260,6 +374,19 @@ TEST(File, PreadBufferCpuIdDevice)
     ASSERT_EQ(*bytes, 16);
 }
 
+TEST(File, PreadArrayCpuIdDevice)
+{
+    // For this test to pass, you must have the driver running, e.g. on Linux
+    // `modins cpuid`
+    auto h = open("/dev/cpu/0/cpuid");
+    ASSERT_TRUE(h && *h) << "Ensure that the cpuid driver is loaded and has readable permissions - " << strerror(h.error());
+
+    std::array<uint8_t, 16> buffer{};
+    auto bytes = pread(*h, buffer, 32, 0);
+    ASSERT_TRUE(bytes);
+    ASSERT_EQ(*bytes, 16);
+}
+
 TEST(File, Pread64InvalidHandle)
 {
     FileHandle h{};
@@ -332,4 +459,113 @@ TEST(File, Pread64BufferCpuIdDevice)
     ASSERT_EQ(*bytes, 16);
 }
 
+TEST(File, Pread64ArrayInvalidHandle)
+{
+    FileHandle h{};
+    ASSERT_FALSE(h);
+
+    std::array<uint8_t, 16> buffer{};
+    auto bytes = pread64(h, buffer, buffer.size(), 0);
+    ASSERT_FALSE(bytes);
+    ASSERT_EQ(bytes.error(), EINVAL);
+}
+
+TEST(File, Pread64ArrayCpuIdDevice)
+{
+    // For this test to pass, you must have the driver running, e.g. on Linux
+    // `modins cpuid`
+    auto h = open("/dev/cpu/0/cpuid");
+    ASSERT_TRUE(h && *h) << "Ensure that the cpuid driver is loaded and has readable permissions - " << strerror(h.error());
+
+    std::array<uint8_t, 16> buffer{};
+    auto bytes = pread64(*h, buffer, 32, 0);
+    ASSERT_TRUE(bytes);
+    ASSERT_EQ(*bytes, 16);
+}
+
+TEST(File, ReadvInvalidHandle)
+{
+    FileHandle h{};
+    ASSERT_FALSE(h);
+
+    std::array<uint8_t, 16> buffer{};
+    std::array<struct iovec, 1> iov{{{buffer.data(), buffer.size()}}};
+    auto bytes = readv(h, iov.data(), iov.size());
+    ASSERT_FALSE(bytes);
+    ASSERT_EQ(bytes.error(), EINVAL);
+}
+
+TEST(File, ReadvCpuIdDevice)
+{
+    // For this test to pass, you must have the driver running, e.g. on Linux
+    // `modins cpuid`
+    auto h = open("/dev/cpu/0/cpuid");
+    ASSERT_TRUE(h && *h) << "Ensure that the cpuid driver is loaded and has readable permissions - " << strerror(h.error());
+
+    std::array<std::array<uint8_t, 16>, 2> buffers{};
+    std::array<struct iovec, 2> iov{{{buffers[0].data(), 16}, {buffers[1].data(), 16}}};
+    ASSERT_TRUE(lseek64(*h, 0));
+    auto bytes = readv(*h, iov.data(), iov.size());
+    ASSERT_TRUE(bytes);
+    ASSERT_EQ(*bytes, 32);
+}
+
+TEST(File, PreadvInvalidHandle)
+{
+    FileHandle h{};
+    ASSERT_FALSE(h);
+
+    std::array<uint8_t, 16> buffer{};
+    std::array<struct iovec, 1> iov{{{buffer.data(), buffer.size()}}};
+    auto bytes = preadv(h, iov.data(), iov.size(), 0);
+    ASSERT_FALSE(bytes);
+    ASSERT_EQ(bytes.error(), EINVAL);
+}
+
+TEST(File, PreadvTooManyBuffers)
+{
+    auto h = open("/dev/random");
+    ASSERT_TRUE(h && *h);
+
+    std::array<uint8_t, 16> buffer{};
+    std::array<struct iovec, 1> iov{{{buffer.data(), buffer.size()}}};
+    auto bytes = preadv(*h, iov.data(), static_cast<std::size_t>(IOV_MAX) + 1, 0);
+    ASSERT_FALSE(bytes);
+    ASSERT_EQ(bytes.error(), EINVAL);
+}
+
+TEST(File, PreadvCpuIdDevice)
+{
+    // For this test to pass, you must have the driver running, e.g. on Linux
+    // `modins cpuid`
+    auto h = open("/dev/cpu/0/cpuid");
+    ASSERT_TRUE(h && *h) << "Ensure that the cpuid driver is loaded and has readable permissions - " << strerror(h.error());
+
+    // Each buffer is filled in turn, each with the next leaf.
+    std::array<std::array<uint8_t, 16>, 2> buffers{};
+    std::array<struct iovec, 2> iov{{{buffers[0].data(), 16}, {buffers[1].data(), 16}}};
+    auto bytes = preadv(*h, iov.data(), iov.size(), 0);
+    ASSERT_TRUE(bytes);
+    ASSERT_EQ(*bytes, 32);
+
+    std::array<uint8_t, 16> leaf1{};
+    ASSERT_TRUE(pread64(*h, leaf1, leaf1.size(), 1));
+    EXPECT_EQ(buffers[1], leaf1);
+}
+
+TEST(File, Preadv2CpuIdDevice)
+{
+    // For this test to pass, you must have the driver running, e.g. on Linux
+    // `modins cpuid`
+    auto h = open("/dev/cpu/0/cpuid");
+    ASSERT_TRUE(h && *h) << "Ensure that the cpuid driver is loaded and has readable permissions - " << strerror(h.error());
+
+    std::array<uint8_t, 16> buffer{};
+    std::array<struct iovec, 1> iov{{{buffer.data(), buffer.size()}}};
+    auto bytes = preadv2(*h, iov.data(), iov.size(), 0, 0);
+    if (!bytes && bytes.error() == ENOSYS) GTEST_SKIP() << "preadv2 not supported";
+    ASSERT_TRUE(bytes);
+    ASSERT_EQ(*bytes, 16);
+}
+
 }
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include "os/qnx/native/file/mapped_file.h"
+#include "test_helper.h"
+
+#include <cstring>
+#include <string>
+#include <utility>
+
+namespace rjcp::os::qnx::native::file {
+
+TEST(MappedFile, Empty)
+{
+    MappedFile map{};
+    ASSERT_EQ(map.Data(), nullptr);
+    ASSERT_EQ(map.Size(), 0);
+}
+
+TEST(MappedFile, MapFile)
+{
+    TempFile file{"0123456789"};
+    ASSERT_TRUE(file.Valid());
+
+    auto map = file::map(file.Name());
+    ASSERT_TRUE(map);
+    ASSERT_NE(map->Data(), nullptr);
+    ASSERT_EQ(map->Size(), 10);
+    ASSERT_EQ(std::memcmp(map->Data(), "0123456789", 10), 0);
+}
+
+TEST(MappedFile, MapEmptyFile)
+{
+    TempFile file{""};
+    ASSERT_TRUE(file.Valid());
+
+    auto map = file::map(file.Name());
+    ASSERT_TRUE(map);
+    ASSERT_EQ(map->Data(), nullptr);
+    ASSERT_EQ(map->Size(), 0);
+}
+
+TEST(MappedFile, MapHandleClosed)
+{
+    TempFile file{"data"};
+    ASSERT_TRUE(file.Valid());
+
+    auto fd = open(file.Name());
+    ASSERT_TRUE(fd && *fd);
+    auto map = file::map(*fd);
+    ASSERT_TRUE(map);
+    fd->Reset();
+    ASSERT_EQ(map->Size(), 4);
+    ASSERT_EQ(std::memcmp(map->Data(), "data", 4), 0);
+}
+
+TEST(MappedFile, Move)
+{
+    TempFile file{"data"};
+    ASSERT_TRUE(file.Valid());
+
+    auto map = file::map(file.Name());
+    ASSERT_TRUE(map);
+    MappedFile moved{std::move(*map)};
+    ASSERT_EQ(map->Data(), nullptr);    // NOLINT(bugprone-use-after-move)
+    ASSERT_EQ(moved.Size(), 4);
+
+    MappedFile assigned{};
+    assigned = std::move(moved);
+    ASSERT_EQ(moved.Data(), nullptr);   // NOLINT(bugprone-use-after-move)
+    ASSERT_EQ(assigned.Size(), 4);
+    ASSERT_EQ(std::memcmp(assigned.Data(), "data", 4), 0);
+}
+
+TEST(MappedFile, MapInvalidHandle)
+{
+    FileHandle fd{};
+    auto map = file::map(fd);
+    ASSERT_FALSE(map);
+    ASSERT_EQ(map.error(), EINVAL);
+}
+
+TEST(MappedFile, MapNonExistentFile)
+{
+    auto map = file::map(std::string{"/dev/nonexistant"});
+    ASSERT_FALSE(map);
+    ASSERT_EQ(map.error(), ENOENT);
+}
+
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include "os/qnx/native/file/uring.h"
+
+#include <array>
+#include <cstring>
+
+namespace rjcp::os::qnx::native::file {
+
+namespace {
+
+auto GetRing(unsigned int entries) -> expected<Uring>
+{
+    auto ring = uring(entries);
+    if (!ring && (ring.error() == ENOSYS || ring.error() == EPERM || ring.error() == EOPNOTSUPP)) {
+        // The OS, or a seccomp filter, doesn't allow io_uring, or it can't read.
+        return ring;
+    }
+    EXPECT_TRUE(ring) << "io_uring setup failed - " << strerror(ring.error());
+    return ring;
+}
+
+}
+
+TEST(Uring, Empty)
+{
+    Uring ring{};
+    EXPECT_FALSE(ring);
+
+    std::array<ReadRequest, 1> requests{};
+    auto result = ring.pread(requests.data(), 0);
+    ASSERT_FALSE(result);
+}
+
+TEST(Uring, InvalidEntries)
+{
+    auto ring = uring(0);
+    ASSERT_FALSE(ring);
+}
+
+TEST(Uring, PreadCpuIdDevice)
+{
+    auto ring = GetRing(2);
+    if (!ring) GTEST_SKIP() << "io_uring not available";
+    ASSERT_TRUE(*ring);
+
+    // For this test to pass, you must have the driver running, e.g. on Linux
+    // `modins cpuid`
+    auto h = open("/dev/cpu/0/cpuid");
+    ASSERT_TRUE(h && *h) << "Ensure that the cpuid driver is loaded and has readable permissions - " << strerror(h.error());
+
+    // There are more requests than entries in the ring, so they're submitted
+    // in more than one batch.
+    std::array<std::array<std::uint8_t, 16>, 5> buffers{};
+    std::array<ReadRequest, 5> requests{};
+    for (std::size_t i = 0; i < requests.size(); i++) {
+        requests.at(i) = ReadRequest{&h.value(), buffers.at(i).data(), 16, i, 0};
+    }
+    auto result = ring->pread(requests.data(), requests.size());
+    ASSERT_TRUE(result);
+
+    for (std::size_t i = 0; i < requests.size(); i++) {
+        std::array<std::uint8_t, 16> expected{};
+        auto bytes = pread64(*h, expected, expected.size(), i);
+        ASSERT_TRUE(bytes);
+
+        ASSERT_TRUE(requests.at(i).result);
+        EXPECT_EQ(*requests.at(i).result, 16);
+        EXPECT_EQ(buffers.at(i), expected);
+    }
+}
+
+TEST(Uring, PreadInvalidHandle)
+{
+    auto ring = GetRing(4);
+    if (!ring) GTEST_SKIP() << "io_uring not available";
+
+    FileHandle h{};
+    std::array<std::uint8_t, 16> buffer{};
+    std::array<ReadRequest, 1> requests{{{&h, buffer.data(), buffer.size(), 0, 0}}};
+    auto result = ring->pread(requests.data(), requests.size());
+    ASSERT_TRUE(result);
+
+    // The ring is fine, but the read failed.
+    ASSERT_FALSE(requests[0].result);
+    EXPECT_EQ(requests[0].result.error(), EBADF);
+}
+
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include "os/qnx/native/sched/sched.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace rjcp::os::qnx::native::sched {
+
+// Affinity is set on a new thread, so that the thread running the tests is not
+// pinned to a single CPU.
+
+TEST(Sched, SetAffinityCpu0)
+{
+    expected<void> result{};
+    std::thread thread{[&result]() { result = set_affinity(0); }};
+    thread.join();
+    ASSERT_TRUE(result);
+}
+
+TEST(Sched, SetAffinityInvalidCpu)
+{
+    expected<void> result{};
+    std::thread thread{[&result]() { result = set_affinity(1000000); }};
+    thread.join();
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(), EINVAL);
+}
+
+TEST(Sched, SetAffinityBeyondCpuSet)
+{
+    // The set is allocated for the CPU, which doesn't exist.
+    expected<void> result{};
+    unsigned int cpu = get_cpuset_cpus() + 1000;
+    std::thread thread{[&result, cpu]() { result = set_affinity(cpu); }};
+    thread.join();
+    ASSERT_FALSE(result);
+}
+
+TEST(Sched, GetCpuSetCpus)
+{
+    auto cpus = get_affinity();
+    ASSERT_TRUE(cpus);
+    EXPECT_GT(get_cpuset_cpus(), cpus->back());
+}
+
+TEST(Sched, GetAffinity)
+{
+    auto cpus = get_affinity();
+    ASSERT_TRUE(cpus);
+    ASSERT_FALSE(cpus->empty());
+    EXPECT_TRUE(std::is_sorted(cpus->begin(), cpus->end()));
+
+    // Pinning to an allowed CPU restricts the affinity to that CPU.
+    unsigned int last = cpus->back();
+    expected<std::vector<unsigned int>> pinned{};
+    std::thread thread{[&pinned, last]() {
+        if (set_affinity(last)) pinned = get_affinity();
+    }};
+    thread.join();
+    ASSERT_TRUE(pinned);
+    EXPECT_EQ(*pinned, std::vector<unsigned int>{last});
+}
+
+TEST(Sched, GetCpu)
+{
+    auto cpus = get_affinity();
+    ASSERT_TRUE(cpus);
+
+    // A thread pinned to a CPU runs on that CPU.
+    unsigned int last = cpus->back();
+    expected<unsigned int> cpu{};
+    std::thread thread{[&cpu, last]() {
+        if (set_affinity(last)) cpu = get_cpu();
+    }};
+    thread.join();
+    if (!cpu && cpu.error() == ENOSYS) GTEST_SKIP() << "Current CPU not supported";
+    ASSERT_TRUE(cpu);
+    EXPECT_EQ(*cpu, last);
+}
+
+TEST(Sched, GetOnline)
+{
+    auto cpus = get_online();
+    ASSERT_TRUE(cpus);
+    ASSERT_FALSE(cpus->empty());
+    EXPECT_TRUE(std::is_sorted(cpus->begin(), cpus->end()));
+
+    // Every CPU that the thread may run on is online.
+    auto affinity = get_affinity();
+    ASSERT_TRUE(affinity);
+    EXPECT_TRUE(std::includes(cpus->begin(), cpus->end(), affinity->begin(), affinity->end()));
+}
+
+TEST(Sched, ParseCpuList)
+{
+    auto cpus = parse_cpu_list("0-3,8,10-11\n");
+    ASSERT_TRUE(cpus);
+    EXPECT_EQ(*cpus, (std::vector<unsigned int>{0, 1, 2, 3, 8, 10, 11}));
+}
+
+TEST(Sched, ParseCpuListSingle)
+{
+    auto cpus = parse_cpu_list("0");
+    ASSERT_TRUE(cpus);
+    EXPECT_EQ(*cpus, std::vector<unsigned int>{0});
+}
+
+TEST(Sched, ParseCpuListUnsorted)
+{
+    auto cpus = parse_cpu_list("4-5,0,4");
+    ASSERT_TRUE(cpus);
+    EXPECT_EQ(*cpus, (std::vector<unsigned int>{0, 4, 5}));
+}
+
+TEST(Sched, ParseCpuListEmpty)
+{
+    auto cpus = parse_cpu_list("\n");
+    ASSERT_TRUE(cpus);
+    EXPECT_TRUE(cpus->empty());
+}
+
+TEST(Sched, ParseCpuListInvalid)
+{
+    for (const char* list : {"a", "1-", "-1", "3-1", "1,", "1,,2", "1 2", "100000"}) {
+        auto cpus = parse_cpu_list(list);
+        ASSERT_FALSE(cpus) << list;
+        EXPECT_EQ(cpus.error(), EINVAL);
+    }
+}
+
+}
@@ -0,0 +1,62 @@
+#include "test_helper.h"
+#include "cpuid/tree/cpuid_write_xml.h"
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <sstream>
+
+namespace rjcp {
+
+TempFile::TempFile()
+    : m_file{mkstemp(&m_name[0])}
+{
+    m_valid = static_cast<bool>(m_file);
+}
+
+TempFile::TempFile(const std::string& content)
+    : TempFile()
+{
+    if (!m_valid || content.empty()) return;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto bytes = os::qnx::native::file::write(m_file, reinterpret_cast<const std::uint8_t*>(content.data()), content.size());
+    m_valid = bytes && *bytes == content.size();
+}
+
+TempFile::~TempFile()
+{
+    if (m_file) unlink(m_name.c_str());
+}
+
+}
+
+namespace rjcp::cpuid {
+
+auto GetTestProcessor(unsigned int cpunum, std::uint32_t family) -> tree::CpuIdProcessor
+{
+    tree::CpuIdProcessor cpu{};
+    cpu.AddLeaf(CpuIdRegister{0x00000000, 0x00000000, 0x00000001, 0x756E6547, 0x6C65746E, 0x49656E69});
+    cpu.AddLeaf(CpuIdRegister{0x00000001, 0x00000000, family, 0x00100800 | (cpunum << 24), 0x7FFAFBFF, 0xBFEBFBFF});
+    cpu.AddLeaf(CpuIdRegister{0x80000000, 0x00000000, 0x80000001, 0x00000000, 0x00000000, 0x00000000});
+    cpu.AddLeaf(CpuIdRegister{0x80000001, 0x00000000, 0x00000000, 0x00000000, 0x00000121, 0x2C100800});
+    return cpu;
+}
+
+auto GetTestTree(unsigned int cpus, std::uint32_t family) -> tree::CpuIdTree
+{
+    tree::CpuIdTree tree{};
+    for (unsigned int cpunum = 0; cpunum < cpus; cpunum++) {
+        tree.SetProcessor(cpunum, GetTestProcessor(cpunum, family));
+    }
+    return tree;
+}
+
+auto GetXml(const tree::CpuIdTree& tree) -> std::string
+{
+    std::stringstream xml{};
+    tree::WriteCpuIdXml(tree, xml);
+    return xml.str();
+}
+
+}
@@ -0,0 +1,103 @@
+#ifndef RJCP_TEST_TEST_HELPER_H
+#define RJCP_TEST_TEST_HELPER_H
+
+#include "cpuid/tree/cpuid_processor.h"
+#include "cpuid/tree/cpuid_tree.h"
+#include "os/qnx/native/file/file.h"
+
+#include <cstdint>
+#include <string>
+
+namespace rjcp {
+
+/**
+ * @brief A temporary file, deleted when out of scope.
+ *
+ * The file is created when constructed, and stays open until deleted, so it
+ * can be written and read by its handle or opened again by its name.
+ */
+class TempFile
+{
+public:
+    /**
+     * @brief Create an empty temporary file.
+     *
+     */
+    TempFile();
+
+    /**
+     * @brief Create a temporary file with the given contents.
+     *
+     * @param content The contents of the file.
+     */
+    TempFile(const std::string& content);
+
+    TempFile(const TempFile&) = delete;
+    auto operator=(const TempFile&) -> TempFile& = delete;
+    TempFile(TempFile&&) = delete;
+    auto operator=(TempFile&&) -> TempFile& = delete;
+    ~TempFile();
+
+    /**
+     * @brief The name of the file.
+     *
+     * @return const std::string& The name of the file.
+     */
+    auto Name() const -> const std::string& { return m_name; }
+
+    /**
+     * @brief The handle to the open file.
+     *
+     * @return const os::qnx::native::file::FileHandle& The handle to the file.
+     */
+    auto File() const -> const os::qnx::native::file::FileHandle& { return m_file; }
+
+    /**
+     * @brief If the file was created with its contents.
+     *
+     * @return true The file was created.
+     * @return false The file couldn't be created or written.
+     */
+    auto Valid() const -> bool { return m_valid; }
+
+private:
+    std::string m_name{"/tmp/devc_cpuid_XXXXXX"};
+    os::qnx::native::file::FileHandle m_file{};
+    bool m_valid{};
+};
+
+}
+
+namespace rjcp::cpuid {
+
+/**
+ * @brief Get the leaves of a small GenuineIntel processor, with standard and
+ * extended leaves.
+ *
+ * @param cpunum The CPU number, which is in the APIC identifier of leaf 1.
+ * @param family The signature in EAX of leaf 1.
+ * @return tree::CpuIdProcessor The processor.
+ */
+auto GetTestProcessor(unsigned int cpunum, std::uint32_t family = 0x000506E3) -> tree::CpuIdProcessor;
+
+/**
+ * @brief Get a tree of identical GenuineIntel processors from
+ * GetTestProcessor().
+ *
+ * @param cpus The number of CPUs, numbered from zero.
+ * @param family The signature in EAX of leaf 1.
+ * @return tree::CpuIdTree The tree.
+ */
+auto GetTestTree(unsigned int cpus = 4, std::uint32_t family = 0x000506E3) -> tree::CpuIdTree;
+
+/**
+ * @brief Get the XML of a tree, to compare trees by their output.
+ *
+ * @param tree The tree to write.
+ * @return std::string The XML written by WriteCpuIdXml().
+ */
+auto GetXml(const tree::CpuIdTree& tree) -> std::string;
+
+}
+
+#endif